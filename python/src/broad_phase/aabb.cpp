@@ -78,7 +78,8 @@ void define_aabb(py::module_& m)
 
     m.def(
         "build_vertex_boxes",
-        [](const Eigen::MatrixXd& vertices, const double inflation_radius = 0) {
+        [](ConstRef<Eigen::MatrixXd> vertices,
+           const double inflation_radius = 0) {
             std::vector<AABB> vertex_boxes;
             build_vertex_boxes(vertices, vertex_boxes, inflation_radius);
             return vertex_boxes;
@@ -97,8 +98,8 @@ void define_aabb(py::module_& m)
 
     m.def(
         "build_vertex_boxes",
-        [](const Eigen::MatrixXd& vertices_t0,
-           const Eigen::MatrixXd& vertices_t1,
+        [](ConstRef<Eigen::MatrixXd> vertices_t0,
+           ConstRef<Eigen::MatrixXd> vertices_t1,
            const double inflation_radius = 0) {
             std::vector<AABB> vertex_boxes;
             build_vertex_boxes(
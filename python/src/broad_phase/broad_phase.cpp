@@ -43,8 +43,9 @@ void define_broad_phase(py::module_& m)
         .def(
             "build",
             py::overload_cast<
-                const Eigen::MatrixXd&, const Eigen::MatrixXi&,
+                ConstRef<Eigen::MatrixXd>, const Eigen::MatrixXi&,
                 const Eigen::MatrixXi&, const double>(&BroadPhase::build),
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Build the broad phase for static collision detection.
 
@@ -59,12 +60,55 @@ void define_broad_phase(py::module_& m)
         .def(
             "build",
             py::overload_cast<
-                const Eigen::MatrixXd&, const Eigen::MatrixXd&,
+                ConstRef<Eigen::MatrixXd>, ConstRef<Eigen::MatrixXd>,
                 const Eigen::MatrixXi&, const Eigen::MatrixXi&, const double>(
                 &BroadPhase::build),
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Build the broad phase for continuous collision detection.
 
+            Parameters:
+                vertices_t0: Starting vertices of the vertices.
+                vertices_t1: Ending vertices of the vertices.
+                edges: Collision mesh edges
+                faces: Collision mesh faces
+                inflation_radius: Radius of inflation around all elements.
+            )ipc_Qu8mg5v7",
+            py::arg("vertices_t0"), py::arg("vertices_t1"), py::arg("edges"),
+            py::arg("faces"), py::arg("inflation_radius") = 0)
+        .def(
+            "update",
+            py::overload_cast<
+                ConstRef<Eigen::MatrixXd>, const Eigen::MatrixXi&,
+                const Eigen::MatrixXi&, const double>(&BroadPhase::update),
+            release_gil(),
+            R"ipc_Qu8mg5v7(
+            Update the broad phase for static collision detection with new vertex positions.
+
+            Note:
+                Falls back to build if the mesh connectivity or inflation radius changed.
+
+            Parameters:
+                vertices: Vertex positions
+                edges: Collision mesh edges
+                faces: Collision mesh faces
+                inflation_radius: Radius of inflation around all elements.
+            )ipc_Qu8mg5v7",
+            py::arg("vertices"), py::arg("edges"), py::arg("faces"),
+            py::arg("inflation_radius") = 0)
+        .def(
+            "update",
+            py::overload_cast<
+                ConstRef<Eigen::MatrixXd>, ConstRef<Eigen::MatrixXd>,
+                const Eigen::MatrixXi&, const Eigen::MatrixXi&, const double>(
+                &BroadPhase::update),
+            release_gil(),
+            R"ipc_Qu8mg5v7(
+            Update the broad phase for continuous collision detection with new vertex positions.
+
+            Note:
+                Falls back to build if the mesh connectivity or inflation radius changed.
+
             Parameters:
                 vertices_t0: Starting vertices of the vertices.
                 vertices_t1: Ending vertices of the vertices.
@@ -75,6 +119,13 @@ void define_broad_phase(py::module_& m)
             py::arg("vertices_t0"), py::arg("vertices_t1"), py::arg("edges"),
             py::arg("faces"), py::arg("inflation_radius") = 0)
         .def("clear", &BroadPhase::clear, "Clear any built data.")
+        .def(
+            "method", &BroadPhase::method,
+            "Get the method implemented by this broad phase.")
+        .def(
+            "last_build_inflation_radius",
+            &BroadPhase::last_build_inflation_radius,
+            "Get the inflation radius of the last build (zero if the broad phase was never built).")
         .def(
             "detect_vertex_vertex_candidates",
             [](const BroadPhase& self) {
@@ -82,6 +133,7 @@ void define_broad_phase(py::module_& m)
                 self.detect_vertex_vertex_candidates(candidates);
                 return candidates;
             },
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Find the candidate vertex-vertex collisions.
 
@@ -95,6 +147,7 @@ void define_broad_phase(py::module_& m)
                 self.detect_edge_vertex_candidates(candidates);
                 return candidates;
             },
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Find the candidate edge-vertex collisions.
 
@@ -108,6 +161,7 @@ void define_broad_phase(py::module_& m)
                 self.detect_edge_edge_candidates(candidates);
                 return candidates;
             },
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Find the candidate edge-edge collisions.
 
@@ -121,6 +175,7 @@ void define_broad_phase(py::module_& m)
                 self.detect_face_vertex_candidates(candidates);
                 return candidates;
             },
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Find the candidate face-vertex collisions.
 
@@ -134,6 +189,7 @@ void define_broad_phase(py::module_& m)
                 self.detect_edge_face_candidates(candidates);
                 return candidates;
             },
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Find the candidate edge-face intersections.
 
@@ -147,6 +203,7 @@ void define_broad_phase(py::module_& m)
                 self.detect_collision_candidates(dim, candidates);
                 return candidates;
             },
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Detect all collision candidates needed for a given dimensional simulation.
 
@@ -9,7 +9,7 @@ void define_hash_grid(py::module_& m)
 {
     py::class_<HashItem>(m, "HashItem")
         .def(
-            py::init<int, int>(),
+            py::init<uint64_t, long>(),
             "Construct a hash item as a (key, value) pair.", py::arg("key"),
             py::arg("id"))
         .def(
@@ -19,6 +19,10 @@ void define_hash_grid(py::module_& m)
         .def_readwrite("id", &HashItem::id, "The value of the item.");
 
     py::class_<HashGrid, BroadPhase>(m, "HashGrid")
+        .def_property(
+            "use_sparse_domain", &HashGrid::use_sparse_domain,
+            &HashGrid::set_use_sparse_domain,
+            "If the grid is unbounded instead of clamped to the mesh domain.")
         .def("cellSize", &HashGrid::cellSize)
         .def(
             "gridSize", &HashGrid::gridSize, py::return_value_policy::reference)
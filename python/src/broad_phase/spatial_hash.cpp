@@ -2,6 +2,9 @@
 
 #include <ipc/broad_phase/spatial_hash.hpp>
 
+#include <algorithm>
+#include <map>
+
 namespace py = pybind11;
 using namespace ipc;
 
@@ -11,13 +14,13 @@ void define_spatial_hash(py::module_& m)
         .def(py::init())
         .def(
             py::init<
-                const Eigen::MatrixXd&, const Eigen::MatrixXi&,
+                ConstRef<Eigen::MatrixXd>, const Eigen::MatrixXi&,
                 const Eigen::MatrixXi&, double, double>(),
             py::arg("vertices"), py::arg("edges"), py::arg("faces"),
             py::arg("inflation_radius") = 0, py::arg("voxel_size") = -1)
         .def(
             py::init<
-                const Eigen::MatrixXd&, const Eigen::MatrixXd&,
+                ConstRef<Eigen::MatrixXd>, ConstRef<Eigen::MatrixXd>,
                 const Eigen::MatrixXi&, const Eigen::MatrixXi&, double,
                 double>(),
             py::arg("vertices_t0"), py::arg("vertices_t1"), py::arg("edges"),
@@ -26,14 +29,14 @@ void define_spatial_hash(py::module_& m)
         .def(
             "build",
             py::overload_cast<
-                const Eigen::MatrixXd&, const Eigen::MatrixXi&,
+                ConstRef<Eigen::MatrixXd>, const Eigen::MatrixXi&,
                 const Eigen::MatrixXi&, double, double>(&SpatialHash::build),
             py::arg("vertices"), py::arg("edges"), py::arg("faces"),
             py::arg("inflation_radius") = 0, py::arg("voxel_size") = -1)
         .def(
             "build",
             py::overload_cast<
-                const Eigen::MatrixXd&, const Eigen::MatrixXd&,
+                ConstRef<Eigen::MatrixXd>, ConstRef<Eigen::MatrixXd>,
                 const Eigen::MatrixXi&, const Eigen::MatrixXi&, double, double>(
                 &SpatialHash::build),
             py::arg("vertices_t0"), py::arg("vertices_t1"), py::arg("edges"),
@@ -62,7 +65,36 @@ void define_spatial_hash(py::module_& m)
         .def_readwrite("voxel_count_0x1", &SpatialHash::voxel_count_0x1)
         .def_readwrite("edge_start_ind", &SpatialHash::edge_start_ind)
         .def_readwrite("tri_start_ind", &SpatialHash::tri_start_ind)
-        .def_readwrite("voxel", &SpatialHash::voxel)
+        .def_readonly("voxel_ids", &SpatialHash::voxel_ids)
+        .def_readonly("voxel_offsets", &SpatialHash::voxel_offsets)
+        .def_readonly("voxel_primitives", &SpatialHash::voxel_primitives)
+        .def_property(
+            "voxel",
+            [](const SpatialHash& self) {
+                std::map<int, std::vector<int>> voxel;
+                for (size_t i = 0; i < self.voxel_ids.size(); i++) {
+                    voxel[self.voxel_ids[i]].assign(
+                        self.voxel_primitives.begin() + self.voxel_offsets[i],
+                        self.voxel_primitives.begin()
+                            + self.voxel_offsets[i + 1]);
+                }
+                return voxel;
+            },
+            [](SpatialHash& self,
+               const std::map<int, std::vector<int>>& voxel) {
+                self.voxel_ids.clear();
+                self.voxel_offsets.assign(1, 0);
+                self.voxel_primitives.clear();
+                for (auto [voxel_ind, primitives] : voxel) {
+                    std::sort(primitives.begin(), primitives.end());
+                    self.voxel_ids.push_back(voxel_ind);
+                    self.voxel_primitives.insert(
+                        self.voxel_primitives.end(), primitives.begin(),
+                        primitives.end());
+                    self.voxel_offsets.push_back(self.voxel_primitives.size());
+                }
+            },
+            "Primitives in each occupied voxel (a view of the voxel_ids, voxel_offsets, and voxel_primitives arrays).")
         .def_readwrite(
             "point_and_edge_occupancy", &SpatialHash::point_and_edge_occupancy);
 }
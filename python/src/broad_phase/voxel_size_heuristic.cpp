@@ -10,22 +10,23 @@ void define_voxel_size_heuristic(py::module_& m)
     m.def(
         "suggest_good_voxel_size",
         py::overload_cast<
-            const Eigen::MatrixXd&, const Eigen::MatrixXi&, const double>(
+            ConstRef<Eigen::MatrixXd>, const Eigen::MatrixXi&, const double>(
             &suggest_good_voxel_size),
         py::arg("vertices"), py::arg("edges"), py::arg("inflation_radius") = 0);
 
     m.def(
         "suggest_good_voxel_size",
         py::overload_cast<
-            const Eigen::MatrixXd&, const Eigen::MatrixXd&,
+            ConstRef<Eigen::MatrixXd>, ConstRef<Eigen::MatrixXd>,
             const Eigen::MatrixXi&, const double>(&suggest_good_voxel_size),
         py::arg("vertices_t0"), py::arg("vertices_t1"), py::arg("edges"),
         py::arg("inflation_radius") = 0);
 
     m.def(
         "mean_edge_length",
-        [](const Eigen::MatrixXd& vertices_t0,
-           const Eigen::MatrixXd& vertices_t1, const Eigen::MatrixXi& edges) {
+        [](ConstRef<Eigen::MatrixXd> vertices_t0,
+           ConstRef<Eigen::MatrixXd> vertices_t1,
+           const Eigen::MatrixXi& edges) {
             double std_deviation;
             double r = mean_edge_length(
                 vertices_t0, vertices_t1, edges, std_deviation);
@@ -36,7 +37,7 @@ void define_voxel_size_heuristic(py::module_& m)
 
     m.def(
         "mean_displacement_length",
-        [](const Eigen::MatrixXd& displacements) {
+        [](ConstRef<Eigen::MatrixXd> displacements) {
             double std_deviation;
             double r = mean_displacement_length(displacements, std_deviation);
             return std::make_tuple(r, std_deviation);
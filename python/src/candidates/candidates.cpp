@@ -1,6 +1,7 @@
 #include <common.hpp>
 
 #include <ipc/candidates/candidates.hpp>
+#include <ipc/candidates/narrow_phase_ccd.hpp>
 
 namespace py = pybind11;
 using namespace ipc;
@@ -12,8 +13,9 @@ void define_candidates(py::module_& m)
         .def(
             "build",
             py::overload_cast<
-                const CollisionMesh&, const Eigen::MatrixXd&, const double,
+                const CollisionMesh&, ConstRef<Eigen::MatrixXd>, const double,
                 const BroadPhaseMethod>(&Candidates::build),
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Initialize the set of discrete collision detection candidates.
 
@@ -29,9 +31,10 @@ void define_candidates(py::module_& m)
         .def(
             "build",
             py::overload_cast<
-                const CollisionMesh&, const Eigen::MatrixXd&,
-                const Eigen::MatrixXd&, const double, const BroadPhaseMethod>(
-                &Candidates::build),
+                const CollisionMesh&, ConstRef<Eigen::MatrixXd>,
+                ConstRef<Eigen::MatrixXd>, const double,
+                const BroadPhaseMethod>(&Candidates::build),
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Initialize the set of continuous collision detection candidates.
 
@@ -58,7 +61,17 @@ void define_candidates(py::module_& m)
             },
             py::return_value_policy::reference)
         .def(
-            "is_step_collision_free", &Candidates::is_step_collision_free,
+            "is_step_collision_free",
+            [](const Candidates& self, const CollisionMesh& mesh,
+               ConstRef<Eigen::MatrixXd> vertices_t0,
+               ConstRef<Eigen::MatrixXd> vertices_t1,
+               const double min_distance, const double tolerance,
+               const long max_iterations) {
+                return self.is_step_collision_free(
+                    mesh, vertices_t0, vertices_t1, min_distance, tolerance,
+                    max_iterations);
+            },
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Determine if the step is collision free from the set of candidates.
 
@@ -82,7 +95,16 @@ void define_candidates(py::module_& m)
             py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS)
         .def(
             "compute_collision_free_stepsize",
-            &Candidates::compute_collision_free_stepsize,
+            [](const Candidates& self, const CollisionMesh& mesh,
+               ConstRef<Eigen::MatrixXd> vertices_t0,
+               ConstRef<Eigen::MatrixXd> vertices_t1,
+               const double min_distance, const double tolerance,
+               const long max_iterations) {
+                return self.compute_collision_free_stepsize(
+                    mesh, vertices_t0, vertices_t1, min_distance, tolerance,
+                    max_iterations);
+            },
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Computes a maximal step size that is collision free using the set of collision candidates.
 
@@ -107,6 +129,7 @@ void define_candidates(py::module_& m)
         .def(
             "compute_noncandidate_conservative_stepsize",
             &Candidates::compute_noncandidate_conservative_stepsize,
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Computes a conservative bound on the largest-feasible step size for surface primitives not in collision.
 
@@ -118,6 +141,7 @@ void define_candidates(py::module_& m)
             py::arg("mesh"), py::arg("displacements"), py::arg("dhat"))
         .def(
             "compute_cfl_stepsize", &Candidates::compute_cfl_stepsize,
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Computes a CFL-inspired CCD maximum step step size.
 
@@ -143,4 +167,30 @@ void define_candidates(py::module_& m)
         .def_readwrite("ev_candidates", &Candidates::ev_candidates)
         .def_readwrite("ee_candidates", &Candidates::ee_candidates)
         .def_readwrite("fv_candidates", &Candidates::fv_candidates);
+
+    m.def(
+        "narrow_phase_ccd", &narrow_phase_ccd, release_gil(),
+        R"ipc_Qu8mg5v7(
+        Compute the time of impact of every candidate using the batched narrow phase.
+
+        Parameters:
+            candidates: The candidates to check.
+            mesh: The collision mesh.
+            vertices_t0: Surface vertex starting positions (rowwise).
+            vertices_t1: Surface vertex ending positions (rowwise).
+            min_distance: The minimum distance allowable between any two elements.
+            tmax: The maximum time to check for collisions.
+            tolerance: The tolerance for the CCD algorithm.
+            max_iterations: The maximum number of iterations for the CCD algorithm.
+            conservative_rescaling: The conservative rescaling of the time of impact.
+
+        Returns:
+            Time of impact of each candidate (infinity if there is no impact before tmax).
+        )ipc_Qu8mg5v7",
+        py::arg("candidates"), py::arg("mesh"), py::arg("vertices_t0"),
+        py::arg("vertices_t1"), py::arg("min_distance") = 0.0,
+        py::arg("tmax") = 1.0, py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
+        py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
+        py::arg("conservative_rescaling") =
+            DEFAULT_CCD_CONSERVATIVE_RESCALING);
 }
@@ -25,12 +25,15 @@ void define_collision_stencil(py::module_& m)
             )ipc_Qu8mg5v7",
             py::arg("edges"), py::arg("faces"))
         .def(
-            "vertices", &CollisionStencil::vertices<double>,
+            "vertices",
+            [](const CollisionStencil& self,
+               ConstRef<Eigen::MatrixXd> vertices, const Eigen::MatrixXi& edges,
+               const Eigen::MatrixXi& faces) {
+                return self.vertices(vertices, edges, faces);
+            },
             R"ipc_Qu8mg5v7(
             Get the vertex attributes of the collision stencil.
 
-            T Type of the attributes
-
             Parameters:
                 vertices: Vertex attributes
                 edges: Collision mesh edges
@@ -41,12 +44,14 @@ void define_collision_stencil(py::module_& m)
             )ipc_Qu8mg5v7",
             py::arg("vertices"), py::arg("edges"), py::arg("faces"))
         .def(
-            "dof", &CollisionStencil::dof<double>,
+            "dof",
+            [](const CollisionStencil& self, ConstRef<Eigen::MatrixXd> X,
+               const Eigen::MatrixXi& edges, const Eigen::MatrixXi& faces) {
+                return self.dof(X, edges, faces);
+            },
             R"ipc_Qu8mg5v7(
             Select this stencil's DOF from the full matrix of DOF.
 
-            T Type of the DOF
-
             Parameters:
                 X: Full matrix of DOF (rowwise).
                 edges: Collision mesh edges
@@ -10,7 +10,7 @@ void define_collision_mesh(py::module_& m)
     py::class_<CollisionMesh>(m, "CollisionMesh")
         .def(
             py::init<
-                const Eigen::MatrixXd&, const Eigen::MatrixXi&,
+                ConstRef<Eigen::MatrixXd>, const Eigen::MatrixXi&,
                 const Eigen::MatrixXi&, const Eigen::SparseMatrix<double>&>(),
             R"ipc_Qu8mg5v7(
             Construct a new Collision Mesh object directly from the collision mesh vertices.
@@ -25,7 +25,7 @@ void define_collision_mesh(py::module_& m)
             py::arg("displacement_map") = Eigen::SparseMatrix<double>())
         .def(
             py::init<
-                const std::vector<bool>&, const Eigen::MatrixXd&,
+                const std::vector<bool>&, ConstRef<Eigen::MatrixXd>,
                 const Eigen::MatrixXi&, const Eigen::MatrixXi&,
                 const Eigen::SparseMatrix<double>&>(),
             R"ipc_Qu8mg5v7(
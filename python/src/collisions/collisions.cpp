@@ -12,8 +12,9 @@ void define_collisions(py::module_& m)
         .def(
             "build",
             py::overload_cast<
-                const CollisionMesh&, const Eigen::MatrixXd&, const double,
+                const CollisionMesh&, ConstRef<Eigen::MatrixXd>, const double,
                 const double, const BroadPhaseMethod>(&Collisions::build),
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Initialize the set of collisions used to compute the barrier potential.
 
@@ -30,8 +31,10 @@ void define_collisions(py::module_& m)
         .def(
             "build",
             py::overload_cast<
-                const Candidates&, const CollisionMesh&, const Eigen::MatrixXd&,
-                const double, const double>(&Collisions::build),
+                const Candidates&, const CollisionMesh&,
+                ConstRef<Eigen::MatrixXd>, const double, const double>(
+                &Collisions::build),
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Initialize the set of collisions used to compute the barrier potential.
 
@@ -46,6 +49,7 @@ void define_collisions(py::module_& m)
             py::arg("dhat"), py::arg("dmin") = 0)
         .def(
             "compute_minimum_distance", &Collisions::compute_minimum_distance,
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Computes the minimum distance between any non-adjacent elements.
 
@@ -147,6 +151,10 @@ void define_collisions(py::module_& m)
             &Collisions::are_shape_derivatives_enabled,
             &Collisions::set_are_shape_derivatives_enabled,
             "If the collisions are using the convergent formulation.")
+        .def_property(
+            "use_batch_culling", &Collisions::use_batch_culling,
+            &Collisions::set_use_batch_culling,
+            "If the face-vertex candidates are culled with batched distance lower bounds while building.")
         .def(
             "to_string", &Collisions::to_string, py::arg("mesh"),
             py::arg("vertices"))
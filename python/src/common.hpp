@@ -54,4 +54,54 @@ inline void copy_vector(
     } else {
         v_copy = v.transpose();
     }
-}
\ No newline at end of file
+}
+
+/// @brief Release the GIL while a bound function runs.
+/// @note The arguments are converted and the result is cast with the GIL held.
+/// @note Required on any binding whose C++ code may call a Python callback
+///       (e.g., CollisionMesh::can_collide) from a TBB worker. Otherwise the
+///       worker waits forever for the GIL held by the calling thread.
+using release_gil = pybind11::call_guard<pybind11::gil_scoped_release>;
+
+/// @brief Call a function with the GIL released.
+/// @param f Function to call. It must not touch Python objects.
+/// @return The result of f.
+template <typename F> inline auto without_gil(F&& f)
+{
+    pybind11::gil_scoped_release release;
+    return f();
+}
+
+/// @brief Convert a sparse matrix to a scipy.sparse.csr_matrix or csc_matrix.
+/// @note The matrix is moved into a capsule that owns the SciPy buffers, so nothing is copied. A column-major matrix is returned as a csc_matrix unless it is symmetric: its buffers are then the CSR buffers of its transpose, which is the same matrix, and it is returned as a csr_matrix.
+/// @param M Sparse matrix to convert.
+/// @param is_symmetric If M is symmetric.
+/// @return The SciPy sparse matrix.
+template <int Options>
+inline pybind11::object to_scipy_sparse(
+    Eigen::SparseMatrix<double, Options>&& M, const bool is_symmetric = false)
+{
+    namespace py = pybind11;
+    using SparseMatrix = Eigen::SparseMatrix<double, Options>;
+    using StorageIndex = typename SparseMatrix::StorageIndex;
+
+    assert(!is_symmetric || M.rows() == M.cols());
+    const bool is_csr = (Options & Eigen::RowMajor) || is_symmetric;
+
+    M.makeCompressed();
+    auto* owner = new SparseMatrix(std::move(M));
+    py::capsule base(
+        owner, [](void* p) { delete static_cast<SparseMatrix*>(p); });
+
+    const py::array_t<double> data(
+        owner->nonZeros(), owner->valuePtr(), base);
+    const py::array_t<StorageIndex> indices(
+        owner->nonZeros(), owner->innerIndexPtr(), base);
+    const py::array_t<StorageIndex> indptr(
+        owner->outerSize() + 1, owner->outerIndexPtr(), base);
+
+    return py::module_::import("scipy.sparse")
+        .attr(is_csr ? "csr_matrix" : "csc_matrix")(
+            py::make_tuple(data, indices, indptr),
+            py::make_tuple(owner->rows(), owner->cols()));
+}
@@ -12,7 +12,7 @@ void define_edge_edge_friction_collision(py::module_& m)
         .def(py::init<const EdgeEdgeCollision&>(), py::arg("collision"))
         .def(
             py::init<
-                const EdgeEdgeCollision&, const Eigen::MatrixXd&,
+                const EdgeEdgeCollision&, ConstRef<Eigen::MatrixXd>,
                 const Eigen::MatrixXi&, const Eigen::MatrixXi&, const double,
                 const double>(),
             py::arg("collision"), py::arg("vertices"), py::arg("edges"),
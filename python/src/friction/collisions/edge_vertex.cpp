@@ -13,7 +13,7 @@ void define_edge_vertex_friction_collision(py::module_& m)
         .def(py::init<const EdgeVertexCollision&>(), py::arg("collision"))
         .def(
             py::init<
-                const EdgeVertexCollision&, const Eigen::MatrixXd&,
+                const EdgeVertexCollision&, ConstRef<Eigen::MatrixXd>,
                 const Eigen::MatrixXi&, const Eigen::MatrixXi&, const double,
                 const double>(),
             py::arg("collision"), py::arg("vertices"), py::arg("edges"),
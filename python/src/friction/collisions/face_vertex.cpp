@@ -13,7 +13,7 @@ void define_face_vertex_friction_collision(py::module_& m)
         .def(py::init<const FaceVertexCollision&>(), py::arg("collision"))
         .def(
             py::init<
-                const FaceVertexCollision&, const Eigen::MatrixXd&,
+                const FaceVertexCollision&, ConstRef<Eigen::MatrixXd>,
                 const Eigen::MatrixXi&, const Eigen::MatrixXi&, const double,
                 const double>(),
             py::arg("collision"), py::arg("vertices"), py::arg("edges"),
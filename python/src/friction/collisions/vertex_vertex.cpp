@@ -13,7 +13,7 @@ void define_vertex_vertex_friction_collision(py::module_& m)
         .def(py::init<const VertexVertexCollision&>(), py::arg("collision"))
         .def(
             py::init<
-                const VertexVertexCollision&, const Eigen::MatrixXd&,
+                const VertexVertexCollision&, ConstRef<Eigen::MatrixXd>,
                 const Eigen::MatrixXi&, const Eigen::MatrixXi&, const double,
                 const double>(),
             py::arg("collision"), py::arg("vertices"), py::arg("edges"),
@@ -9,7 +9,8 @@ void define_plane_implicit(py::module_& m)
 {
     m.def(
         "construct_point_plane_collisions",
-        [](const Eigen::MatrixXd& points, const Eigen::MatrixXd& plane_origins,
+        [](ConstRef<Eigen::MatrixXd> points,
+           const Eigen::MatrixXd& plane_origins,
            const Eigen::MatrixXd& plane_normals, const double dhat,
            const double dmin = 0) {
             std::vector<PlaneVertexCollision> pv_collisions;
@@ -18,6 +19,7 @@ void define_plane_implicit(py::module_& m)
                 dmin);
             return pv_collisions;
         },
+        release_gil(),
         R"ipc_Qu8mg5v7(
         Construct a set of point-plane distance collisions used to compute
 
@@ -41,7 +43,8 @@ void define_plane_implicit(py::module_& m)
 
     m.def(
         "construct_point_plane_collisions",
-        [](const Eigen::MatrixXd& points, const Eigen::MatrixXd& plane_origins,
+        [](ConstRef<Eigen::MatrixXd> points,
+           const Eigen::MatrixXd& plane_origins,
            const Eigen::MatrixXd& plane_normals, const double dhat,
            const double dmin,
            const std::function<bool(size_t, size_t)>& can_collide) {
@@ -51,6 +54,7 @@ void define_plane_implicit(py::module_& m)
                 can_collide);
             return pv_collisions;
         },
+        release_gil(),
         R"ipc_Qu8mg5v7(
         Construct a set of point-plane distance collisions used to compute
 
@@ -75,12 +79,14 @@ void define_plane_implicit(py::module_& m)
 
     m.def(
         "is_step_point_plane_collision_free",
-        [](const Eigen::MatrixXd& points_t0, const Eigen::MatrixXd& points_t1,
+        [](ConstRef<Eigen::MatrixXd> points_t0,
+           ConstRef<Eigen::MatrixXd> points_t1,
            const Eigen::MatrixXd& plane_origins,
            const Eigen::MatrixXd& plane_normals) {
             return is_step_point_plane_collision_free(
                 points_t0, points_t1, plane_origins, plane_normals);
         },
+        release_gil(),
         R"ipc_Qu8mg5v7(
         Determine if the step is collision free.
 
@@ -101,7 +107,8 @@ void define_plane_implicit(py::module_& m)
 
     m.def(
         "is_step_point_plane_collision_free",
-        [](const Eigen::MatrixXd& points_t0, const Eigen::MatrixXd& points_t1,
+        [](ConstRef<Eigen::MatrixXd> points_t0,
+           ConstRef<Eigen::MatrixXd> points_t1,
            const Eigen::MatrixXd& plane_origins,
            const Eigen::MatrixXd& plane_normals,
            const std::function<bool(size_t, size_t)>& can_collide) {
@@ -109,6 +116,7 @@ void define_plane_implicit(py::module_& m)
                 points_t0, points_t1, plane_origins, plane_normals,
                 can_collide);
         },
+        release_gil(),
         R"ipc_Qu8mg5v7(
         Determine if the step is collision free.
 
@@ -130,12 +138,14 @@ void define_plane_implicit(py::module_& m)
 
     m.def(
         "compute_point_plane_collision_free_stepsize",
-        [](const Eigen::MatrixXd& points_t0, const Eigen::MatrixXd& points_t1,
+        [](ConstRef<Eigen::MatrixXd> points_t0,
+           ConstRef<Eigen::MatrixXd> points_t1,
            const Eigen::MatrixXd& plane_origins,
            const Eigen::MatrixXd& plane_normals) {
             return compute_point_plane_collision_free_stepsize(
                 points_t0, points_t1, plane_origins, plane_normals);
         },
+        release_gil(),
         R"ipc_Qu8mg5v7(
         Computes a maximal step size that is collision free.
 
@@ -159,7 +169,8 @@ void define_plane_implicit(py::module_& m)
 
     m.def(
         "compute_point_plane_collision_free_stepsize",
-        [](const Eigen::MatrixXd& points_t0, const Eigen::MatrixXd& points_t1,
+        [](ConstRef<Eigen::MatrixXd> points_t0,
+           ConstRef<Eigen::MatrixXd> points_t1,
            const Eigen::MatrixXd& plane_origins,
            const Eigen::MatrixXd& plane_normals,
            const std::function<bool(size_t, size_t)>& can_collide) {
@@ -167,6 +178,7 @@ void define_plane_implicit(py::module_& m)
                 points_t0, points_t1, plane_origins, plane_normals,
                 can_collide);
         },
+        release_gil(),
         R"ipc_Qu8mg5v7(
         Computes a maximal step size that is collision free.
 
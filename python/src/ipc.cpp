@@ -12,7 +12,12 @@ void define_ipc(py::module_& m)
     m.attr("__version__") = IPC_TOOLKIT_VER;
 
     m.def(
-        "is_step_collision_free", &is_step_collision_free,
+        "is_step_collision_free",
+        py::overload_cast<
+            const CollisionMesh&, ConstRef<Eigen::MatrixXd>,
+            ConstRef<Eigen::MatrixXd>, const BroadPhaseMethod, const double,
+            const double, const long>(&is_step_collision_free),
+        release_gil(),
         R"ipc_Qu8mg5v7(
         Determine if the step is collision free.
 
@@ -38,7 +43,12 @@ void define_ipc(py::module_& m)
         py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS);
 
     m.def(
-        "compute_collision_free_stepsize", &compute_collision_free_stepsize,
+        "compute_collision_free_stepsize",
+        py::overload_cast<
+            const CollisionMesh&, ConstRef<Eigen::MatrixXd>,
+            ConstRef<Eigen::MatrixXd>, const BroadPhaseMethod, const double,
+            const double, const long>(&compute_collision_free_stepsize),
+        release_gil(),
         R"ipc_Qu8mg5v7(
         Computes a maximal step size that is collision free.
 
@@ -64,7 +74,11 @@ void define_ipc(py::module_& m)
         py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS);
 
     m.def(
-        "has_intersections", &has_intersections,
+        "has_intersections",
+        py::overload_cast<
+            const CollisionMesh&, ConstRef<Eigen::MatrixXd>,
+            const BroadPhaseMethod>(&has_intersections),
+        release_gil(),
         R"ipc_Qu8mg5v7(
         Determine if the mesh has self intersections.
 
@@ -79,6 +93,29 @@ void define_ipc(py::module_& m)
         py::arg("mesh"), py::arg("vertices"),
         py::arg("broad_phase_method") = DEFAULT_BROAD_PHASE_METHOD);
 
+    m.def(
+        "compute_intersecting_pairs",
+        py::overload_cast<
+            const CollisionMesh&, ConstRef<Eigen::MatrixXd>,
+            const BroadPhaseMethod>(&compute_intersecting_pairs),
+        release_gil(),
+        R"ipc_Qu8mg5v7(
+        Find all pairs of intersecting elements of the mesh.
+
+        Note:
+            The candidates are checked in parallel.
+
+        Parameters:
+            mesh: The collision mesh.
+            vertices: Vertices of the collision mesh.
+            broad_phase_method: The broad phase method to use.
+
+        Returns:
+            #I by 2 matrix of intersecting pairs sorted lexicographically: edge-edge pairs in 2D and edge-face pairs in 3D.
+        )ipc_Qu8mg5v7",
+        py::arg("mesh"), py::arg("vertices"),
+        py::arg("broad_phase_method") = DEFAULT_BROAD_PHASE_METHOD);
+
     m.def(
         "edges",
         [](const Eigen::MatrixXi& F) {
@@ -21,8 +21,9 @@ void define_barrier_potential(py::module_& m)
             "__call__",
             py::overload_cast<
                 const Collisions&, const CollisionMesh&,
-                const Eigen::MatrixXd&>(
+                ConstRef<Eigen::MatrixXd>>(
                 &BarrierPotential::Potential::operator(), py::const_),
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Compute the barrier potential for a set of collisions.
 
@@ -39,8 +40,9 @@ void define_barrier_potential(py::module_& m)
             "gradient",
             py::overload_cast<
                 const Collisions&, const CollisionMesh&,
-                const Eigen::MatrixXd&>(
+                ConstRef<Eigen::MatrixXd>>(
                 &BarrierPotential::Potential::gradient, py::const_),
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Compute the gradient of the barrier potential.
 
@@ -55,9 +57,16 @@ void define_barrier_potential(py::module_& m)
             py::arg("collisions"), py::arg("mesh"), py::arg("vertices"))
         .def(
             "hessian",
-            py::overload_cast<
-                const Collisions&, const CollisionMesh&, const Eigen::MatrixXd&,
-                const bool>(&BarrierPotential::Potential::hessian, py::const_),
+            [](const BarrierPotential& self, const Collisions& collisions,
+               const CollisionMesh& mesh, ConstRef<Eigen::MatrixXd> vertices,
+               const bool project_hessian_to_psd) {
+                return to_scipy_sparse(
+                    without_gil([&] {
+                        return self.hessian(
+                            collisions, mesh, vertices, project_hessian_to_psd);
+                    }),
+                    /*is_symmetric=*/true);
+            },
             R"ipc_Qu8mg5v7(
             Compute the hessian of the barrier potential.
 
@@ -74,10 +83,12 @@ void define_barrier_potential(py::module_& m)
             py::arg("project_hessian_to_psd") = false)
         .def(
             "shape_derivative",
-            py::overload_cast<
-                const Collisions&, const CollisionMesh&,
-                const Eigen::MatrixXd&>(
-                &BarrierPotential::shape_derivative, py::const_),
+            [](const BarrierPotential& self, const Collisions& collisions,
+               const CollisionMesh& mesh, ConstRef<Eigen::MatrixXd> vertices) {
+                return to_scipy_sparse(without_gil([&] {
+                    return self.shape_derivative(collisions, mesh, vertices);
+                }));
+            },
             R"ipc_Qu8mg5v7(
             Compute the shape derivative of the potential.
 
@@ -170,5 +181,14 @@ void define_barrier_potential(py::module_& m)
             [](BarrierPotential& self, const double dhat) {
                 self.set_dhat(dhat);
             },
-            "Barrier activation distance.");
+            "Barrier activation distance.")
+        .def_property(
+            "psd_projection_method",
+            [](const BarrierPotential& self) {
+                return self.psd_projection_method();
+            },
+            [](BarrierPotential& self, const PSDProjectionMethod method) {
+                self.set_psd_projection_method(method);
+            },
+            "Method used to project local hessians onto the positive semi-definite cone.");
 }
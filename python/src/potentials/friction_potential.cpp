@@ -36,8 +36,9 @@ void define_friction_potential(py::module_& m)
             "__call__",
             py::overload_cast<
                 const FrictionCollisions&, const CollisionMesh&,
-                const Eigen::MatrixXd&>(
+                ConstRef<Eigen::MatrixXd>>(
                 &FrictionPotential::Potential::operator(), py::const_),
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Compute the friction dissipative potential for a set of collisions.
 
@@ -54,8 +55,9 @@ void define_friction_potential(py::module_& m)
             "gradient",
             py::overload_cast<
                 const FrictionCollisions&, const CollisionMesh&,
-                const Eigen::MatrixXd&>(
+                ConstRef<Eigen::MatrixXd>>(
                 &FrictionPotential::Potential::gradient, py::const_),
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Compute the gradient of the friction dissipative potential.
 
@@ -70,10 +72,17 @@ void define_friction_potential(py::module_& m)
             py::arg("collisions"), py::arg("mesh"), py::arg("vertices"))
         .def(
             "hessian",
-            py::overload_cast<
-                const FrictionCollisions&, const CollisionMesh&,
-                const Eigen::MatrixXd&, const bool>(
-                &FrictionPotential::Potential::hessian, py::const_),
+            [](const FrictionPotential& self,
+               const FrictionCollisions& collisions, const CollisionMesh& mesh,
+               ConstRef<Eigen::MatrixXd> vertices,
+               const bool project_hessian_to_psd) {
+                return to_scipy_sparse(
+                    without_gil([&] {
+                        return self.hessian(
+                            collisions, mesh, vertices, project_hessian_to_psd);
+                    }),
+                    /*is_symmetric=*/true);
+            },
             R"ipc_Qu8mg5v7(
             Compute the hessian of the friction dissipative potential.
 
@@ -92,10 +101,11 @@ void define_friction_potential(py::module_& m)
             "force",
             py::overload_cast<
                 const FrictionCollisions&, const CollisionMesh&,
-                const Eigen::MatrixXd&, const Eigen::MatrixXd&,
-                const Eigen::MatrixXd&, const double, const double,
+                ConstRef<Eigen::MatrixXd>, ConstRef<Eigen::MatrixXd>,
+                ConstRef<Eigen::MatrixXd>, const double, const double,
                 const double, const bool>(
                 &FrictionPotential::force, py::const_),
+            release_gil(),
             R"ipc_Qu8mg5v7(
             Compute the friction force for all collisions.
 
@@ -119,12 +129,19 @@ void define_friction_potential(py::module_& m)
             py::arg("no_mu") = false)
         .def(
             "force_jacobian",
-            py::overload_cast<
-                const FrictionCollisions&, const CollisionMesh&,
-                const Eigen::MatrixXd&, const Eigen::MatrixXd&,
-                const Eigen::MatrixXd&, const double, const double,
-                const FrictionPotential::DiffWRT, const double>(
-                &FrictionPotential::force_jacobian, py::const_),
+            [](const FrictionPotential& self,
+               const FrictionCollisions& collisions, const CollisionMesh& mesh,
+               ConstRef<Eigen::MatrixXd> rest_positions,
+               ConstRef<Eigen::MatrixXd> lagged_displacements,
+               ConstRef<Eigen::MatrixXd> velocities, const double dhat,
+               const double barrier_stiffness,
+               const FrictionPotential::DiffWRT wrt, const double dmin) {
+                return to_scipy_sparse(without_gil([&] {
+                    return self.force_jacobian(
+                        collisions, mesh, rest_positions, lagged_displacements,
+                        velocities, dhat, barrier_stiffness, wrt, dmin);
+                }));
+            },
             R"ipc_Qu8mg5v7(
             Compute the Jacobian of the friction force for all collisions.
 
@@ -256,5 +273,14 @@ void define_friction_potential(py::module_& m)
             [](FrictionPotential& self, const double epsv) {
                 self.set_epsv(epsv);
             },
-            "The smooth friction mollifier parameter :math:`\\epsilon_{v}`.");
+            "The smooth friction mollifier parameter :math:`\\epsilon_{v}`.")
+        .def_property(
+            "psd_projection_method",
+            [](const FrictionPotential& self) {
+                return self.psd_projection_method();
+            },
+            [](FrictionPotential& self, const PSDProjectionMethod method) {
+                self.set_psd_projection_method(method);
+            },
+            "Method used to project local hessians onto the positive semi-definite cone.");
 }
@@ -7,6 +7,17 @@ using namespace ipc;
 
 void define_eigen_ext(py::module_& m)
 {
+    py::enum_<PSDProjectionMethod>(
+        m, "PSDProjectionMethod",
+        "Methods of projecting local hessians onto the positive semi-definite cone.")
+        .value(
+            "FULL", PSDProjectionMethod::FULL,
+            "Eigen-decompose the full local hessian.")
+        .value(
+            "REDUCED", PSDProjectionMethod::REDUCED,
+            "Eigen-decompose only the restriction of the local hessian to relative vertex motions.")
+        .export_values();
+
     m.def(
         "project_to_pd",
         &project_to_pd<
@@ -38,4 +49,24 @@ void define_eigen_ext(py::module_& m)
             Projected matrix
         )ipc_Qu8mg5v7",
         py::arg("A"));
+
+    m.def(
+        "project_translation_invariant_to_psd",
+        &project_translation_invariant_to_psd<
+            double, Eigen::Dynamic, Eigen::Dynamic,
+            Eigen::ColMajor | Eigen::AutoAlign, Eigen::Dynamic, Eigen::Dynamic>,
+        R"ipc_Qu8mg5v7(
+        Matrix projection onto positive semi-definite cone of a translation-invariant stencil hessian
+
+        Note:
+            The hessian must not change when all vertices of the stencil are translated together. Only its restriction to relative motions is projected.
+
+        Parameters:
+            A: Symmetric n×n hessian of a stencil of n / dim vertices
+            dim: Dimension of the vertices
+
+        Returns:
+            Projected matrix
+        )ipc_Qu8mg5v7",
+        py::arg("A"), py::arg("dim"));
 }
@@ -0,0 +1,82 @@
+import numpy as np
+
+import find_ipctk
+import ipctk
+
+import utils
+
+
+def strided_copy(x):
+    """Copy x into every other column of a wider array and return that view."""
+    wide = np.zeros((x.shape[0], 2 * x.shape[1]))
+    wide[:, ::2] = x
+    view = wide[:, ::2]
+    assert not view.flags.c_contiguous and not view.flags.f_contiguous
+    return view
+
+
+def sorted_candidates(candidates):
+    return (
+        sorted(candidates.vv_candidates), sorted(candidates.ev_candidates),
+        sorted(candidates.ee_candidates), sorted(candidates.fv_candidates))
+
+
+def check_candidates_memory_layout(broad_phase_method):
+    vertices, edges, faces = utils.load_mesh("two-cubes-close.obj")
+    mesh = ipctk.CollisionMesh.build_from_full_mesh(vertices, edges, faces)
+    V0 = np.ascontiguousarray(mesh.vertices(vertices))
+    V0 -= V0.mean(axis=0)
+    # Squish the cubes through each other so the trajectory has candidates.
+    V1 = V0.copy()
+    V1[:, 0] *= -0.1
+    assert V0.flags.c_contiguous and V0.shape[1] == 3
+
+    expected = ipctk.Candidates()
+    expected.build(
+        mesh, np.asfortranarray(V0), np.asfortranarray(V1),
+        broad_phase_method=broad_phase_method)
+    assert len(expected) > 0
+
+    for layout in (np.ascontiguousarray, strided_copy):
+        candidates = ipctk.Candidates()
+        candidates.build(
+            mesh, layout(V0), layout(V1),
+            broad_phase_method=broad_phase_method)
+        assert sorted_candidates(candidates) == sorted_candidates(expected)
+
+    # A Python can_collide is called from TBB workers while the GIL is
+    # released; this would hang if build held the GIL.
+    mesh.can_collide = lambda vi, vj: True
+    candidates = ipctk.Candidates()
+    candidates.build(
+        mesh, strided_copy(V0), strided_copy(V1),
+        broad_phase_method=broad_phase_method)
+    assert sorted_candidates(candidates) == sorted_candidates(expected)
+
+
+def test_candidates_memory_layout():
+    for method in utils.broad_phase_methods():
+        yield check_candidates_memory_layout, method
+
+
+def test_hessian_memory_layout():
+    vertices, edges, faces = utils.load_mesh("two-cubes-close.obj")
+    mesh = ipctk.CollisionMesh.build_from_full_mesh(vertices, edges, faces)
+    vertices = np.ascontiguousarray(mesh.vertices(vertices))
+    assert vertices.flags.c_contiguous and vertices.shape[1] == 3
+
+    dhat = 1e-1
+    collisions = ipctk.Collisions()
+    collisions.build(mesh, vertices, dhat)
+    assert len(collisions) > 0
+
+    B = ipctk.BarrierPotential(dhat)
+    expected = B.hessian(collisions, mesh, np.asfortranarray(vertices))
+    assert expected.nnz > 0
+
+    for layout in (np.ascontiguousarray, strided_copy):
+        hess = B.hessian(collisions, mesh, layout(vertices))
+        assert hess.format == "csr"
+        assert not hess.data.flags.owndata  # shares the C++ buffers
+        assert hess.shape == expected.shape
+        assert abs(hess - expected).max() == 0
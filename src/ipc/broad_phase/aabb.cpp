@@ -59,7 +59,7 @@ void AABB::conservative_inflation(
 }
 
 void build_vertex_boxes(
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     std::vector<AABB>& vertex_boxes,
     const double inflation_radius)
 {
@@ -77,8 +77,8 @@ void build_vertex_boxes(
 }
 
 void build_vertex_boxes(
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     std::vector<AABB>& vertex_boxes,
     const double inflation_radius)
 {
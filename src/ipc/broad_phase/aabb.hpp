@@ -70,13 +70,13 @@ public:
 /// @param[out] vertex_boxes Vertex AABBs.
 /// @param[in] inflation_radius Radius of a sphere around the points which the AABBs enclose.
 void build_vertex_boxes(
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     std::vector<AABB>& vertex_boxes,
     const double inflation_radius = 0);
 
 void build_vertex_boxes(
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     std::vector<AABB>& vertex_boxes,
     const double inflation_radius = 0);
 
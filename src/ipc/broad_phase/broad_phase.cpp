@@ -12,7 +12,7 @@
 namespace ipc {
 
 void BroadPhase::build(
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
     const double inflation_radius)
@@ -20,14 +20,15 @@ void BroadPhase::build(
     assert(edges.size() == 0 || edges.cols() == 2);
     assert(faces.size() == 0 || faces.cols() == 3);
     clear();
+    built_inflation_radius = inflation_radius;
     build_vertex_boxes(vertices, vertex_boxes, inflation_radius);
     build_edge_boxes(vertex_boxes, edges, edge_boxes);
     build_face_boxes(vertex_boxes, faces, face_boxes);
 }
 
 void BroadPhase::build(
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
     const double inflation_radius)
@@ -35,12 +36,32 @@ void BroadPhase::build(
     assert(edges.size() == 0 || edges.cols() == 2);
     assert(faces.size() == 0 || faces.cols() == 3);
     clear();
+    built_inflation_radius = inflation_radius;
     build_vertex_boxes(
         vertices_t0, vertices_t1, vertex_boxes, inflation_radius);
     build_edge_boxes(vertex_boxes, edges, edge_boxes);
     build_face_boxes(vertex_boxes, faces, face_boxes);
 }
 
+void BroadPhase::update(
+    ConstRef<Eigen::MatrixXd> vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    build(vertices, edges, faces, inflation_radius);
+}
+
+void BroadPhase::update(
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    build(vertices_t0, vertices_t1, edges, faces, inflation_radius);
+}
+
 void BroadPhase::clear()
 {
     vertex_boxes.clear();
@@ -90,6 +111,52 @@ BroadPhase::make_broad_phase(const BroadPhaseMethod method)
     }
 }
 
+BroadPhase& BroadPhase::codim_broad_phase()
+{
+    if (m_codim_broad_phase == nullptr) {
+        m_codim_broad_phase = make_codim_broad_phase();
+    }
+    return *m_codim_broad_phase;
+}
+
+std::shared_ptr<BroadPhase> BroadPhase::make_codim_broad_phase() const
+{
+    return make_broad_phase(method());
+}
+
+// ============================================================================
+
+bool BroadPhase::is_updatable(
+    const size_t num_vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius) const
+{
+    if (num_vertices == 0 || vertex_boxes.size() != num_vertices
+        || edge_boxes.size() != size_t(edges.rows())
+        || face_boxes.size() != size_t(faces.rows())
+        || inflation_radius != built_inflation_radius) {
+        return false;
+    }
+
+    for (size_t i = 0; i < edge_boxes.size(); i++) {
+        if (edge_boxes[i].vertex_ids[0] != edges(i, 0)
+            || edge_boxes[i].vertex_ids[1] != edges(i, 1)) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < face_boxes.size(); i++) {
+        if (face_boxes[i].vertex_ids[0] != faces(i, 0)
+            || face_boxes[i].vertex_ids[1] != faces(i, 1)
+            || face_boxes[i].vertex_ids[2] != faces(i, 2)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 // ============================================================================
 
 bool BroadPhase::can_edge_vertex_collide(size_t ei, size_t vi) const
@@ -44,7 +44,7 @@ public:
     /// @param faces Collision mesh faces
     /// @param inflation_radius Radius of inflation around all elements.
     virtual void build(
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         const double inflation_radius = 0);
@@ -56,8 +56,34 @@ public:
     /// @param faces Collision mesh faces
     /// @param inflation_radius Radius of inflation around all elements.
     virtual void build(
-        const Eigen::MatrixXd& vertices_t0,
-        const Eigen::MatrixXd& vertices_t1,
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        const double inflation_radius = 0);
+
+    /// @brief Update the broad phase for static collision detection with new vertex positions.
+    /// @note Backends reuse as much of the previously built structure as possible. Falls back to build() if the mesh connectivity or inflation radius changed since the last build.
+    /// @param vertices Vertex positions
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    virtual void update(
+        ConstRef<Eigen::MatrixXd> vertices,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        const double inflation_radius = 0);
+
+    /// @brief Update the broad phase for continuous collision detection with new vertex positions.
+    /// @note Backends reuse as much of the previously built structure as possible. Falls back to build() if the mesh connectivity or inflation radius changed since the last build.
+    /// @param vertices_t0 Starting vertices of the vertices.
+    /// @param vertices_t1 Ending vertices of the vertices.
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    virtual void update(
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         const double inflation_radius = 0);
@@ -65,6 +91,23 @@ public:
     /// @brief Clear any built data.
     virtual void clear();
 
+    /// @brief Get the method implemented by this broad phase.
+    /// @note Subclasses defined outside the toolkit report DEFAULT_BROAD_PHASE_METHOD unless they override this.
+    virtual BroadPhaseMethod method() const
+    {
+        return DEFAULT_BROAD_PHASE_METHOD;
+    }
+
+    /// @brief Get the broad phase used for the codim. stages of Candidates::build.
+    /// @note Created on first use by make_codim_broad_phase() and kept, so a persistent broad phase reuses it (and its settings) across builds.
+    BroadPhase& codim_broad_phase();
+
+    /// @brief Get the inflation radius of the last build (zero if the broad phase was never built).
+    double last_build_inflation_radius() const
+    {
+        return built_inflation_radius;
+    }
+
     /// @brief Find the candidate vertex-vertex collisions.
     /// @param[out] candidates The candidate vertex-vertex collisions.
     virtual void detect_vertex_vertex_candidates(
@@ -108,9 +151,31 @@ protected:
 
     static bool default_can_vertices_collide(size_t, size_t) { return true; }
 
+    /// @brief Create an empty broad phase with this one's settings for the codim. stages.
+    virtual std::shared_ptr<BroadPhase> make_codim_broad_phase() const;
+
+    /// @brief Check if the built boxes can be updated in place for the given mesh.
+    /// @param num_vertices Number of vertices in the new mesh.
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    /// @return True if the connectivity and inflation radius match the last build.
+    bool is_updatable(
+        const size_t num_vertices,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        const double inflation_radius) const;
+
     std::vector<AABB> vertex_boxes;
     std::vector<AABB> edge_boxes;
     std::vector<AABB> face_boxes;
+
+    /// @brief Inflation radius used to build the boxes.
+    double built_inflation_radius = 0;
+
+private:
+    /// @brief Lazily created broad phase for the codim. stages.
+    std::shared_ptr<BroadPhase> m_codim_broad_phase;
 };
 
 } // namespace ipc
@@ -6,6 +6,12 @@ namespace ipc {
 
 class BruteForce : public BroadPhase {
 public:
+    /// @brief Get the method implemented by this broad phase.
+    BroadPhaseMethod method() const override
+    {
+        return BroadPhaseMethod::BRUTE_FORCE;
+    }
+
     /// @brief Find the candidate vertex-vertex collisions.
     void detect_vertex_vertex_candidates(
         std::vector<VertexVertexCandidate>& candidates) const override;
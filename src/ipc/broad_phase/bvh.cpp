@@ -1,61 +1,140 @@
 #include "bvh.hpp"
 
+#include <ipc/utils/logger.hpp>
 #include <ipc/utils/merge_thread_local.hpp>
 
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_invoke.h>
 #include <tbb/blocked_range.h>
 #include <tbb/enumerable_thread_specific.h>
 
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+
 namespace ipc {
+
+namespace {
+    /// @brief Subtrees with more boxes than this are processed in parallel.
+    constexpr size_t PARALLEL_SUBTREE_SIZE = 1024;
+
+    double surface_area(const Eigen::Array3d& min, const Eigen::Array3d& max)
+    {
+        const Eigen::Array3d d = max - min;
+        return d.x() * d.y() + d.y() * d.z() + d.z() * d.x();
+    }
+
+    /// @brief Run the two calls in parallel if the subtree is large enough.
+    template <typename F, typename G>
+    void invoke(const size_t size, const F& f, const G& g)
+    {
+        if (size > PARALLEL_SUBTREE_SIZE) {
+            tbb::parallel_invoke(f, g);
+        } else {
+            f();
+            g();
+        }
+    }
+} // namespace
+
 void BVH::build(
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
     const double inflation_radius)
 {
     BroadPhase::build(vertices, edges, faces, inflation_radius);
-    init_bvh(vertex_boxes, vertex_bvh);
-    init_bvh(edge_boxes, edge_bvh);
-    init_bvh(face_boxes, face_bvh);
+    vertex_bvh.build(vertex_boxes);
+    edge_bvh.build(edge_boxes);
+    face_bvh.build(face_boxes);
 }
 
 void BVH::build(
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
     const double inflation_radius)
 {
     BroadPhase::build(vertices_t0, vertices_t1, edges, faces, inflation_radius);
-    init_bvh(vertex_boxes, vertex_bvh);
-    init_bvh(edge_boxes, edge_bvh);
-    init_bvh(face_boxes, face_bvh);
+    vertex_bvh.build(vertex_boxes);
+    edge_bvh.build(edge_boxes);
+    face_bvh.build(face_boxes);
+}
+
+void BVH::update(
+    ConstRef<Eigen::MatrixXd> vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    if (!is_updatable(vertices.rows(), edges, faces, inflation_radius)) {
+        build(vertices, edges, faces, inflation_radius);
+        return;
+    }
+
+    build_vertex_boxes(vertices, vertex_boxes, inflation_radius);
+    build_edge_boxes(vertex_boxes, edges, edge_boxes);
+    build_face_boxes(vertex_boxes, faces, face_boxes);
+    refit_trees();
 }
 
-void BVH::init_bvh(const std::vector<AABB>& boxes, SimpleBVH::BVH& bvh)
+void BVH::update(
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
 {
-    if (boxes.size() == 0)
+    if (!is_updatable(vertices_t0.rows(), edges, faces, inflation_radius)) {
+        build(vertices_t0, vertices_t1, edges, faces, inflation_radius);
         return;
+    }
+
+    build_vertex_boxes(
+        vertices_t0, vertices_t1, vertex_boxes, inflation_radius);
+    build_edge_boxes(vertex_boxes, edges, edge_boxes);
+    build_face_boxes(vertex_boxes, faces, face_boxes);
+    refit_trees();
+}
 
-    std::vector<std::array<Eigen::Vector3d, 2>> vector_boxes(boxes.size());
-    for (int i = 0; i < boxes.size(); i++) {
-        vector_boxes[i] = { { to_3D(boxes[i].min), to_3D(boxes[i].max) } };
+void BVH::refit_trees()
+{
+    num_rebuilt = 0;
+    for (const auto& [tree, boxes] :
+         { std::make_pair(&vertex_bvh, &vertex_boxes),
+           std::make_pair(&edge_bvh, &edge_boxes),
+           std::make_pair(&face_bvh, &face_boxes) }) {
+        tree->refit(*boxes);
+        num_rebuilt += tree->rebuild_degraded(*boxes, max_sah_cost_growth);
     }
 
-    bvh.init(vector_boxes);
+    logger().trace(
+        "BVH refit: rebuilt subtrees containing {:d} of {:d} boxes",
+        num_rebuilt, vertex_bvh.size() + edge_bvh.size() + face_bvh.size());
 }
 
 void BVH::clear()
 {
+    BroadPhase::clear();
     vertex_bvh.clear();
     edge_bvh.clear();
     face_bvh.clear();
+    num_rebuilt = 0;
+}
+
+std::shared_ptr<BroadPhase> BVH::make_codim_broad_phase() const
+{
+    auto bvh = std::make_shared<BVH>();
+    bvh->max_sah_cost_growth = max_sah_cost_growth;
+    return bvh;
 }
 
 template <typename Candidate, bool swap_order, bool triangular>
 void BVH::detect_candidates(
     const std::vector<AABB>& boxes,
-    const SimpleBVH::BVH& bvh,
+    const Tree& bvh,
     const std::function<bool(size_t, size_t)>& can_collide,
     std::vector<Candidate>& candidates)
 {
@@ -70,10 +149,11 @@ void BVH::detect_candidates(
         [&](const tbb::blocked_range<size_t>& r) {
             auto& local_candidates = storage.local();
 
+            std::vector<unsigned int> js;
             for (size_t i = r.begin(); i < r.end(); i++) {
-
-                std::vector<unsigned int> js;
-                bvh.intersect_box(boxes[i].min, boxes[i].max, js);
+                bvh.intersect_box(
+                    to_3D(boxes[i].min).array(), to_3D(boxes[i].max).array(),
+                    js);
 
                 for (const unsigned int j : js) {
                     int ai = i, bi = j;
@@ -167,4 +247,227 @@ void BVH::detect_edge_face_candidates(
         [&](size_t ei, size_t fi) { return can_edge_face_collide(ei, fi); },
         candidates);
 }
-} // namespace ipc
\ No newline at end of file
+
+// ============================================================================
+
+void BVH::Tree::build(const std::vector<AABB>& boxes)
+{
+    clear();
+    if (boxes.empty()) {
+        return;
+    }
+
+    order.resize(boxes.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    // The right child always holds at least as many boxes as the left one, so
+    // the largest node index lies along the right spine.
+    size_t num_nodes = 1;
+    for (size_t n = boxes.size(); n > 1; n -= n / 2) {
+        num_nodes = 2 * num_nodes + 1;
+    }
+    num_nodes++; // node indices start at 1
+
+    node_min.resize(num_nodes);
+    node_max.resize(num_nodes);
+    subtree_area.resize(num_nodes);
+    built_cost.resize(num_nodes);
+
+    build(boxes, 1, 0, boxes.size());
+}
+
+void BVH::Tree::build(
+    const std::vector<AABB>& boxes,
+    const size_t node,
+    const size_t begin,
+    const size_t end)
+{
+    assert(begin < end);
+    if (end - begin == 1) {
+        refit(boxes, node, begin, end);
+        built_cost[node] = 1;
+        return;
+    }
+
+    // Split at the median along the longest axis of the box centers.
+    Eigen::Array3d center_min =
+        Eigen::Array3d::Constant(std::numeric_limits<double>::infinity());
+    Eigen::Array3d center_max = -center_min;
+    for (size_t i = begin; i < end; i++) {
+        const AABB& box = boxes[order[i]];
+        const Eigen::Array3d center = to_3D(box.min + box.max).array();
+        center_min = center_min.min(center);
+        center_max = center_max.max(center);
+    }
+    int axis;
+    (center_max - center_min).maxCoeff(&axis);
+
+    const size_t mid = (begin + end) / 2;
+    std::nth_element(
+        order.begin() + begin, order.begin() + mid, order.begin() + end,
+        [&](const unsigned int a, const unsigned int b) {
+            return boxes[a].min[axis] + boxes[a].max[axis]
+                < boxes[b].min[axis] + boxes[b].max[axis];
+        });
+
+    const auto build_left = [&] {
+        build(boxes, 2 * node, begin, mid);
+    };
+    const auto build_right = [&] {
+        build(boxes, 2 * node + 1, mid, end);
+    };
+    invoke(end - begin, build_left, build_right);
+
+    node_min[node] = node_min[2 * node].min(node_min[2 * node + 1]);
+    node_max[node] = node_max[2 * node].max(node_max[2 * node + 1]);
+    const double area = surface_area(node_min[node], node_max[node]);
+    subtree_area[node] =
+        area + subtree_area[2 * node] + subtree_area[2 * node + 1];
+    built_cost[node] = area > 0 ? (subtree_area[node] / area) : 1;
+}
+
+void BVH::Tree::refit(const std::vector<AABB>& boxes)
+{
+    assert(boxes.size() == order.size());
+    if (!order.empty()) {
+        refit(boxes, 1, 0, order.size());
+    }
+}
+
+void BVH::Tree::refit(
+    const std::vector<AABB>& boxes,
+    const size_t node,
+    const size_t begin,
+    const size_t end)
+{
+    assert(begin < end);
+    if (end - begin == 1) {
+        const AABB& box = boxes[order[begin]];
+        node_min[node] = to_3D(box.min).array();
+        node_max[node] = to_3D(box.max).array();
+        subtree_area[node] = surface_area(node_min[node], node_max[node]);
+        return;
+    }
+
+    const size_t mid = (begin + end) / 2;
+    const auto refit_left = [&] {
+        refit(boxes, 2 * node, begin, mid);
+    };
+    const auto refit_right = [&] {
+        refit(boxes, 2 * node + 1, mid, end);
+    };
+    invoke(end - begin, refit_left, refit_right);
+
+    node_min[node] = node_min[2 * node].min(node_min[2 * node + 1]);
+    node_max[node] = node_max[2 * node].max(node_max[2 * node + 1]);
+    subtree_area[node] = surface_area(node_min[node], node_max[node])
+        + subtree_area[2 * node] + subtree_area[2 * node + 1];
+}
+
+size_t BVH::Tree::rebuild_degraded(
+    const std::vector<AABB>& boxes, const double max_cost_growth)
+{
+    assert(boxes.size() == order.size());
+    if (order.empty()) {
+        return 0;
+    }
+    return rebuild_degraded(boxes, max_cost_growth, 1, 0, order.size());
+}
+
+size_t BVH::Tree::rebuild_degraded(
+    const std::vector<AABB>& boxes,
+    const double max_cost_growth,
+    const size_t node,
+    const size_t begin,
+    const size_t end)
+{
+    if (end - begin <= 1) {
+        return 0;
+    }
+
+    const double area = surface_area(node_min[node], node_max[node]);
+    const double cost = area > 0 ? (subtree_area[node] / area) : 1;
+    if (cost > max_cost_growth * built_cost[node]) {
+        // The subtree holds the same boxes, so it can be rebuilt in place.
+        build(boxes, node, begin, end);
+        return end - begin;
+    }
+
+    const size_t mid = (begin + end) / 2;
+    size_t num_rebuilt_left = 0, num_rebuilt_right = 0;
+    const auto rebuild_left = [&] {
+        num_rebuilt_left =
+            rebuild_degraded(boxes, max_cost_growth, 2 * node, begin, mid);
+    };
+    const auto rebuild_right = [&] {
+        num_rebuilt_right =
+            rebuild_degraded(boxes, max_cost_growth, 2 * node + 1, mid, end);
+    };
+    invoke(end - begin, rebuild_left, rebuild_right);
+
+    if (num_rebuilt_left + num_rebuilt_right > 0) {
+        // The bounds are unchanged, but the children's areas may have shrunk.
+        subtree_area[node] =
+            area + subtree_area[2 * node] + subtree_area[2 * node + 1];
+    }
+    return num_rebuilt_left + num_rebuilt_right;
+}
+
+void BVH::Tree::intersect_box(
+    const Eigen::Array3d& min,
+    const Eigen::Array3d& max,
+    std::vector<unsigned int>& ids) const
+{
+    ids.clear();
+    if (order.empty()) {
+        return;
+    }
+
+    // Nodes split their boxes by count (not by position), so even degenerate
+    // inputs give a depth of ⌈log₂(n)⌉ ≤ 32 for n ≤ 2³² boxes. Each level
+    // leaves at most one pending sibling on the stack, so it never holds more
+    // than depth + 1 entries.
+    constexpr size_t MAX_STACK_SIZE = 64;
+    assert(order.size() <= size_t(std::numeric_limits<unsigned int>::max()));
+    std::array<std::array<size_t, 3>, MAX_STACK_SIZE> stack;
+    size_t stack_size = 0;
+    stack[stack_size++] = { { 1, 0, order.size() } };
+
+    while (stack_size > 0) {
+        const auto [node, begin, end] = stack[--stack_size];
+
+        if (!(node_min[node] <= max).all() || !(min <= node_max[node]).all()) {
+            continue;
+        }
+
+        if (end - begin == 1) {
+            ids.push_back(order[begin]);
+            continue;
+        }
+
+        const size_t mid = (begin + end) / 2;
+        assert(stack_size + 2 <= MAX_STACK_SIZE);
+        stack[stack_size++] = { { 2 * node + 1, mid, end } };
+        stack[stack_size++] = { { 2 * node, begin, mid } };
+    }
+}
+
+double BVH::Tree::sah_cost() const
+{
+    if (order.empty()) {
+        return 0;
+    }
+    const double area = surface_area(node_min[1], node_max[1]);
+    return area > 0 ? (subtree_area[1] / area) : 1;
+}
+
+void BVH::Tree::clear()
+{
+    node_min.clear();
+    node_max.clear();
+    subtree_area.clear();
+    built_cost.clear();
+    order.clear();
+}
+
+} // namespace ipc
@@ -2,7 +2,9 @@
 
 #include <ipc/broad_phase/broad_phase.hpp>
 
-#include <SimpleBVH/BVH.hpp>
+#include <Eigen/Core>
+
+#include <vector>
 
 namespace ipc {
 
@@ -14,7 +16,7 @@ public:
     /// @param faces Collision mesh faces
     /// @param inflation_radius Radius of inflation around all elements.
     void build(
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         const double inflation_radius = 0) override;
@@ -26,8 +28,34 @@ public:
     /// @param faces Collision mesh faces
     /// @param inflation_radius Radius of inflation around all elements.
     void build(
-        const Eigen::MatrixXd& vertices_t0,
-        const Eigen::MatrixXd& vertices_t1,
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        const double inflation_radius = 0) override;
+
+    /// @brief Update the broad phase for static collision detection.
+    /// @note Refits the existing trees and only rebuilds degraded subtrees.
+    /// @param vertices Vertex positions
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void update(
+        ConstRef<Eigen::MatrixXd> vertices,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        const double inflation_radius = 0) override;
+
+    /// @brief Update the broad phase for continuous collision detection.
+    /// @note Refits the existing trees and only rebuilds degraded subtrees.
+    /// @param vertices_t0 Starting vertices of the vertices.
+    /// @param vertices_t1 Ending vertices of the vertices.
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void update(
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         const double inflation_radius = 0) override;
@@ -35,6 +63,12 @@ public:
     /// @brief Clear any built data.
     void clear() override;
 
+    /// @brief Get the method implemented by this broad phase.
+    BroadPhaseMethod method() const override
+    {
+        return BroadPhaseMethod::BVH;
+    }
+
     /// @brief Find the candidate vertex-vertex collisions.
     /// @param[out] candidates The candidate vertex-vertex collisions.
     void detect_vertex_vertex_candidates(
@@ -60,8 +94,86 @@ public:
     void detect_edge_face_candidates(
         std::vector<EdgeFaceCandidate>& candidates) const override;
 
+    /// @brief Get the number of boxes rebuilt by the last update.
+    size_t last_update_num_rebuilt() const { return num_rebuilt; }
+
+    /// @brief Maximum growth of a subtree's SAH cost before it is rebuilt.
+    double max_sah_cost_growth = 1.5;
+
 protected:
-    static void init_bvh(const std::vector<AABB>& boxes, SimpleBVH::BVH& bvh);
+    /// @brief Binary AABB tree over a list of boxes that can be refit.
+    ///
+    /// Nodes are stored in heap order (the children of node n are 2n and
+    /// 2n+1, the root is 1) and each node splits its boxes at the median, so
+    /// the topology only depends on the number of boxes. This lets a subtree
+    /// be rebuilt in place without touching the rest of the tree.
+    class Tree {
+    public:
+        /// @brief Build the tree from scratch.
+        /// @param boxes Boxes to store in the tree.
+        void build(const std::vector<AABB>& boxes);
+
+        /// @brief Recompute the node bounds bottom-up, keeping the topology.
+        /// @param boxes Boxes to store in the tree (same size as the build).
+        void refit(const std::vector<AABB>& boxes);
+
+        /// @brief Rebuild every subtree whose SAH cost grew too much since it was built.
+        /// @note Assumes refit() was called with the same boxes.
+        /// @param boxes Boxes stored in the tree.
+        /// @param max_cost_growth Maximum allowed ratio of current to built SAH cost.
+        /// @return Number of boxes in the rebuilt subtrees.
+        size_t rebuild_degraded(
+            const std::vector<AABB>& boxes, const double max_cost_growth);
+
+        /// @brief Find the ids of all boxes intersecting a query box.
+        /// @param[in] min Minimum corner of the query box.
+        /// @param[in] max Maximum corner of the query box.
+        /// @param[out] ids Ids of the intersecting boxes.
+        void intersect_box(
+            const Eigen::Array3d& min,
+            const Eigen::Array3d& max,
+            std::vector<unsigned int>& ids) const;
+
+        /// @brief Current SAH cost of the tree (normalized by the root area).
+        double sah_cost() const;
+
+        /// @brief Number of boxes stored in the tree.
+        size_t size() const { return order.size(); }
+
+        /// @brief Clear the tree.
+        void clear();
+
+    protected:
+        void build(
+            const std::vector<AABB>& boxes,
+            const size_t node,
+            const size_t begin,
+            const size_t end);
+
+        void refit(
+            const std::vector<AABB>& boxes,
+            const size_t node,
+            const size_t begin,
+            const size_t end);
+
+        size_t rebuild_degraded(
+            const std::vector<AABB>& boxes,
+            const double max_cost_growth,
+            const size_t node,
+            const size_t begin,
+            const size_t end);
+
+        /// @brief Minimum corner of each node.
+        std::vector<Eigen::Array3d> node_min;
+        /// @brief Maximum corner of each node.
+        std::vector<Eigen::Array3d> node_max;
+        /// @brief Sum of the surface areas of the nodes in each subtree.
+        std::vector<double> subtree_area;
+        /// @brief SAH cost of each subtree when it was last built.
+        std::vector<double> built_cost;
+        /// @brief Box ids in leaf order.
+        std::vector<unsigned int> order;
+    };
 
     template <
         typename Candidate,
@@ -69,13 +181,22 @@ protected:
         bool triangular = false>
     static void detect_candidates(
         const std::vector<AABB>& boxes,
-        const SimpleBVH::BVH& bvh,
+        const Tree& bvh,
         const std::function<bool(size_t, size_t)>& can_collide,
         std::vector<Candidate>& candidates);
 
-    SimpleBVH::BVH vertex_bvh;
-    SimpleBVH::BVH edge_bvh;
-    SimpleBVH::BVH face_bvh;
+    /// @brief Refit the trees to the current boxes and rebuild degraded subtrees.
+    void refit_trees();
+
+    /// @brief Create an empty BVH with the same rebuild threshold.
+    std::shared_ptr<BroadPhase> make_codim_broad_phase() const override;
+
+    Tree vertex_bvh;
+    Tree edge_bvh;
+    Tree face_bvh;
+
+    /// @brief Number of boxes in the subtrees rebuilt by the last update.
+    size_t num_rebuilt = 0;
 };
 
 } // namespace ipc
\ No newline at end of file
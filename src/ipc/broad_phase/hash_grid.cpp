@@ -5,18 +5,168 @@
 #include <ipc/utils/logger.hpp>
 
 #include <tbb/enumerable_thread_specific.h>
-#include <tbb/blocked_range2d.h>
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_scan.h>
 #include <tbb/parallel_sort.h>
 
 #include <algorithm> // std::min/max
+#include <functional>
+#include <iterator>
+#include <limits>
 
 #define IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE // else use unordered_set
 
 namespace ipc {
 
+namespace {
+    /// @brief Number of bits per axis of a 3D Morton code.
+    constexpr int MORTON_BITS_3D = 21;
+    /// @brief Number of bits per axis of a 2D Morton code.
+    constexpr int MORTON_BITS_2D = 32;
+
+    /// @brief Spread the low 21 bits of x so there are two zeros between bits.
+    inline uint64_t spread_bits_3d(uint64_t x)
+    {
+        x &= 0x1fffff;
+        x = (x | x << 32) & 0x1f00000000ffff;
+        x = (x | x << 16) & 0x1f0000ff0000ff;
+        x = (x | x << 8) & 0x100f00f00f00f00f;
+        x = (x | x << 4) & 0x10c30c30c30c30c3;
+        x = (x | x << 2) & 0x1249249249249249;
+        return x;
+    }
+
+    /// @brief Spread the low 32 bits of x so there is one zero between bits.
+    inline uint64_t spread_bits_2d(uint64_t x)
+    {
+        x &= 0xffffffff;
+        x = (x | x << 16) & 0x0000ffff0000ffff;
+        x = (x | x << 8) & 0x00ff00ff00ff00ff;
+        x = (x | x << 4) & 0x0f0f0f0f0f0f0f0f;
+        x = (x | x << 2) & 0x3333333333333333;
+        x = (x | x << 1) & 0x5555555555555555;
+        return x;
+    }
+
+    /// @brief Convert cell coordinates to integers without overflowing.
+    inline ArrayMax3<int64_t> to_cell(const ArrayMax3d& x)
+    {
+        // Beyond 2⁶² cells the Morton code has long since wrapped around.
+        constexpr double max_cell = double(int64_t(1) << 62);
+        return x.floor().max(-max_cell).min(max_cell).cast<int64_t>();
+    }
+
+    /// @brief Maximum number of item pairs in one block of work.
+    constexpr size_t MAX_BLOCK_PAIRS = 4096;
+
+    /// @brief Items [row_begin, row_end) of a cell to pair with the items
+    /// [col_begin, col_end) of the same cell.
+    struct CellBlock {
+        size_t row_begin, row_end;
+        size_t col_begin, col_end;
+    };
+
+    /// @brief Concatenate in order the outputs of fill(i) for i ∈ [0, n).
+    /// @param n Number of inputs.
+    /// @param count Function returning the number of outputs of input i.
+    /// @param fill Function writing the outputs of input i to an iterator.
+    /// @return The concatenated outputs.
+    template <typename T, typename Count, typename Fill>
+    std::vector<T> parallel_concatenate(size_t n, Count count, Fill fill)
+    {
+        std::vector<size_t> offsets(n + 1, 0);
+        tbb::parallel_scan(
+            tbb::blocked_range<size_t>(size_t(0), n), size_t(0),
+            [&](const tbb::blocked_range<size_t>& r, size_t sum,
+                const bool is_final_scan) {
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    sum += count(i);
+                    if (is_final_scan) {
+                        offsets[i + 1] = sum;
+                    }
+                }
+                return sum;
+            },
+            std::plus<size_t>());
+
+        std::vector<T> out(offsets.back());
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), n),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    if (offsets[i] != offsets[i + 1]) {
+                        fill(i, out.begin() + offsets[i]);
+                    }
+                }
+            });
+        return out;
+    }
+
+    /// @brief Find the runs of sorted items with equal keys.
+    /// @param items Items sorted by key.
+    /// @return The start of each run followed by items.size().
+    std::vector<size_t> find_runs(const std::vector<HashItem>& items)
+    {
+        const auto is_run_start = [&](size_t i) {
+            return i == 0 || items[i].key != items[i - 1].key;
+        };
+        std::vector<size_t> runs = parallel_concatenate<size_t>(
+            items.size(), is_run_start,
+            [](size_t i, std::vector<size_t>::iterator out) { *out = i; });
+        runs.push_back(items.size());
+        return runs;
+    }
+
+    /// @brief Call f(row_begin, row_end) for each block of rows of a cell.
+    /// @note Rows are grouped so a block has about MAX_BLOCK_PAIRS pairs.
+    /// @param cell The rows and columns of the cell.
+    /// @param is_self If row i is only paired with the columns after i.
+    template <typename F>
+    void for_each_row_block(const CellBlock& cell, const bool is_self, F f)
+    {
+        size_t block_begin = cell.row_begin, num_pairs = 0;
+        for (size_t i = cell.row_begin; i < cell.row_end; i++) {
+            num_pairs += cell.col_end
+                - (is_self ? std::max(i + 1, cell.col_begin) : cell.col_begin);
+            if (num_pairs >= MAX_BLOCK_PAIRS) {
+                f(block_begin, i + 1);
+                block_begin = i + 1;
+                num_pairs = 0;
+            }
+        }
+        if (num_pairs > 0) {
+            f(block_begin, cell.row_end);
+        }
+    }
+
+    /// @brief Split the pairs of each cell into blocks of bounded work.
+    /// @param cells The rows and columns of each cell.
+    /// @param is_self If row i is only paired with the columns after i.
+    /// @return The blocks of all cells.
+    std::vector<CellBlock>
+    split_cells(const std::vector<CellBlock>& cells, const bool is_self)
+    {
+        return parallel_concatenate<CellBlock>(
+            cells.size(),
+            [&](size_t i) {
+                size_t num_blocks = 0;
+                for_each_row_block(
+                    cells[i], is_self, [&](size_t, size_t) { num_blocks++; });
+                return num_blocks;
+            },
+            [&](size_t i, std::vector<CellBlock>::iterator out) {
+                const CellBlock& cell = cells[i];
+                for_each_row_block(
+                    cell, is_self, [&](size_t row_begin, size_t row_end) {
+                        *out++ = { row_begin, row_end, cell.col_begin,
+                                   cell.col_end };
+                    });
+            });
+    }
+} // namespace
+
 void HashGrid::build(
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
     const double inflation_radius)
@@ -37,8 +187,8 @@ void HashGrid::build(
 }
 
 void HashGrid::build(
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
     const double inflation_radius)
@@ -63,6 +213,150 @@ void HashGrid::build(
     insert_boxes();
 }
 
+void HashGrid::update(
+    ConstRef<Eigen::MatrixXd> vertices,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    if (!is_updatable(vertices.rows(), edges, faces, inflation_radius)) {
+        build(vertices, edges, faces, inflation_radius);
+        return;
+    }
+
+    ArrayMax3d mesh_min = vertices.colwise().minCoeff().array();
+    ArrayMax3d mesh_max = vertices.colwise().maxCoeff().array();
+    AABB::conservative_inflation(mesh_min, mesh_max, inflation_radius);
+
+    // The grid must still cover the whole mesh.
+    if (!m_use_sparse_domain
+        && ((mesh_min < m_domainMin).any() || (mesh_max > m_domainMax).any())) {
+        build(vertices, edges, faces, inflation_radius);
+        return;
+    }
+
+    std::vector<AABB> new_vertex_boxes, new_edge_boxes, new_face_boxes;
+    build_vertex_boxes(vertices, new_vertex_boxes, inflation_radius);
+    build_edge_boxes(new_vertex_boxes, edges, new_edge_boxes);
+    build_face_boxes(new_vertex_boxes, faces, new_face_boxes);
+
+    update_boxes(new_vertex_boxes, new_edge_boxes, new_face_boxes);
+}
+
+void HashGrid::update(
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const double inflation_radius)
+{
+    if (!is_updatable(vertices_t0.rows(), edges, faces, inflation_radius)) {
+        build(vertices_t0, vertices_t1, edges, faces, inflation_radius);
+        return;
+    }
+
+    const ArrayMax3d mesh_min_t0 = vertices_t0.colwise().minCoeff();
+    const ArrayMax3d mesh_max_t0 = vertices_t0.colwise().maxCoeff();
+    const ArrayMax3d mesh_min_t1 = vertices_t1.colwise().minCoeff();
+    const ArrayMax3d mesh_max_t1 = vertices_t1.colwise().maxCoeff();
+
+    ArrayMax3d mesh_min = mesh_min_t0.min(mesh_min_t1);
+    ArrayMax3d mesh_max = mesh_max_t0.max(mesh_max_t1);
+    AABB::conservative_inflation(mesh_min, mesh_max, inflation_radius);
+
+    // The grid must still cover the whole mesh.
+    if (!m_use_sparse_domain
+        && ((mesh_min < m_domainMin).any() || (mesh_max > m_domainMax).any())) {
+        build(vertices_t0, vertices_t1, edges, faces, inflation_radius);
+        return;
+    }
+
+    std::vector<AABB> new_vertex_boxes, new_edge_boxes, new_face_boxes;
+    build_vertex_boxes(
+        vertices_t0, vertices_t1, new_vertex_boxes, inflation_radius);
+    build_edge_boxes(new_vertex_boxes, edges, new_edge_boxes);
+    build_face_boxes(new_vertex_boxes, faces, new_face_boxes);
+
+    update_boxes(new_vertex_boxes, new_edge_boxes, new_face_boxes);
+}
+
+void HashGrid::update_boxes(
+    std::vector<AABB>& new_vertex_boxes,
+    std::vector<AABB>& new_edge_boxes,
+    std::vector<AABB>& new_face_boxes)
+{
+    size_t num_updated = 0;
+    num_updated += update_items(vertex_boxes, new_vertex_boxes, vertex_items);
+    num_updated += update_items(edge_boxes, new_edge_boxes, edge_items);
+    num_updated += update_items(face_boxes, new_face_boxes, face_items);
+
+    logger().trace(
+        "hash-grid updated {:d} of {:d} boxes", num_updated,
+        new_vertex_boxes.size() + new_edge_boxes.size()
+            + new_face_boxes.size());
+
+    vertex_boxes.swap(new_vertex_boxes);
+    edge_boxes.swap(new_edge_boxes);
+    face_boxes.swap(new_face_boxes);
+}
+
+size_t HashGrid::update_items(
+    const std::vector<AABB>& old_boxes,
+    const std::vector<AABB>& new_boxes,
+    std::vector<HashItem>& items) const
+{
+    assert(old_boxes.size() == new_boxes.size());
+
+    // 1. Find the boxes whose range of cells changed
+    std::vector<char> is_moved(new_boxes.size(), false);
+    tbb::enumerable_thread_specific<std::vector<HashItem>> storage;
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0l, long(new_boxes.size())),
+        [&](const tbb::blocked_range<long>& range) {
+            auto& local_items = storage.local();
+            ArrayMax3<int64_t> old_min, old_max, new_min, new_max;
+            for (long i = range.begin(); i != range.end(); i++) {
+                cell_range(old_boxes[i], old_min, old_max);
+                cell_range(new_boxes[i], new_min, new_max);
+                if ((old_min != new_min).any() || (old_max != new_max).any()) {
+                    is_moved[i] = true;
+                    insert_box(new_boxes[i], i, local_items);
+                }
+            }
+        });
+
+    std::vector<HashItem> new_items;
+    merge_thread_local_vectors(storage, new_items);
+    if (new_items.empty()) {
+        return 0;
+    }
+    tbb::parallel_sort(new_items.begin(), new_items.end());
+
+    // 2. Remove the stale items (the remaining items stay sorted)
+    items.erase(
+        std::remove_if(
+            items.begin(), items.end(),
+            [&](const HashItem& item) { return is_moved[item.id]; }),
+        items.end());
+
+    // 3. Merge the re-binned items into the sorted items
+    std::vector<HashItem> merged_items;
+    merged_items.reserve(items.size() + new_items.size());
+    std::merge(
+        items.begin(), items.end(), new_items.begin(), new_items.end(),
+        std::back_inserter(merged_items));
+    items.swap(merged_items);
+
+    return std::count(is_moved.begin(), is_moved.end(), true);
+}
+
+std::shared_ptr<BroadPhase> HashGrid::make_codim_broad_phase() const
+{
+    auto hash_grid = std::make_shared<HashGrid>();
+    hash_grid->set_use_sparse_domain(m_use_sparse_domain);
+    return hash_grid;
+}
+
 void HashGrid::resize(
     const ArrayMax3d& min, const ArrayMax3d& max, double cellSize)
 {
@@ -71,10 +365,34 @@ void HashGrid::resize(
     m_cellSize = cellSize;
     m_domainMin = min;
     m_domainMax = max;
-    m_gridSize = ((max - min) / m_cellSize).ceil().cast<int>().max(1);
+    m_gridSize = ((max - min) / m_cellSize)
+                     .ceil()
+                     .min(std::numeric_limits<int>::max())
+                     .cast<int>()
+                     .max(1);
     logger().trace(
         "hash-grid resized with a size of {:d}x{:d}x{:d}", m_gridSize[0],
         m_gridSize[1], m_gridSize.size() == 3 ? m_gridSize[2] : 1);
+
+    const int bits = m_gridSize.size() == 3 ? MORTON_BITS_3D : MORTON_BITS_2D;
+    if ((m_gridSize.cast<int64_t>() > (int64_t(1) << bits)).any()) {
+        logger().trace("hash-grid keys wrap around; expect extra candidates");
+    }
+}
+
+uint64_t HashGrid::hash(int64_t x, int64_t y, int64_t z) const
+{
+    assert(
+        m_use_sparse_domain
+        || (x >= 0 && y >= 0 && z >= 0 && x < m_gridSize[0]
+            && y < m_gridSize[1]
+            && (m_gridSize.size() == 2 || z < m_gridSize[2])));
+    // Negative coordinates wrap around through the two's complement bits.
+    if (m_gridSize.size() == 2) {
+        return spread_bits_2d(uint64_t(x)) | (spread_bits_2d(uint64_t(y)) << 1);
+    }
+    return spread_bits_3d(uint64_t(x)) | (spread_bits_3d(uint64_t(y)) << 1)
+        | (spread_bits_3d(uint64_t(z)) << 2);
 }
 
 void HashGrid::insert_boxes()
@@ -105,26 +423,37 @@ void HashGrid::insert_boxes(
     tbb::parallel_sort(items.begin(), items.end());
 }
 
-void HashGrid::insert_box(
-    const AABB& aabb, const long id, std::vector<HashItem>& items) const
+void HashGrid::cell_range(
+    const AABB& aabb,
+    ArrayMax3<int64_t>& int_min,
+    ArrayMax3<int64_t>& int_max) const
 {
-    ArrayMax3i int_min = ((aabb.min - m_domainMin) / m_cellSize).cast<int>();
-    // We can round down to -1, but not less
-    assert((int_min >= -1).all());
-    assert((int_min <= m_gridSize).all());
-    int_min = int_min.max(0).min(m_gridSize - 1);
-
-    ArrayMax3i int_max = ((aabb.max - m_domainMin) / m_cellSize).cast<int>();
-    assert((int_max >= -1).all());
-    assert((int_max <= m_gridSize).all());
-    int_max = int_max.max(0).min(m_gridSize - 1);
+    int_min = to_cell((aabb.min - m_domainMin) / m_cellSize);
+    int_max = to_cell((aabb.max - m_domainMin) / m_cellSize);
+
+    if (!m_use_sparse_domain) {
+        const ArrayMax3<int64_t> grid_max = m_gridSize.cast<int64_t>() - 1;
+        // We can round down to -1, but not less
+        assert((int_min >= -1).all() && (int_max >= -1).all());
+        assert((int_min <= grid_max + 1).all());
+        assert((int_max <= grid_max + 1).all());
+        int_min = int_min.max(0).min(grid_max);
+        int_max = int_max.max(0).min(grid_max);
+    }
     assert((int_min <= int_max).all());
+}
 
-    int min_z = int_min.size() == 3 ? int_min.z() : 0;
-    int max_z = int_max.size() == 3 ? int_max.z() : 0;
-    for (int x = int_min.x(); x <= int_max.x(); ++x) {
-        for (int y = int_min.y(); y <= int_max.y(); ++y) {
-            for (int z = min_z; z <= max_z; ++z) {
+void HashGrid::insert_box(
+    const AABB& aabb, const long id, std::vector<HashItem>& items) const
+{
+    ArrayMax3<int64_t> int_min, int_max;
+    cell_range(aabb, int_min, int_max);
+
+    const int64_t min_z = int_min.size() == 3 ? int_min.z() : 0;
+    const int64_t max_z = int_max.size() == 3 ? int_max.z() : 0;
+    for (int64_t x = int_min.x(); x <= int_max.x(); ++x) {
+        for (int64_t y = int_min.y(); y <= int_max.y(); ++y) {
+            for (int64_t z = min_z; z <= max_z; ++z) {
                 items.emplace_back(hash(x, y, z), id);
             }
         }
@@ -142,36 +471,34 @@ void HashGrid::detect_candidates(
 {
     // Entries with the same key means they share a cell (that cell index
     // hashes to the same key) and should be flagged for low-level intersection
-    // testing. We loop over the entire sorted set of (key,value) pairs
-    // creating Candidate entries for pairs with the same key
+    // testing. The sorted items are split into runs of equal keys, and every
+    // item of a run in items0 is paired with the matching run in items1.
+
+    // 1. Match the runs of equal keys (assuming items are sorted)
+    const std::vector<size_t> runs0 = find_runs(items0);
+    const std::vector<size_t> runs1 = find_runs(items1);
+
+    const auto find_run1 = [&](size_t r0) -> size_t {
+        const uint64_t key = items0[runs0[r0]].key;
+        const auto it = std::lower_bound(
+            runs1.begin(), runs1.end() - 1, key,
+            [&](size_t i, uint64_t k) { return items1[i].key < k; });
+        return it != runs1.end() - 1 && items1[*it].key == key
+            ? size_t(it - runs1.begin())
+            : runs1.size();
+    };
 
-    // 1. Soft merge of items (assuming items are sorted)
-    size_t num_items = items0.size() + items1.size();
-    std::vector<long> merged_item_indices;
-    merged_item_indices.reserve(num_items);
-    {
-        long i = 0, j = 0;
-        while (i < items0.size() && j < items1.size()) {
-            if (items0[i] < items1[j]) {
-                merged_item_indices.push_back(-(i++) - 1);
-            } else {
-                merged_item_indices.push_back(j++);
-            }
-        }
-        while (i < items0.size()) {
-            merged_item_indices.push_back(-(i++) - 1);
-        }
-        while (j < items1.size()) {
-            merged_item_indices.push_back(j++);
-        }
-    }
-    assert(merged_item_indices.size() == num_items);
+    const std::vector<CellBlock> cells = parallel_concatenate<CellBlock>(
+        runs0.size() - 1,
+        [&](size_t r0) { return size_t(find_run1(r0) < runs1.size()); },
+        [&](size_t r0, std::vector<CellBlock>::iterator out) {
+            const size_t r1 = find_run1(r0);
+            *out = { runs0[r0], runs0[r0 + 1], runs1[r1], runs1[r1 + 1] };
+        });
 
-    const auto get_item = [&](long i) -> const HashItem& {
-        return i < 0 ? items0[-(i + 1)] : items1[i];
-    };
+    // 2. Enumerate hash collisions in blocks of bounded work
+    const std::vector<CellBlock> blocks = split_cells(cells, false);
 
-    // 2. Enumerate hash collisions
 #ifdef IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE
     tbb::enumerable_thread_specific<std::vector<Candidate>> storage;
 #else
@@ -179,56 +506,39 @@ void HashGrid::detect_candidates(
 #endif
 
     tbb::parallel_for(
-        tbb::blocked_range2d<long>(0l, num_items - 1, 0l, num_items),
-        [&](const tbb::blocked_range2d<long>& r) {
+        tbb::blocked_range<size_t>(size_t(0), blocks.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
             auto& local_candidates = storage.local();
 
-            // i < j
-            long i_end = std::min(r.rows().end(), r.cols().end());
-            for (long i = r.rows().begin(); i < i_end; i++) {
-                const long idx0 = merged_item_indices[i];
-                const HashItem& item0 = get_item(idx0);
-
-                // i < r.cols().end() → i + 1 <= r.cols().end()
-                long j_begin = std::max(i + 1, r.cols().begin());
-                for (long j = j_begin; j < r.cols().end(); j++) {
-                    const long idx1 = merged_item_indices[j];
-                    const HashItem& item1 = get_item(idx1);
-
-                    if (item0.key != item1.key) {
-                        break; // This avoids a brute force comparison
-                    }
+            for (size_t b = r.begin(); b < r.end(); b++) {
+                const CellBlock& block = blocks[b];
+                for (size_t i = block.row_begin; i < block.row_end; i++) {
+                    const long id0 = items0[i].id;
+                    assert(id0 < boxes0.size());
 
-                    long id0 = item0.id, id1 = item1.id;
-                    if (idx0 >= 0 && idx1 < 0) {
-                        std::swap(id0, id1);
-                    } else if (idx0 >= 0 || idx1 < 0) {
-                        continue;
-                    }
-                    assert(id0 < boxes0.size() && id1 < boxes1.size());
+                    for (size_t j = block.col_begin; j < block.col_end; j++) {
+                        const long id1 = items1[j].id;
+                        assert(id1 < boxes1.size());
 
-                    if (!can_collide(id0, id1)) {
-                        continue;
-                    }
+                        if (!can_collide(id0, id1)) {
+                            continue;
+                        }
 
-                    if (boxes0[id0].intersects(boxes1[id1])) {
+                        if (boxes0[id0].intersects(boxes1[id1])) {
 #ifdef IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE
-                        local_candidates.emplace_back(id0, id1);
+                            local_candidates.emplace_back(id0, id1);
 #else
-                        local_candidates.emplace(id0, id1);
+                            local_candidates.emplace(id0, id1);
 #endif
+                        }
                     }
                 }
             }
         });
 
 #ifdef IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE
-    merge_thread_local_vectors(storage, candidates);
-
     // Remove the duplicate candidates
-    tbb::parallel_sort(candidates.begin(), candidates.end());
-    auto new_end = std::unique(candidates.begin(), candidates.end());
-    candidates.erase(new_end, candidates.end());
+    merge_thread_local_vectors_unique(storage, candidates);
 #else
     unordered_set<Candidate> candidates_set;
     merge_thread_local_unordered_sets(storage, candidates_set);
@@ -248,8 +558,21 @@ void HashGrid::detect_candidates(
 {
     // Entries with the same key means they share a cell (that cell index
     // hashes to the same key) and should be flagged for low-level
-    // intersection testing. So we loop over the entire sorted set of
-    // (key,value) pairs creating Candidate entries for pairs with the same key
+    // intersection testing. So we split the sorted set of (key,value) pairs
+    // into runs of equal keys and pair up the items within each run.
+
+    // 1. Find the runs of equal keys with at least two items
+    const std::vector<size_t> runs = find_runs(items);
+
+    const auto run_size = [&](size_t r) { return runs[r + 1] - runs[r]; };
+    const std::vector<CellBlock> cells = parallel_concatenate<CellBlock>(
+        runs.size() - 1, [&](size_t r) { return size_t(run_size(r) > 1); },
+        [&](size_t r, std::vector<CellBlock>::iterator out) {
+            *out = { runs[r], runs[r + 1], runs[r], runs[r + 1] };
+        });
+
+    // 2. Enumerate hash collisions in blocks of bounded work
+    const std::vector<CellBlock> blocks = split_cells(cells, true);
 
 #ifdef IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE
     tbb::enumerable_thread_specific<std::vector<Candidate>> storage;
@@ -258,49 +581,41 @@ void HashGrid::detect_candidates(
 #endif
 
     tbb::parallel_for(
-        tbb::blocked_range2d<long>(0l, items.size() - 1, 0l, items.size()),
-        [&](const tbb::blocked_range2d<long>& r) {
+        tbb::blocked_range<size_t>(size_t(0), blocks.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
             auto& local_candidates = storage.local();
 
-            // i < j
-            long i_end = std::min(r.rows().end(), r.cols().end());
-            for (long i = r.rows().begin(); i < i_end; i++) {
-                const HashItem& item0 = items[i];
-                const AABB& box0 = boxes[item0.id];
+            for (size_t b = r.begin(); b < r.end(); b++) {
+                const CellBlock& block = blocks[b];
+                // i < j
+                for (size_t i = block.row_begin; i < block.row_end; i++) {
+                    const HashItem& item0 = items[i];
+                    const AABB& box0 = boxes[item0.id];
 
-                // i < r.cols().end() → i + 1 <= r.cols().end()
-                long j_begin = std::max(i + 1, r.cols().begin());
-                assert(j_begin > i);
-                for (long j = j_begin; j < r.cols().end(); j++) {
-                    const HashItem& item1 = items[j];
+                    for (size_t j = std::max(i + 1, block.col_begin);
+                         j < block.col_end; j++) {
+                        const HashItem& item1 = items[j];
 
-                    if (item0.key != item1.key) {
-                        break; // This avoids a brute force comparison
-                    }
+                        if (!can_collide(item0.id, item1.id)) {
+                            continue;
+                        }
 
-                    if (!can_collide(item0.id, item1.id)) {
-                        continue;
-                    }
-
-                    const AABB& box1 = boxes[item1.id];
-                    if (box0.intersects(box1)) {
+                        const AABB& box1 = boxes[item1.id];
+                        if (box0.intersects(box1)) {
 #ifdef IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE
-                        local_candidates.emplace_back(item0.id, item1.id);
+                            local_candidates.emplace_back(item0.id, item1.id);
 #else
-                        local_candidates.emplace(item0.id, item1.id);
+                            local_candidates.emplace(item0.id, item1.id);
 #endif
+                        }
                     }
                 }
             }
         });
 
 #ifdef IPC_TOOLKIT_HASH_GRID_USE_SORT_UNIQUE
-    merge_thread_local_vectors(storage, candidates);
-
     // Remove the duplicate candidates
-    tbb::parallel_sort(candidates.begin(), candidates.end());
-    auto new_end = std::unique(candidates.begin(), candidates.end());
-    candidates.erase(new_end, candidates.end());
+    merge_thread_local_vectors_unique(storage, candidates);
 #else
     unordered_set<Candidate> candidates_set;
     merge_thread_local_unordered_sets(storage, candidates_set);
@@ -2,17 +2,19 @@
 
 #include <ipc/broad_phase/broad_phase.hpp>
 
+#include <cstdint>
+
 namespace ipc {
 
 /// @brief An entry into the hash grid as a (key, value) pair.
 struct HashItem {
     /// @brief The key of the item.
-    long key;
+    uint64_t key;
     /// @brief The value of the item.
     long id;
 
     /// @brief Construct a hash item as a (key, value) pair.
-    HashItem(int _key, int _id) : key(_key), id(_id) { }
+    HashItem(uint64_t _key, long _id) : key(_key), id(_id) { }
 
     /// @brief Compare HashItems by their keys for sorting.
     bool operator<(const HashItem& other) const
@@ -24,6 +26,13 @@ struct HashItem {
     }
 };
 
+/// @brief A broad phase that bins elements into the cells of a uniform grid.
+///
+/// Cells are keyed by the 64-bit Morton (Z-order) code of their integer
+/// coordinates, so sorting the items keeps neighboring cells close in memory.
+/// Keys are exact for grids of up to 2²¹ cells per axis in 3D (2³² in 2D);
+/// larger grids wrap around, which only adds candidates that are then
+/// rejected by the box test.
 class HashGrid : public BroadPhase {
 public:
     /// @brief Build the broad phase for static collision detection.
@@ -32,7 +41,7 @@ public:
     /// @param faces Collision mesh faces
     /// @param inflation_radius Radius of inflation around all elements.
     void build(
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         double inflation_radius = 0) override;
@@ -44,8 +53,34 @@ public:
     /// @param faces Collision mesh faces
     /// @param inflation_radius Radius of inflation around all elements.
     void build(
-        const Eigen::MatrixXd& vertices_t0,
-        const Eigen::MatrixXd& vertices_t1,
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        double inflation_radius = 0) override;
+
+    /// @brief Update the hash grid for static collision detection.
+    /// @note Only elements whose set of occupied cells changed are re-binned.
+    /// @param vertices Vertex positions
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void update(
+        ConstRef<Eigen::MatrixXd> vertices,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        double inflation_radius = 0) override;
+
+    /// @brief Update the hash grid for continuous collision detection.
+    /// @note Only elements whose set of occupied cells changed are re-binned.
+    /// @param vertices_t0 Starting vertices of the vertices.
+    /// @param vertices_t1 Ending vertices of the vertices.
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void update(
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         double inflation_radius = 0) override;
@@ -59,6 +94,12 @@ public:
         face_items.clear();
     }
 
+    /// @brief Get the method implemented by this broad phase.
+    BroadPhaseMethod method() const override
+    {
+        return BroadPhaseMethod::HASH_GRID;
+    }
+
     /// @brief Find the candidate vertex-vertex collisions.
     void detect_vertex_vertex_candidates(
         std::vector<VertexVertexCandidate>& candidates) const override;
@@ -83,6 +124,21 @@ public:
     void detect_edge_face_candidates(
         std::vector<EdgeFaceCandidate>& candidates) const override;
 
+    /// @brief Get if the grid is unbounded (see set_use_sparse_domain).
+    bool use_sparse_domain() const { return m_use_sparse_domain; }
+
+    /// @brief Set if the grid should be unbounded.
+    ///
+    /// In sparse-domain mode cells are not clamped to the domain of the mesh
+    /// and update() does not rebuild when the mesh leaves it. Only occupied
+    /// cells are stored, so this suits scenes with widely separated objects.
+    /// @note Takes effect on the next build.
+    /// @param use_sparse_domain If the grid should be unbounded.
+    void set_use_sparse_domain(bool use_sparse_domain)
+    {
+        m_use_sparse_domain = use_sparse_domain;
+    }
+
     double cellSize() const { return m_cellSize; }
     const ArrayMax3i& gridSize() const { return m_gridSize; }
     const ArrayMax3d& domainMin() const { return m_domainMin; }
@@ -100,15 +156,31 @@ protected:
     void insert_box(
         const AABB& aabb, const long id, std::vector<HashItem>& items) const;
 
+    /// @brief Compute the range of cells overlapped by an AABB.
+    void cell_range(
+        const AABB& aabb,
+        ArrayMax3<int64_t>& int_min,
+        ArrayMax3<int64_t>& int_max) const;
+
+    /// @brief Replace the boxes and re-bin the ones that changed cells.
+    void update_boxes(
+        std::vector<AABB>& new_vertex_boxes,
+        std::vector<AABB>& new_edge_boxes,
+        std::vector<AABB>& new_face_boxes);
+
+    /// @brief Re-bin the items of boxes that changed cells.
+    /// @return The number of re-binned boxes.
+    size_t update_items(
+        const std::vector<AABB>& old_boxes,
+        const std::vector<AABB>& new_boxes,
+        std::vector<HashItem>& items) const;
+
+    /// @brief Create an empty hash grid with the same domain mode.
+    std::shared_ptr<BroadPhase> make_codim_broad_phase() const override;
+
     /// @brief Create the hash of a cell location.
-    inline long hash(int x, int y, int z) const
-    {
-        assert(x >= 0 && y >= 0 && z >= 0);
-        assert(
-            x < m_gridSize[0] && y < m_gridSize[1]
-            && (m_gridSize.size() == 2 || z < m_gridSize[2]));
-        return (z * m_gridSize[1] + y) * m_gridSize[0] + x;
-    }
+    /// @return The Morton code of the cell's coordinates (wrapped to 21 bits per axis in 3D and 32 bits in 2D).
+    uint64_t hash(int64_t x, int64_t y, int64_t z) const;
 
 private:
     template <typename Candidate>
@@ -132,6 +204,7 @@ protected:
     ArrayMax3i m_gridSize;
     ArrayMax3d m_domainMin;
     ArrayMax3d m_domainMax;
+    bool m_use_sparse_domain = false;
 
     std::vector<HashItem> vertex_items;
     std::vector<HashItem> edge_items;
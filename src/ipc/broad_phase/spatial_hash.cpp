@@ -5,17 +5,39 @@
 #include <ipc/ccd/aabb.hpp>
 #include <ipc/broad_phase/voxel_size_heuristic.hpp>
 #include <ipc/utils/merge_thread_local.hpp>
+#include <ipc/utils/logger.hpp>
 
 #include <ipc/config.hpp>
 
 #include <tbb/enumerable_thread_specific.h>
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_scan.h>
 #include <tbb/parallel_sort.h>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+
 namespace ipc {
 
+namespace {
+    /// @brief Largest ratio of grid voxels to (voxel, primitive) pairs for which the voxel table is built by counting over the whole grid.
+    constexpr size_t DENSE_VOXEL_TABLE_RATIO = 4;
+
+    /// @brief update() patches the voxel table in place unless more than one in this many primitives changed voxels, in which case the table is rebuilt in parallel.
+    constexpr size_t MAX_PATCHED_PRIMITIVES_RATIO = 8;
+
+    /// @brief Sort a vector and remove its duplicates in place.
+    void sort_and_unique(std::vector<int>& v)
+    {
+        std::sort(v.begin(), v.end());
+        v.erase(std::unique(v.begin(), v.end()), v.end());
+    }
+} // namespace
+
 void SpatialHash::build(
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
     double inflation_radius,
@@ -25,8 +47,8 @@ void SpatialHash::build(
 }
 
 void SpatialHash::build(
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
     double inflation_radius,
@@ -41,6 +63,7 @@ void SpatialHash::build(
     BroadPhase::build(vertices_t0, vertices_t1, edges, faces, inflation_radius);
 
     built_in_radius = inflation_radius;
+    built_voxel_size = voxel_size;
 
     if (voxel_size <= 0) {
         voxel_size = suggest_good_voxel_size(
@@ -68,11 +91,101 @@ void SpatialHash::build(
     edge_start_ind = num_vertices;
     tri_start_ind = edge_start_ind + edges.rows();
 
-    // precompute vVAI
-    std::vector<Eigen::Array3i> vertexMinVAI(
-        num_vertices, Eigen::Array3i::Zero());
-    std::vector<Eigen::Array3i> vertexMaxVAI(
-        num_vertices, Eigen::Array3i::Zero());
+    compute_occupancy(
+        vertices_t0, vertices_t1, edges, faces, inflation_radius,
+        point_and_edge_occupancy, face_occupancy);
+
+    build_voxel_table();
+}
+
+void SpatialHash::update(
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    double inflation_radius)
+{
+    if (!is_updatable(vertices_t0.rows(), edges, faces, inflation_radius)) {
+        build(
+            vertices_t0, vertices_t1, edges, faces, inflation_radius,
+            built_voxel_size);
+        return;
+    }
+
+    ArrayMax3d new_left_bottom_corner =
+        vertices_t0.colwise().minCoeff().cwiseMin(
+            vertices_t1.colwise().minCoeff());
+    ArrayMax3d new_right_top_corner =
+        vertices_t0.colwise().maxCoeff().cwiseMax(
+            vertices_t1.colwise().maxCoeff());
+    AABB::conservative_inflation(
+        new_left_bottom_corner, new_right_top_corner, inflation_radius);
+
+    // The voxel grid must still cover the whole mesh.
+    if ((new_left_bottom_corner < left_bottom_corner).any()
+        || (new_right_top_corner > right_top_corner).any()) {
+        build(
+            vertices_t0, vertices_t1, edges, faces, inflation_radius,
+            built_voxel_size);
+        return;
+    }
+
+    build_vertex_boxes(
+        vertices_t0, vertices_t1, vertex_boxes, inflation_radius);
+    build_edge_boxes(vertex_boxes, edges, edge_boxes);
+    build_face_boxes(vertex_boxes, faces, face_boxes);
+
+    std::vector<Eigen::Array3i> vertex_min_vai, vertex_max_vai;
+    compute_vertex_voxel_ranges(
+        vertices_t0, vertices_t1, inflation_radius, vertex_min_vai,
+        vertex_max_vai);
+
+    // Re-bin only the primitives whose range of voxels changed. The
+    // occupancy lists a range in increasing order, so its first and last
+    // voxels identify the range.
+    const size_t num_primitives =
+        point_and_edge_occupancy.size() + face_occupancy.size();
+    std::vector<char> is_moved(num_primitives, false);
+    tbb::parallel_for(size_t(0), num_primitives, [&](size_t i) {
+        Eigen::Array3i mins, maxs;
+        primitive_voxel_range(
+            i, edges, faces, vertex_min_vai, vertex_max_vai, mins, maxs);
+
+        std::vector<int>& voxels = i < point_and_edge_occupancy.size()
+            ? point_and_edge_occupancy[i]
+            : face_occupancy[i - point_and_edge_occupancy.size()];
+        const int first = voxelAxisIndex2VoxelIndex(mins[0], mins[1], mins[2]);
+        const int last = voxelAxisIndex2VoxelIndex(maxs[0], maxs[1], maxs[2]);
+        if (voxels.front() != first || voxels.back() != last) {
+            range_to_voxels(mins, maxs, voxels);
+            is_moved[i] = true;
+        }
+    });
+
+    const size_t num_updated =
+        std::count(is_moved.begin(), is_moved.end(), true);
+    if (num_updated > num_primitives / MAX_PATCHED_PRIMITIVES_RATIO) {
+        build_voxel_table();
+    } else if (num_updated > 0) {
+        update_voxel_table(is_moved);
+    }
+
+    logger().trace(
+        "spatial hash updated {:d} of {:d} primitives", num_updated,
+        num_primitives);
+}
+
+void SpatialHash::compute_vertex_voxel_ranges(
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
+    double inflation_radius,
+    std::vector<Eigen::Array3i>& vertex_min_vai,
+    std::vector<Eigen::Array3i>& vertex_max_vai) const
+{
+    const size_t num_vertices = vertices_t0.rows();
+
+    vertex_min_vai.assign(num_vertices, Eigen::Array3i::Zero());
+    vertex_max_vai.assign(num_vertices, Eigen::Array3i::Zero());
     tbb::parallel_for(size_t(0), num_vertices, [&](size_t vi) {
         ArrayMax3d v_min = vertices_t0.row(vi).cwiseMin(vertices_t1.row(vi));
         ArrayMax3d v_max = vertices_t0.row(vi).cwiseMax(vertices_t1.row(vi));
@@ -82,151 +195,441 @@ void SpatialHash::build(
         locate_voxel_axis_index(v_min, v_vai_min);
         locate_voxel_axis_index(v_max, v_vai_max);
 
-        vertexMinVAI[vi].head(dim) = v_vai_min;
-        vertexMaxVAI[vi].head(dim) = v_vai_max;
+        // A vertex on the upper boundary of the grid lands one voxel past
+        // the end when the grid's extent is a multiple of the voxel size.
+        vertex_min_vai[vi].head(dim) =
+            v_vai_min.max(0).min(voxel_count - 1);
+        vertex_max_vai[vi].head(dim) =
+            v_vai_max.max(0).min(voxel_count - 1);
     });
+}
 
+void SpatialHash::primitive_voxel_range(
+    const size_t i,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    const std::vector<Eigen::Array3i>& vertex_min_vai,
+    const std::vector<Eigen::Array3i>& vertex_max_vai,
+    Eigen::Array3i& mins,
+    Eigen::Array3i& maxs) const
+{
+    if (is_vertex_index(i)) {
+        mins = vertex_min_vai[i];
+        maxs = vertex_max_vai[i];
+    } else if (is_edge_index(i)) {
+        const int ei = to_edge_index(i);
+        mins = vertex_min_vai[edges(ei, 0)].min(vertex_min_vai[edges(ei, 1)]);
+        maxs = vertex_max_vai[edges(ei, 0)].max(vertex_max_vai[edges(ei, 1)]);
+    } else {
+        const int fi = to_triangle_index(i);
+        mins = vertex_min_vai[faces(fi, 0)]
+                   .min(vertex_min_vai[faces(fi, 1)])
+                   .min(vertex_min_vai[faces(fi, 2)]);
+        maxs = vertex_max_vai[faces(fi, 0)]
+                   .max(vertex_max_vai[faces(fi, 1)])
+                   .max(vertex_max_vai[faces(fi, 2)]);
+    }
+    assert((mins <= maxs).all());
+}
+
+void SpatialHash::range_to_voxels(
+    const Eigen::Array3i& mins,
+    const Eigen::Array3i& maxs,
+    std::vector<int>& voxels) const
+{
+    voxels.clear();
+    voxels.reserve((maxs - mins + 1).prod());
+    for (int iz = mins[2]; iz <= maxs[2]; iz++) {
+        int z_offset = iz * voxel_count_0x1;
+        for (int iy = mins[1]; iy <= maxs[1]; iy++) {
+            int yz_offset = iy * voxel_count[0] + z_offset;
+            for (int ix = mins[0]; ix <= maxs[0]; ix++) {
+                voxels.emplace_back(ix + yz_offset);
+            }
+        }
+    }
+}
+
+void SpatialHash::compute_occupancy(
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
+    const Eigen::MatrixXi& edges,
+    const Eigen::MatrixXi& faces,
+    double inflation_radius,
+    std::vector<std::vector<int>>& point_and_edge_occupancy,
+    std::vector<std::vector<int>>& face_occupancy) const
+{
+    // precompute vVAI
+    std::vector<Eigen::Array3i> vertex_min_vai, vertex_max_vai;
+    compute_vertex_voxel_ranges(
+        vertices_t0, vertices_t1, inflation_radius, vertex_min_vai,
+        vertex_max_vai);
+
+    point_and_edge_occupancy.clear();
     point_and_edge_occupancy.resize(tri_start_ind);
+    face_occupancy.clear();
+    face_occupancy.resize(faces.rows());
+
+    const size_t num_primitives = size_t(tri_start_ind) + faces.rows();
+    tbb::parallel_for(size_t(0), num_primitives, [&](size_t i) {
+        Eigen::Array3i mins, maxs;
+        primitive_voxel_range(
+            i, edges, faces, vertex_min_vai, vertex_max_vai, mins, maxs);
+        range_to_voxels(
+            mins, maxs,
+            i < point_and_edge_occupancy.size()
+                ? point_and_edge_occupancy[i]
+                : face_occupancy[i - point_and_edge_occupancy.size()]);
+    });
+}
 
-    tbb::parallel_for(size_t(0), num_vertices, [&](size_t vi) {
-        const Eigen::Array3i &mins = vertexMinVAI[vi], &maxs = vertexMaxVAI[vi];
-        assert((mins <= maxs).all());
-        point_and_edge_occupancy[vi].reserve((maxs - mins + 1).prod());
-        for (int iz = mins[2]; iz <= maxs[2]; iz++) {
-            int z_offset = iz * voxel_count_0x1;
-            for (int iy = mins[1]; iy <= maxs[1]; iy++) {
-                int yz_offset = iy * voxel_count[0] + z_offset;
-                for (int ix = mins[0]; ix <= maxs[0]; ix++) {
-                    point_and_edge_occupancy[vi].emplace_back(ix + yz_offset);
+void SpatialHash::build_voxel_table()
+{
+    const size_t num_primitives =
+        point_and_edge_occupancy.size() + face_occupancy.size();
+    const auto occupancy = [&](size_t i) -> const std::vector<int>& {
+        return i < point_and_edge_occupancy.size()
+            ? point_and_edge_occupancy[i]
+            : face_occupancy[i - point_and_edge_occupancy.size()];
+    };
+
+    // Count the (voxel, primitive) pairs of each primitive.
+    std::vector<size_t> pair_offsets(num_primitives + 1, 0);
+    tbb::parallel_scan(
+        tbb::blocked_range<size_t>(size_t(0), num_primitives), size_t(0),
+        [&](const tbb::blocked_range<size_t>& r, size_t sum,
+            const bool is_final_scan) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                sum += occupancy(i).size();
+                if (is_final_scan) {
+                    pair_offsets[i + 1] = sum;
                 }
             }
+            return sum;
+        },
+        std::plus<size_t>());
+    const size_t num_pairs = pair_offsets.back();
+
+    const size_t num_grid_voxels =
+        size_t(voxel_count_0x1) * (dim == 3 ? voxel_count[2] : 1);
+    if (num_grid_voxels <= DENSE_VOXEL_TABLE_RATIO * num_pairs) {
+        build_dense_voxel_table(num_grid_voxels, num_pairs);
+        return;
+    }
+
+    // Sparse grid: scatter the pairs as (voxel, primitive) keys and sort them
+    // by voxel and then by primitive.
+    std::vector<uint64_t> pairs(num_pairs);
+    tbb::parallel_for(size_t(0), num_primitives, [&](size_t i) {
+        const std::vector<int>& voxels = occupancy(i);
+        for (size_t j = 0; j < voxels.size(); j++) {
+            pairs[pair_offsets[i] + j] = (uint64_t(voxels[j]) << 32) | i;
         }
     });
-
-    tbb::parallel_for(size_t(0), size_t(edges.rows()), [&](size_t ei) {
-        int ei_ind = ei + edge_start_ind;
-
-        Eigen::Array3i mins =
-            vertexMinVAI[edges(ei, 0)].min(vertexMinVAI[edges(ei, 1)]);
-        Eigen::Array3i maxs =
-            vertexMaxVAI[edges(ei, 0)].max(vertexMaxVAI[edges(ei, 1)]);
-
-        point_and_edge_occupancy[ei_ind].reserve((maxs - mins + 1).prod());
-        for (int iz = mins[2]; iz <= maxs[2]; iz++) {
-            int z_offset = iz * voxel_count_0x1;
-            for (int iy = mins[1]; iy <= maxs[1]; iy++) {
-                int yz_offset = iy * voxel_count[0] + z_offset;
-                for (int ix = mins[0]; ix <= maxs[0]; ix++) {
-                    point_and_edge_occupancy[ei_ind].emplace_back(
-                        ix + yz_offset);
+    tbb::parallel_sort(pairs.begin(), pairs.end());
+
+    const auto voxel_of = [&](const size_t i) { return int(pairs[i] >> 32); };
+    const auto is_first = [&](const size_t i) {
+        return i == 0 || voxel_of(i) != voxel_of(i - 1);
+    };
+
+    // Index of the occupied voxel each pair belongs to.
+    std::vector<int> row(num_pairs);
+    tbb::parallel_scan(
+        tbb::blocked_range<size_t>(size_t(0), num_pairs), 0,
+        [&](const tbb::blocked_range<size_t>& r, int sum,
+            const bool is_final_scan) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                sum += is_first(i);
+                if (is_final_scan) {
+                    row[i] = sum - 1;
                 }
             }
+            return sum;
+        },
+        std::plus<int>());
+    const size_t num_voxels = num_pairs == 0 ? 0 : (row.back() + 1);
+
+    voxel_ids.resize(num_voxels);
+    voxel_offsets.resize(num_voxels + 1);
+    voxel_primitives.resize(num_pairs);
+    tbb::parallel_for(size_t(0), num_pairs, [&](size_t i) {
+        voxel_primitives[i] = int(pairs[i] & 0xFFFFFFFF);
+        if (is_first(i)) {
+            voxel_ids[row[i]] = voxel_of(i);
+            voxel_offsets[row[i]] = i;
         }
     });
+    voxel_offsets.back() = num_pairs;
+}
 
-    std::vector<std::vector<int>> voxelLoc_f(faces.rows());
-    tbb::parallel_for(size_t(0), size_t(faces.rows()), [&](size_t fi) {
-        Eigen::Array3i mins = vertexMinVAI[faces(fi, 0)]
-                                  .min(vertexMinVAI[faces(fi, 1)])
-                                  .min(vertexMinVAI[faces(fi, 2)]);
-        Eigen::Array3i maxs = vertexMaxVAI[faces(fi, 0)]
-                                  .max(vertexMaxVAI[faces(fi, 1)])
-                                  .max(vertexMaxVAI[faces(fi, 2)]);
-
-        for (int iz = mins[2]; iz <= maxs[2]; iz++) {
-            int z_offset = iz * voxel_count_0x1;
-            for (int iy = mins[1]; iy <= maxs[1]; iy++) {
-                int yz_offset = iy * voxel_count[0] + z_offset;
-                for (int ix = mins[0]; ix <= maxs[0]; ix++) {
-                    voxelLoc_f[fi].emplace_back(ix + yz_offset);
+void SpatialHash::build_dense_voxel_table(
+    const size_t num_grid_voxels, const size_t num_pairs)
+{
+    const size_t num_primitives =
+        point_and_edge_occupancy.size() + face_occupancy.size();
+    const auto occupancy = [&](size_t i) -> const std::vector<int>& {
+        return i < point_and_edge_occupancy.size()
+            ? point_and_edge_occupancy[i]
+            : face_occupancy[i - point_and_edge_occupancy.size()];
+    };
+
+    // Counting pass over every voxel of the grid.
+    std::vector<std::atomic<int>> voxel_sizes(num_grid_voxels);
+    tbb::parallel_for(size_t(0), num_primitives, [&](size_t i) {
+        for (const int voxel_ind : occupancy(i)) {
+            voxel_sizes[voxel_ind].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    // Prefix sums of the voxel sizes and of the number of occupied voxels.
+    std::vector<size_t> grid_offsets(num_grid_voxels + 1, 0);
+    std::vector<int> grid_row(num_grid_voxels);
+    tbb::parallel_scan(
+        tbb::blocked_range<size_t>(size_t(0), num_grid_voxels),
+        std::make_pair(size_t(0), 0),
+        [&](const tbb::blocked_range<size_t>& r, std::pair<size_t, int> sum,
+            const bool is_final_scan) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                const int size = voxel_sizes[i].load(std::memory_order_relaxed);
+                sum.first += size;
+                sum.second += size > 0;
+                if (is_final_scan) {
+                    grid_offsets[i + 1] = sum.first;
+                    grid_row[i] = sum.second - 1;
                 }
             }
+            return sum;
+        },
+        [](const std::pair<size_t, int>& a, const std::pair<size_t, int>& b) {
+            return std::make_pair(a.first + b.first, a.second + b.second);
+        });
+    assert(grid_offsets.back() == num_pairs);
+    const size_t num_voxels = num_grid_voxels == 0 ? 0 : grid_row.back() + 1;
+
+    voxel_ids.resize(num_voxels);
+    voxel_offsets.resize(num_voxels + 1);
+    tbb::parallel_for(size_t(0), num_grid_voxels, [&](size_t i) {
+        if (grid_offsets[i + 1] > grid_offsets[i]) {
+            voxel_ids[grid_row[i]] = i;
+            voxel_offsets[grid_row[i]] = grid_offsets[i];
         }
     });
-
-    for (int i = 0; i < point_and_edge_occupancy.size(); i++) {
-        for (const auto& voxelI : point_and_edge_occupancy[i]) {
-            voxel[voxelI].emplace_back(i);
+    voxel_offsets.back() = num_pairs;
+
+    // Scatter the primitives, filling each voxel from its end.
+    voxel_primitives.resize(num_pairs);
+    tbb::parallel_for(size_t(0), num_primitives, [&](size_t i) {
+        for (const int voxel_ind : occupancy(i)) {
+            const int j = voxel_sizes[voxel_ind].fetch_sub(
+                              1, std::memory_order_relaxed)
+                - 1;
+            voxel_primitives[grid_offsets[voxel_ind] + j] = i;
         }
+    });
+
+    // The scatter order depends on the scheduling, so sort each voxel.
+    tbb::parallel_for(size_t(0), num_voxels, [&](size_t i) {
+        std::sort(
+            voxel_primitives.begin() + voxel_offsets[i],
+            voxel_primitives.begin() + voxel_offsets[i + 1]);
+    });
+}
+
+void SpatialHash::update_voxel_table(const std::vector<char>& is_moved)
+{
+    const auto occupancy = [&](size_t i) -> const std::vector<int>& {
+        return i < point_and_edge_occupancy.size()
+            ? point_and_edge_occupancy[i]
+            : face_occupancy[i - point_and_edge_occupancy.size()];
+    };
+
+    // 1. Gather the (voxel, primitive) pairs of the moved primitives sorted
+    // by voxel and then by primitive.
+    tbb::enumerable_thread_specific<std::vector<uint64_t>> storage;
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), is_moved.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            auto& local_pairs = storage.local();
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                if (is_moved[i]) {
+                    for (const int voxel_ind : occupancy(i)) {
+                        local_pairs.push_back(
+                            (uint64_t(voxel_ind) << 32) | i);
+                    }
+                }
+            }
+        });
+    std::vector<uint64_t> new_pairs;
+    merge_thread_local_vectors(storage, new_pairs);
+    tbb::parallel_sort(new_pairs.begin(), new_pairs.end());
+
+    // 2. Merge them with the entries of the unmoved primitives, dropping the
+    // stale entries of the moved ones (both sequences are sorted). A range of
+    // rows [b, e) owns the new pairs whose voxel lies in
+    // [voxel_ids[b], voxel_ids[e]) (unbounded at either end of the table), so
+    // the rows produced by distinct ranges never share a voxel and each range
+    // only needs the (row, entry) counts of the ranges before it.
+    const size_t num_rows = voxel_ids.size();
+    if (num_rows == 0) {
+        build_voxel_table();
+        return;
     }
-    for (int fi = 0; fi < voxelLoc_f.size(); fi++) {
-        for (const auto& voxelI : voxelLoc_f[fi]) {
-            voxel[voxelI].emplace_back(fi + tri_start_ind);
+    const auto pair_bound = [&](const size_t row) -> size_t {
+        if (row == 0) {
+            return 0;
+        } else if (row == num_rows) {
+            return new_pairs.size();
+        }
+        return std::lower_bound(
+                   new_pairs.begin(), new_pairs.end(),
+                   uint64_t(voxel_ids[row]) << 32)
+            - new_pairs.begin();
+    };
+
+    // Sized to upper bounds and trimmed once the counts are known.
+    std::vector<int> merged_ids(num_rows + new_pairs.size());
+    std::vector<size_t> merged_offsets(num_rows + new_pairs.size() + 1);
+    std::vector<int> merged_primitives(
+        voxel_primitives.size() + new_pairs.size());
+
+    using Sizes = std::pair<size_t, size_t>; // (rows, entries)
+    const Sizes merged_sizes = tbb::parallel_scan(
+        tbb::blocked_range<size_t>(size_t(0), num_rows), Sizes(0, 0),
+        [&](const tbb::blocked_range<size_t>& r, Sizes sizes,
+            const bool is_final_scan) {
+            int last_voxel = -1;
+            const auto append = [&](const int voxel_ind, const int primitive) {
+                if (voxel_ind != last_voxel) {
+                    if (is_final_scan) {
+                        merged_ids[sizes.first] = voxel_ind;
+                        merged_offsets[sizes.first] = sizes.second;
+                    }
+                    sizes.first++;
+                    last_voxel = voxel_ind;
+                }
+                if (is_final_scan) {
+                    merged_primitives[sizes.second] = primitive;
+                }
+                sizes.second++;
+            };
+
+            auto new_pair = new_pairs.begin() + pair_bound(r.begin());
+            const auto new_pairs_end = new_pairs.begin() + pair_bound(r.end());
+            // Append the new pairs ordered before the given key.
+            const auto append_new_pairs_before = [&](const uint64_t key) {
+                for (; new_pair != new_pairs_end && *new_pair < key;
+                     ++new_pair) {
+                    append(int(*new_pair >> 32), int(*new_pair & 0xFFFFFFFF));
+                }
+            };
+
+            for (size_t row = r.begin(); row < r.end(); row++) {
+                for (size_t i = voxel_offsets[row]; i < voxel_offsets[row + 1];
+                     i++) {
+                    if (!is_moved[voxel_primitives[i]]) {
+                        append_new_pairs_before(
+                            (uint64_t(voxel_ids[row]) << 32)
+                            | uint32_t(voxel_primitives[i]));
+                        append(voxel_ids[row], voxel_primitives[i]);
+                    }
+                }
+            }
+            append_new_pairs_before(std::numeric_limits<uint64_t>::max());
+            assert(new_pair == new_pairs_end);
+            return sizes;
+        },
+        [](const Sizes& a, const Sizes& b) {
+            return Sizes(a.first + b.first, a.second + b.second);
+        });
+
+    merged_ids.resize(merged_sizes.first);
+    merged_offsets.resize(merged_sizes.first + 1);
+    merged_offsets.back() = merged_sizes.second;
+    merged_primitives.resize(merged_sizes.second);
+
+    voxel_ids.swap(merged_ids);
+    voxel_offsets.swap(merged_offsets);
+    voxel_primitives.swap(merged_primitives);
+}
+
+template <typename F>
+void SpatialHash::for_each_primitive(
+    const std::vector<int>& voxels, F&& f) const
+{
+    // The voxels are sorted, so each search can start after the previous one.
+    auto voxel_it = voxel_ids.begin();
+    for (const int voxel_ind : voxels) {
+        voxel_it = std::lower_bound(voxel_it, voxel_ids.end(), voxel_ind);
+        assert(voxel_it != voxel_ids.end() && *voxel_it == voxel_ind);
+        const size_t row = voxel_it - voxel_ids.begin();
+        for (size_t i = voxel_offsets[row]; i < voxel_offsets[row + 1]; i++) {
+            f(voxel_primitives[i]);
         }
     }
 }
 
 void SpatialHash::query_point_for_points(
-    int vi, unordered_set<int>& vert_inds) const
+    int vi, std::vector<int>& vert_inds) const
 {
     vert_inds.clear();
-    for (const auto& voxel_ind : point_and_edge_occupancy[vi]) {
-        const auto& voxelI = voxel.at(voxel_ind);
-        for (const auto& indI : voxelI) {
-            if (is_vertex_index(indI) && indI > vi) {
-                vert_inds.insert(indI);
-            }
+    for_each_primitive(point_and_edge_occupancy[vi], [&](const int indI) {
+        if (is_vertex_index(indI) && indI > vi) {
+            vert_inds.push_back(indI);
         }
-    }
+    });
+    sort_and_unique(vert_inds);
 }
 
 void SpatialHash::query_point_for_edges(
-    int vi, unordered_set<int>& edge_inds) const
+    int vi, std::vector<int>& edge_inds) const
 {
     edge_inds.clear();
-    for (const auto& voxel_ind : point_and_edge_occupancy[vi]) {
-        const auto& voxelI = voxel.at(voxel_ind);
-        for (const auto& indI : voxelI) {
-            if (is_edge_index(indI)) {
-                edge_inds.insert(to_edge_index(indI));
-            }
+    for_each_primitive(point_and_edge_occupancy[vi], [&](const int indI) {
+        if (is_edge_index(indI)) {
+            edge_inds.push_back(to_edge_index(indI));
         }
-    }
+    });
+    sort_and_unique(edge_inds);
 }
 
 void SpatialHash::query_point_for_triangles(
-    int vi, unordered_set<int>& tri_inds) const
+    int vi, std::vector<int>& tri_inds) const
 {
     tri_inds.clear();
-    for (const auto& voxel_ind : point_and_edge_occupancy[vi]) {
-        const auto& voxelI = voxel.at(voxel_ind);
-        for (const auto& indI : voxelI) {
-            if (is_triangle_index(indI)) {
-                tri_inds.insert(to_triangle_index(indI));
-            }
+    for_each_primitive(point_and_edge_occupancy[vi], [&](const int indI) {
+        if (is_triangle_index(indI)) {
+            tri_inds.push_back(to_triangle_index(indI));
         }
-    }
+    });
+    sort_and_unique(tri_inds);
 }
 
 // will only put edges with larger than eai index into edge_inds
 void SpatialHash::query_edge_for_edges(
-    int eai, unordered_set<int>& edge_inds) const
+    int eai, std::vector<int>& edge_inds) const
 {
     edge_inds.clear();
-    for (const auto& voxel_ind :
-         point_and_edge_occupancy[eai + edge_start_ind]) {
-        const auto& voxelI = voxel.at(voxel_ind);
-        for (const auto& indI : voxelI) {
+    for_each_primitive(
+        point_and_edge_occupancy[eai + edge_start_ind], [&](const int indI) {
             if (is_edge_index(indI) && to_edge_index(indI) > eai) {
-                edge_inds.insert(to_edge_index(indI));
+                edge_inds.push_back(to_edge_index(indI));
             }
-        }
-    }
+        });
+    sort_and_unique(edge_inds);
 }
 
 void SpatialHash::query_edge_for_triangles(
-    int ei, unordered_set<int>& tri_inds) const
+    int ei, std::vector<int>& tri_inds) const
 {
     tri_inds.clear();
-    for (const auto& voxel_ind :
-         point_and_edge_occupancy[ei + edge_start_ind]) {
-        const auto& voxelI = voxel.at(voxel_ind);
-        for (const auto& indI : voxelI) {
+    for_each_primitive(
+        point_and_edge_occupancy[ei + edge_start_ind], [&](const int indI) {
             if (is_triangle_index(indI)) {
-                tri_inds.insert(to_triangle_index(indI));
+                tri_inds.push_back(to_triangle_index(indI));
             }
-        }
-    }
+        });
+    sort_and_unique(tri_inds);
 }
 
 // ============================================================================
@@ -242,9 +645,9 @@ void SpatialHash::detect_vertex_vertex_candidates(
         tbb::blocked_range<size_t>(size_t(0), vertex_boxes.size()),
         [&](const tbb::blocked_range<size_t>& range) {
             auto& local_candidates = storages.local();
+            std::vector<int> vertex_inds;
 
             for (long vi = range.begin(); vi != range.end(); vi++) {
-                unordered_set<int> vertex_inds;
                 query_point_for_points(vi, vertex_inds);
 
                 for (const auto& vj : vertex_inds) {
@@ -252,7 +655,7 @@ void SpatialHash::detect_vertex_vertex_candidates(
                         continue;
                     }
 
-                    if (vertex_boxes[vi].intersects(vertex_boxes[vi])) {
+                    if (vertex_boxes[vi].intersects(vertex_boxes[vj])) {
                         local_candidates.emplace_back(vi, vj);
                     }
                 }
@@ -271,11 +674,11 @@ void SpatialHash::detect_edge_vertex_candidates(
         tbb::blocked_range<size_t>(size_t(0), vertex_boxes.size()),
         [&](const tbb::blocked_range<size_t>& range) {
             auto& local_candidates = storages.local();
+            std::vector<int> edge_inds;
 
             for (long vi = range.begin(); vi != range.end(); vi++) {
                 const AABB& vertex_box = vertex_boxes[vi];
 
-                unordered_set<int> edge_inds;
                 query_point_for_edges(vi, edge_inds);
 
                 for (const auto& ei : edge_inds) {
@@ -303,11 +706,11 @@ void SpatialHash::detect_edge_edge_candidates(
         tbb::blocked_range<size_t>(size_t(0), edge_boxes.size()),
         [&](const tbb::blocked_range<size_t>& range) {
             auto& local_candidates = storages.local();
+            std::vector<int> edge_inds;
 
             for (long eai = range.begin(); eai != range.end(); eai++) {
                 const AABB& edge_a_box = edge_boxes[eai];
 
-                unordered_set<int> edge_inds;
                 query_edge_for_edges(eai, edge_inds);
 
                 for (const auto& ebi : edge_inds) {
@@ -335,11 +738,11 @@ void SpatialHash::detect_face_vertex_candidates(
         tbb::blocked_range<size_t>(size_t(0), vertex_boxes.size()),
         [&](const tbb::blocked_range<size_t>& range) {
             auto& local_candidates = storages.local();
+            std::vector<int> tri_inds;
 
             for (long vi = range.begin(); vi != range.end(); vi++) {
                 const AABB& vertex_box = vertex_boxes[vi];
 
-                unordered_set<int> tri_inds;
                 query_point_for_triangles(vi, tri_inds);
 
                 for (const auto& fi : tri_inds) {
@@ -367,11 +770,11 @@ void SpatialHash::detect_edge_face_candidates(
         tbb::blocked_range<size_t>(size_t(0), edge_boxes.size()),
         [&](const tbb::blocked_range<size_t>& range) {
             auto& local_candidates = storages.local();
+            std::vector<int> tri_inds;
 
             for (long ei = range.begin(); ei != range.end(); ei++) {
                 const AABB& edge_box = edge_boxes[ei];
 
-                unordered_set<int> tri_inds;
                 query_edge_for_triangles(ei, tri_inds);
 
                 for (const auto& fi : tri_inds) {
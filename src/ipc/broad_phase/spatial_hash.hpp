@@ -3,7 +3,6 @@
 #pragma once
 
 #include <ipc/broad_phase/broad_phase.hpp>
-#include <ipc/utils/unordered_map_and_set.hpp>
 #include <ipc/utils/eigen_ext.hpp>
 
 #include <vector>
@@ -19,18 +18,27 @@ public: // data
 
     int edge_start_ind, tri_start_ind;
 
-    unordered_map<int, std::vector<int>> voxel;
+    /// @brief Sorted indices of the occupied voxels.
+    std::vector<int> voxel_ids;
+    /// @brief Offsets of each occupied voxel's primitives in voxel_primitives.
+    std::vector<size_t> voxel_offsets;
+    /// @brief Primitives grouped by voxel (in increasing order within a voxel).
+    std::vector<int> voxel_primitives;
+
     std::vector<std::vector<int>> point_and_edge_occupancy;
+    std::vector<std::vector<int>> face_occupancy;
 
 protected:
     int dim;
     double built_in_radius;
+    /// @brief Voxel size passed to the last build (non-positive if chosen by the heuristic), reused when update() has to rebuild.
+    double built_voxel_size = -1;
 
 public: // constructor
     SpatialHash() { }
 
     SpatialHash(
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         double inflation_radius = 0,
@@ -40,8 +48,8 @@ public: // constructor
     }
 
     SpatialHash(
-        const Eigen::MatrixXd& vertices_t0,
-        const Eigen::MatrixXd& vertices_t1,
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         double inflation_radius = 0,
@@ -54,7 +62,7 @@ public: // constructor
 
 public: // API
     void build(
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         double inflation_radius = 0) override
@@ -63,8 +71,8 @@ public: // API
     }
 
     void build(
-        const Eigen::MatrixXd& vertices_t0,
-        const Eigen::MatrixXd& vertices_t1,
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         double inflation_radius = 0) override
@@ -75,25 +83,53 @@ public: // API
     }
 
     void build(
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         double inflation_radius,
         double voxel_size);
 
     void build(
-        const Eigen::MatrixXd& vertices_t0,
-        const Eigen::MatrixXd& vertices_t1,
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         double inflation_radius,
         double voxel_size);
 
+    /// @brief Update the spatial hash for static collision detection.
+    /// @note Only the primitives whose occupied voxels changed are re-binned into the voxel table.
+    void update(
+        ConstRef<Eigen::MatrixXd> vertices,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        double inflation_radius = 0) override
+    {
+        update(vertices, vertices, edges, faces, inflation_radius);
+    }
+
+    /// @brief Update the spatial hash for continuous collision detection.
+    /// @note Only the primitives whose occupied voxels changed are re-binned into the voxel table.
+    void update(
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        double inflation_radius = 0) override;
+
     void clear() override
     {
         BroadPhase::clear();
-        voxel.clear();
+        voxel_ids.clear();
+        voxel_offsets.clear();
+        voxel_primitives.clear();
         point_and_edge_occupancy.clear();
+        face_occupancy.clear();
+    }
+
+    BroadPhaseMethod method() const override
+    {
+        return BroadPhaseMethod::SPATIAL_HASH;
     }
 
     /// @brief Check if primitive index refers to a vertex.
@@ -149,16 +185,74 @@ public: // API
         std::vector<EdgeFaceCandidate>& candidates) const override;
 
 protected: // helper functions
-    void query_point_for_points(int vi, unordered_set<int>& vert_inds) const;
+    /// @brief Compute the range of voxels (as axis indices) overlapped by each vertex's inflated trajectory.
+    void compute_vertex_voxel_ranges(
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
+        double inflation_radius,
+        std::vector<Eigen::Array3i>& vertex_min_vai,
+        std::vector<Eigen::Array3i>& vertex_max_vai) const;
+
+    /// @brief Compute the range of voxels overlapped by a primitive from the ranges of its vertices.
+    /// @param i Primitive index.
+    void primitive_voxel_range(
+        const size_t i,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        const std::vector<Eigen::Array3i>& vertex_min_vai,
+        const std::vector<Eigen::Array3i>& vertex_max_vai,
+        Eigen::Array3i& mins,
+        Eigen::Array3i& maxs) const;
+
+    /// @brief List the voxels in a range of voxel axis indices in increasing order.
+    void range_to_voxels(
+        const Eigen::Array3i& mins,
+        const Eigen::Array3i& maxs,
+        std::vector<int>& voxels) const;
+
+    /// @brief Compute the voxels occupied by each primitive.
+    void compute_occupancy(
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        double inflation_radius,
+        std::vector<std::vector<int>>& point_and_edge_occupancy,
+        std::vector<std::vector<int>>& face_occupancy) const;
+
+    /// @brief Build the voxel table from the occupancy of each primitive.
+    void build_voxel_table();
+
+    /// @brief Patch the voxel table after some primitives changed voxels.
+    /// @note The entries of the moved primitives are removed and their new (voxel, primitive) pairs are merged in, so the table stays sorted without being rebuilt. The merge is a parallel scan over the rows of the old table.
+    /// @param is_moved Whether each primitive's occupancy changed since the table was built.
+    void update_voxel_table(const std::vector<char>& is_moved);
+
+    /// @brief Build the voxel table with a counting sort over every voxel of the grid.
+    /// @param num_grid_voxels Number of voxels in the grid.
+    /// @param num_pairs Number of (voxel, primitive) pairs.
+    void build_dense_voxel_table(size_t num_grid_voxels, size_t num_pairs);
+
+    /// @brief Call a function on every primitive in each of the given voxels.
+    /// @note Primitives occupying several of the voxels are visited once per voxel.
+    /// @param voxels Sorted indices of occupied voxels.
+    /// @param f Function taking a primitive index.
+    template <typename F>
+    void for_each_primitive(const std::vector<int>& voxels, F&& f) const;
+
+    // The query results are sorted and unique. The output vectors are cleared
+    // first, so they can be reused across queries without reallocating.
+
+    void query_point_for_points(int vi, std::vector<int>& vert_inds) const;
 
-    void query_point_for_edges(int vi, unordered_set<int>& edge_inds) const;
+    void query_point_for_edges(int vi, std::vector<int>& edge_inds) const;
 
-    void query_point_for_triangles(int vi, unordered_set<int>& tri_inds) const;
+    void query_point_for_triangles(int vi, std::vector<int>& tri_inds) const;
 
     // will only put edges with larger than ei index into edge_inds
-    void query_edge_for_edges(int eai, unordered_set<int>& edge_inds) const;
+    void query_edge_for_edges(int eai, std::vector<int>& edge_inds) const;
 
-    void query_edge_for_triangles(int ei, unordered_set<int>& tri_inds) const;
+    void query_edge_for_triangles(int ei, std::vector<int>& tri_inds) const;
 
     int locate_voxel_index(const VectorMax3d& p) const;
 
@@ -8,10 +8,17 @@
 #include <ccdgpu/helper.cuh>
 #endif
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/parallel_sort.h>
+
+#include <functional>
+
 namespace ipc {
 
 void SweepAndTiniestQueue::build(
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const Eigen::MatrixXi& _edges,
     const Eigen::MatrixXi& _faces,
     const double inflation_radius)
@@ -20,14 +27,15 @@ void SweepAndTiniestQueue::build(
 }
 
 void SweepAndTiniestQueue::build(
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     const Eigen::MatrixXi& _edges,
     const Eigen::MatrixXi& _faces,
     const double inflation_radius)
 {
     CopyMeshBroadPhase::copy_mesh(_edges, _faces);
     num_vertices = vertices_t0.rows();
+    built_inflation_radius = inflation_radius;
     stq::cpu::constructBoxes(
         vertices_t0, vertices_t1, edges, faces, boxes, inflation_radius);
     int n = boxes.size();
@@ -35,6 +43,90 @@ void SweepAndTiniestQueue::build(
     stq::cpu::run_sweep_cpu(boxes, n, overlaps);
 }
 
+void SweepAndTiniestQueue::update(
+    ConstRef<Eigen::MatrixXd> vertices,
+    const Eigen::MatrixXi& _edges,
+    const Eigen::MatrixXi& _faces,
+    const double inflation_radius)
+{
+    update(vertices, vertices, _edges, _faces, inflation_radius);
+}
+
+void SweepAndTiniestQueue::update(
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
+    const Eigen::MatrixXi& _edges,
+    const Eigen::MatrixXi& _faces,
+    const double inflation_radius)
+{
+    const auto is_same = [](const Eigen::MatrixXi& a,
+                            const Eigen::MatrixXi& b) {
+        return a.rows() == b.rows() && a.cols() == b.cols() && a == b;
+    };
+    if (boxes.empty() || num_vertices != vertices_t0.rows()
+        || inflation_radius != built_inflation_radius
+        || !is_same(edges, _edges) || !is_same(faces, _faces)) {
+        build(vertices_t0, vertices_t1, _edges, _faces, inflation_radius);
+        return;
+    }
+
+    std::vector<stq::cpu::Aabb> new_boxes;
+    stq::cpu::constructBoxes(
+        vertices_t0, vertices_t1, edges, faces, new_boxes, inflation_radius);
+    int n = new_boxes.size();
+    assert(n == boxes.size());
+
+    // Permute the new boxes into the previous sorted order.
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), boxes.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                boxes[i] = new_boxes[boxes[i].id];
+            }
+        });
+
+    // Count the boxes displaced from the sorted order. Between steps the order
+    // changes little, so an insertion sort is close to linear.
+    const size_t num_displaced = tbb::parallel_reduce(
+        tbb::blocked_range<size_t>(size_t(1), boxes.size()),
+        size_t(0),
+        [&](const tbb::blocked_range<size_t>& r, size_t count) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                count += boxes[i].min[0] < boxes[i - 1].min[0];
+            }
+            return count;
+        },
+        std::plus<size_t>());
+
+    const auto sort_boxes = [&]() {
+        tbb::parallel_sort(
+            boxes.begin(), boxes.end(),
+            [](const stq::cpu::Aabb& a, const stq::cpu::Aabb& b) {
+                return a.min[0] < b.min[0];
+            });
+    };
+
+    // Fall back to a full sort if many boxes moved or they moved too far.
+    if (num_displaced > boxes.size() / 64) {
+        sort_boxes();
+    } else if (num_displaced > 0) {
+        const size_t max_swaps = 8 * boxes.size();
+        size_t num_swaps = 0;
+        for (size_t i = 1; i < boxes.size() && num_swaps <= max_swaps; i++) {
+            for (size_t j = i; j > 0 && boxes[j].min[0] < boxes[j - 1].min[0];
+                 j--) {
+                std::swap(boxes[j], boxes[j - 1]);
+                num_swaps++;
+            }
+        }
+        if (num_swaps > max_swaps) {
+            sort_boxes();
+        }
+    }
+
+    stq::cpu::run_sweep_cpu(boxes, n, overlaps);
+}
+
 void SweepAndTiniestQueue::clear()
 {
     BroadPhase::clear();
@@ -121,7 +213,7 @@ bool SweepAndTiniestQueue::is_face(long id) const
 
 #ifdef IPC_TOOLKIT_WITH_CUDA
 void SweepAndTiniestQueueGPU::build(
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const Eigen::MatrixXi& _edges,
     const Eigen::MatrixXi& _faces,
     const double inflation_radius)
@@ -132,8 +224,8 @@ void SweepAndTiniestQueueGPU::build(
 }
 
 void SweepAndTiniestQueueGPU::build(
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     const Eigen::MatrixXi& _edges,
     const Eigen::MatrixXi& _faces,
     const double inflation_radius)
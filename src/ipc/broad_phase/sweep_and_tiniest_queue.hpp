@@ -36,7 +36,7 @@ public:
     /// @param faces Collision mesh faces
     /// @param inflation_radius Radius of inflation around all elements.
     void build(
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         double inflation_radius = 0) override;
@@ -48,8 +48,33 @@ public:
     /// @param faces Collision mesh faces
     /// @param inflation_radius Radius of inflation around all elements.
     void build(
-        const Eigen::MatrixXd& vertices_t0,
-        const Eigen::MatrixXd& vertices_t1,
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        double inflation_radius = 0) override;
+
+    /// @brief Update the broad phase for static collision detection.
+    /// @param vertices Vertex positions
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void update(
+        ConstRef<Eigen::MatrixXd> vertices,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        double inflation_radius = 0) override;
+
+    /// @brief Update the broad phase for continuous collision detection.
+    /// @note Warm-starts the sort along the x-axis from the previous order.
+    /// @param vertices_t0 Starting vertex positions
+    /// @param vertices_t1 Ending vertex positions
+    /// @param edges Collision mesh edges
+    /// @param faces Collision mesh faces
+    /// @param inflation_radius Radius of inflation around all elements.
+    void update(
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         double inflation_radius = 0) override;
@@ -57,6 +82,12 @@ public:
     /// @brief Clear any built data.
     void clear() override;
 
+    /// @brief Get the method implemented by this broad phase.
+    BroadPhaseMethod method() const override
+    {
+        return BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE;
+    }
+
     /// @brief Find the candidate vertex-vertex collisions.
     /// @param[out] candidates The candidate vertex-vertex collisions.
     [[noreturn]] void detect_vertex_vertex_candidates(
@@ -104,7 +135,7 @@ public:
     /// @param faces Collision mesh faces
     /// @param inflation_radius Radius of inflation around all elements.
     void build(
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         double inflation_radius = 0) override;
@@ -116,8 +147,8 @@ public:
     /// @param faces Collision mesh faces
     /// @param inflation_radius Radius of inflation around all elements.
     void build(
-        const Eigen::MatrixXd& vertices_t0,
-        const Eigen::MatrixXd& vertices_t1,
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         double inflation_radius = 0) override;
@@ -125,6 +156,12 @@ public:
     /// @brief Clear any built data.
     void clear() override;
 
+    /// @brief Get the method implemented by this broad phase.
+    BroadPhaseMethod method() const override
+    {
+        return BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE_GPU;
+    }
+
     /// @brief Find the candidate vertex-vertex collisions.
     /// @param[out] candidates The candidate vertex-vertex collisions.
     [[noreturn]] void detect_vertex_vertex_candidates(
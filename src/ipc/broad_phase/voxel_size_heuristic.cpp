@@ -12,7 +12,7 @@ namespace {
 } // namespace
 
 double suggest_good_voxel_size(
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const Eigen::MatrixXi& edges,
     const double inflation_radius)
 {
@@ -37,8 +37,8 @@ double suggest_good_voxel_size(
 }
 
 double suggest_good_voxel_size(
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     const Eigen::MatrixXi& edges,
     const double inflation_radius)
 {
@@ -74,8 +74,8 @@ double suggest_good_voxel_size(
 }
 
 double mean_edge_length(
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     const Eigen::MatrixXi& edges,
     double& std_deviation)
 {
@@ -106,7 +106,7 @@ double mean_edge_length(
 }
 
 double mean_displacement_length(
-    const Eigen::MatrixXd& displacements, double& std_deviation)
+    ConstRef<Eigen::MatrixXd> displacements, double& std_deviation)
 {
     const double mean = displacements.rowwise().norm().mean();
     std_deviation = sqrt(
@@ -116,8 +116,8 @@ double mean_displacement_length(
 }
 
 double median_edge_length(
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     const Eigen::MatrixXi& edges)
 {
     if (edges.rows() == 0) {
@@ -138,7 +138,7 @@ double median_edge_length(
     return median;
 }
 
-double median_displacement_length(const Eigen::MatrixXd& displacements)
+double median_displacement_length(ConstRef<Eigen::MatrixXd> displacements)
 {
     double median = -1;
     check_success(igl::median(displacements.rowwise().norm(), median));
@@ -146,8 +146,8 @@ double median_displacement_length(const Eigen::MatrixXd& displacements)
 }
 
 double max_edge_length(
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     const Eigen::MatrixXi& edges)
 {
     double max_edge = -std::numeric_limits<double>::infinity();
@@ -162,7 +162,7 @@ double max_edge_length(
     return max_edge;
 }
 
-double max_displacement_length(const Eigen::MatrixXd& displacements)
+double max_displacement_length(ConstRef<Eigen::MatrixXd> displacements)
 {
     return displacements.rowwise().norm().maxCoeff();
 }
@@ -1,6 +1,7 @@
 #include "candidates.hpp"
 
 #include <ipc/ipc.hpp>
+#include <ipc/candidates/narrow_phase_ccd.hpp>
 #include <ipc/utils/save_obj.hpp>
 
 #include <ipc/config.hpp>
@@ -8,7 +9,16 @@
 #include <igl/remove_unreferenced.h>
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range.h>
-#include <shared_mutex>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <numeric>
 
 #include <fstream>
 
@@ -35,40 +45,83 @@ namespace {
     {
         return E_padded.leftCols(2);
     }
+
+    /// @brief Sum and log the per-thread filter counts.
+    /// @param thread_filter_counts Filter counts of each thread.
+    /// @param num_candidates Total number of candidates.
+    /// @param[out] filter_counts If not null, the summed filter counts.
+    /// @return The summed filter counts.
+    CCDFilterCounts log_filter_counts(
+        const tbb::enumerable_thread_specific<CCDFilterCounts>&
+            thread_filter_counts,
+        const size_t num_candidates,
+        CCDFilterCounts* filter_counts)
+    {
+        CCDFilterCounts counts;
+        for (const CCDFilterCounts& local_counts : thread_filter_counts) {
+            counts += local_counts;
+        }
+        if (filter_counts != nullptr) {
+            *filter_counts = counts;
+        }
+        logger().trace(
+            "CCD filters rejected {:d} (ToI lower bound), {:d} (separating "
+            "axis), and {:d} (sign of volume) of {:d} candidates; {:d} "
+            "needed root finding",
+            counts.toi_lower_bound, counts.separating_axis,
+            counts.sign_of_volume, num_candidates, counts.root_finding);
+        return counts;
+    }
 } // namespace
 
 void Candidates::build(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const double inflation_radius,
     const BroadPhaseMethod broad_phase_method)
 {
+    build(
+        mesh, vertices, inflation_radius,
+        BroadPhase::make_broad_phase(broad_phase_method));
+}
+
+void Candidates::build(
+    const CollisionMesh& mesh,
+    ConstRef<Eigen::MatrixXd> vertices,
+    const double inflation_radius,
+    const std::shared_ptr<BroadPhase>& broad_phase)
+{
+    assert(broad_phase != nullptr);
     const int dim = vertices.cols();
 
     clear();
 
-    std::shared_ptr<BroadPhase> broad_phase =
-        BroadPhase::make_broad_phase(broad_phase_method);
     broad_phase->can_vertices_collide = mesh.can_collide;
-    broad_phase->build(vertices, mesh.edges(), mesh.faces(), inflation_radius);
+    broad_phase->update(vertices, mesh.edges(), mesh.faces(), inflation_radius);
     broad_phase->detect_collision_candidates(dim, *this);
 
     if (mesh.num_codim_vertices()
-        && !implements_vertex_vertex(broad_phase_method)) {
+        && !implements_vertex_vertex(broad_phase->method())) {
         // TODO: Assumes this is the same as implements_edge_vertex
         logger().warn(
             "STQ broad phase does not support codim. point-point nor point-edge, skipping.");
         return;
     }
 
+    // The codim. stages use their own broad phase so the (possibly persistent)
+    // surface broad phase is left intact for the next update.
+    BroadPhase* codim_broad_phase = mesh.num_codim_vertices()
+        ? &broad_phase->codim_broad_phase()
+        : nullptr;
+
     // Codim. vertices to codim. vertices:
     if (mesh.num_codim_vertices()) {
-        broad_phase->clear();
-        broad_phase->build(
+        codim_broad_phase->can_vertices_collide = mesh.can_collide;
+        codim_broad_phase->build(
             vertices(mesh.codim_vertices(), Eigen::all), //
             Eigen::MatrixXi(), Eigen::MatrixXi(), inflation_radius);
 
-        broad_phase->detect_vertex_vertex_candidates(vv_candidates);
+        codim_broad_phase->detect_vertex_vertex_candidates(vv_candidates);
         for (auto& [vi, vj] : vv_candidates) {
             vi = mesh.codim_vertices()[vi];
             vj = mesh.codim_vertices()[vj];
@@ -99,15 +152,17 @@ void Candidates::build(
 
         CE.array() += nCV; // Offset indices to account for codim. vertices
 
-        // TODO: Can we reuse the broad phase from above?
-        broad_phase->clear();
-        broad_phase->can_vertices_collide = [&](size_t vi, size_t vj) {
-            // Ignore c-edge to c-edge and c-vertex to c-vertex
-            return ((vi < nCV) ^ (vj < nCV)) && mesh.can_collide(vi, vj);
-        };
-        broad_phase->build(V, CE, Eigen::MatrixXi(), inflation_radius);
-
-        broad_phase->detect_edge_vertex_candidates(ev_candidates);
+        codim_broad_phase->clear();
+        // Captured by value because the codim. broad phase outlives this call.
+        codim_broad_phase->can_vertices_collide =
+            [nCV, can_collide = mesh.can_collide](size_t vi, size_t vj) {
+                // Ignore c-edge to c-edge and c-vertex to c-vertex
+                return ((vi < nCV) ^ (vj < nCV)) && can_collide(vi, vj);
+            };
+        codim_broad_phase->build(
+            V, CE, Eigen::MatrixXi(), inflation_radius);
+
+        codim_broad_phase->detect_edge_vertex_candidates(ev_candidates);
         for (auto& [ei, vi] : ev_candidates) {
             assert(vi < mesh.codim_vertices().size());
             ei = mesh.codim_edges()[ei];    // Map back to mesh.edges
@@ -118,39 +173,56 @@ void Candidates::build(
 
 void Candidates::build(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     const double inflation_radius,
     const BroadPhaseMethod broad_phase_method)
 {
+    build(
+        mesh, vertices_t0, vertices_t1, inflation_radius,
+        BroadPhase::make_broad_phase(broad_phase_method));
+}
+
+void Candidates::build(
+    const CollisionMesh& mesh,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
+    const double inflation_radius,
+    const std::shared_ptr<BroadPhase>& broad_phase)
+{
+    assert(broad_phase != nullptr);
     const int dim = vertices_t0.cols();
 
     clear();
 
-    std::shared_ptr<BroadPhase> broad_phase =
-        BroadPhase::make_broad_phase(broad_phase_method);
     broad_phase->can_vertices_collide = mesh.can_collide;
-    broad_phase->build(
+    broad_phase->update(
         vertices_t0, vertices_t1, mesh.edges(), mesh.faces(), inflation_radius);
     broad_phase->detect_collision_candidates(dim, *this);
 
     if (mesh.num_codim_vertices()
-        && !implements_vertex_vertex(broad_phase_method)) {
+        && !implements_vertex_vertex(broad_phase->method())) {
         // TODO: Assumes this is the same as implements_edge_vertex
         logger().warn(
             "STQ broad phase does not support codim. point-point nor point-edge, skipping.");
         return;
     }
 
+    // The codim. stages use their own broad phase so the (possibly persistent)
+    // surface broad phase is left intact for the next update.
+    BroadPhase* codim_broad_phase = mesh.num_codim_vertices()
+        ? &broad_phase->codim_broad_phase()
+        : nullptr;
+
     // Codim. vertices to codim. vertices:
     if (mesh.num_codim_vertices()) {
-        broad_phase->clear();
-        broad_phase->build(
+        codim_broad_phase->can_vertices_collide = mesh.can_collide;
+        codim_broad_phase->build(
             vertices_t0(mesh.codim_vertices(), Eigen::all),
             vertices_t1(mesh.codim_vertices(), Eigen::all), //
             Eigen::MatrixXi(), Eigen::MatrixXi(), inflation_radius);
 
-        broad_phase->detect_vertex_vertex_candidates(vv_candidates);
+        codim_broad_phase->detect_vertex_vertex_candidates(vv_candidates);
         for (auto& [vi, vj] : vv_candidates) {
             vi = mesh.codim_vertices()[vi];
             vj = mesh.codim_vertices()[vj];
@@ -187,15 +259,17 @@ void Candidates::build(
 
         CE.array() += nCV; // Offset indices to account for codim. vertices
 
-        // TODO: Can we reuse the broad phase from above?
-        broad_phase->clear();
-        broad_phase->can_vertices_collide = [&](size_t vi, size_t vj) {
-            // Ignore c-edge to c-edge and c-vertex to c-vertex
-            return ((vi < nCV) ^ (vj < nCV)) && mesh.can_collide(vi, vj);
-        };
-        broad_phase->build(V_t0, V_t1, CE, Eigen::MatrixXi(), inflation_radius);
-
-        broad_phase->detect_edge_vertex_candidates(ev_candidates);
+        codim_broad_phase->clear();
+        // Captured by value because the codim. broad phase outlives this call.
+        codim_broad_phase->can_vertices_collide =
+            [nCV, can_collide = mesh.can_collide](size_t vi, size_t vj) {
+                // Ignore c-edge to c-edge and c-vertex to c-vertex
+                return ((vi < nCV) ^ (vj < nCV)) && can_collide(vi, vj);
+            };
+        codim_broad_phase->build(
+            V_t0, V_t1, CE, Eigen::MatrixXi(), inflation_radius);
+
+        codim_broad_phase->detect_edge_vertex_candidates(ev_candidates);
         for (auto& [ei, vi] : ev_candidates) {
             assert(vi < mesh.codim_vertices().size());
             ei = mesh.codim_edges()[ei];    // Map back to mesh.edges
@@ -206,79 +280,225 @@ void Candidates::build(
 
 bool Candidates::is_step_collision_free(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     const double min_distance,
     const double tolerance,
-    const long max_iterations) const
+    const long max_iterations,
+    CCDFilterCounts* filter_counts) const
 {
     assert(vertices_t0.rows() == mesh.num_vertices());
     assert(vertices_t1.rows() == mesh.num_vertices());
 
-    // Narrow phase
-    for (size_t i = 0; i < size(); i++) {
-        const ContinuousCollisionCandidate& candidate = (*this)[i];
-
-        double toi;
-        bool is_collision = candidate.ccd(
-            candidate.dof(vertices_t0, mesh.edges(), mesh.faces()),
-            candidate.dof(vertices_t1, mesh.edges(), mesh.faces()), //
-            toi, min_distance, /*tmax=*/1.0, tolerance, max_iterations);
-
-        if (is_collision) {
-            return false;
+    if (empty()) {
+        if (filter_counts != nullptr) {
+            *filter_counts = CCDFilterCounts();
         }
+        return true; // No possible collisions, so the step is collision free.
     }
 
-    return true;
+    // Narrow phase: stop all workers as soon as any collision is found.
+    std::atomic<bool> is_collision_free = true;
+    tbb::task_group_context context;
+    tbb::enumerable_thread_specific<CCDFilterCounts> thread_filter_counts;
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, size(), NARROW_PHASE_CCD_BLOCK_SIZE),
+        [&](const tbb::blocked_range<size_t>& r) {
+            std::array<size_t, NARROW_PHASE_CCD_BLOCK_SIZE> indices;
+            for (size_t begin = r.begin(); begin < r.end();
+                 begin += NARROW_PHASE_CCD_BLOCK_SIZE) {
+                const size_t n =
+                    std::min(NARROW_PHASE_CCD_BLOCK_SIZE, r.end() - begin);
+                std::iota(indices.begin(), indices.begin() + n, begin);
+
+                const NarrowPhaseCCDBlock block(
+                    *this, mesh, vertices_t0, vertices_t1, indices.data(), n);
+
+                for (size_t i = 0; i < n; i++) {
+                    if (!is_collision_free.load(std::memory_order_relaxed)) {
+                        return; // Another worker found a collision
+                    }
+
+                    // Only send candidates that survive the conservative
+                    // filters to the root finder.
+                    const CCDFilter filter =
+                        block.filter(i, min_distance, /*tmax=*/1.0);
+                    thread_filter_counts.local().record(filter);
+                    if (filter != CCDFilter::NONE) {
+                        continue;
+                    }
+
+                    double toi;
+                    const bool is_collision = block.ccd(
+                        i, toi, min_distance, /*tmax=*/1.0, tolerance,
+                        max_iterations);
+
+                    if (is_collision) {
+                        is_collision_free.store(
+                            false, std::memory_order_relaxed);
+                        context.cancel_group_execution();
+                        return;
+                    }
+                }
+            }
+        },
+        context);
+
+    log_filter_counts(thread_filter_counts, size(), filter_counts);
+
+    return is_collision_free;
 }
 
 double Candidates::compute_collision_free_stepsize(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     const double min_distance,
     const double tolerance,
-    const long max_iterations) const
+    const long max_iterations,
+    CCDFilterCounts* filter_counts,
+    CCDStepsizeStats* stats) const
 {
     assert(vertices_t0.rows() == mesh.num_vertices());
     assert(vertices_t1.rows() == mesh.num_vertices());
 
     if (empty()) {
+        if (filter_counts != nullptr) {
+            *filter_counts = CCDFilterCounts();
+        }
+        if (stats != nullptr) {
+            *stats = CCDStepsizeStats();
+        }
         return 1; // No possible collisions, so can take full step.
     }
 
-    double earliest_toi = 1;
-    std::shared_mutex earliest_toi_mutex;
+    const size_t n = size();
 
+    // Schedule the candidates in order of a cheap lower bound on their time of
+    // impact. Candidates likely to impact early shrink tmax quickly, and any
+    // candidate whose lower bound is beyond tmax can be skipped entirely.
+    // The initial distances are kept for the narrow-phase filters.
+    std::vector<double> initial_distances(n), toi_lower_bounds(n);
     tbb::parallel_for(
-        tbb::blocked_range<size_t>(0, size()),
-        [&](tbb::blocked_range<size_t> r) {
-            for (size_t i = r.begin(); i < r.end(); i++) {
-                // Use the mutex to read as well in case writing double takes
-                // more than one clock cycle.
-                double tmax;
-                {
-                    std::shared_lock lock(earliest_toi_mutex);
-                    tmax = earliest_toi;
+        tbb::blocked_range<size_t>(0, n, NARROW_PHASE_CCD_BLOCK_SIZE),
+        [&](const tbb::blocked_range<size_t>& r) {
+            std::array<size_t, NARROW_PHASE_CCD_BLOCK_SIZE> indices;
+            for (size_t begin = r.begin(); begin < r.end();
+                 begin += NARROW_PHASE_CCD_BLOCK_SIZE) {
+                const size_t size =
+                    std::min(NARROW_PHASE_CCD_BLOCK_SIZE, r.end() - begin);
+                std::iota(indices.begin(), indices.begin() + size, begin);
+
+                const NarrowPhaseCCDBlock block(
+                    *this, mesh, vertices_t0, vertices_t1, indices.data(),
+                    size);
+
+                for (size_t j = 0; j < size; j++) {
+                    initial_distances[begin + j] = block.initial_distance(j);
+                    toi_lower_bounds[begin + j] = block.toi_lower_bound(
+                        j, initial_distances[begin + j], min_distance);
+                }
+            }
+        });
+
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), size_t(0));
+    tbb::parallel_sort(order.begin(), order.end(), [&](size_t i, size_t j) {
+        return toi_lower_bounds[i] < toi_lower_bounds[j];
+    });
+
+    std::atomic<double> earliest_toi = 1;
+    // Index of the next batch of candidates (in sorted order) to process.
+    std::atomic<size_t> next_candidate = 0;
+    tbb::enumerable_thread_specific<CCDFilterCounts> thread_filter_counts;
+    // Time spent checking candidates by each thread (only measured if the
+    // statistics are requested).
+    using Clock = std::chrono::steady_clock;
+    tbb::enumerable_thread_specific<double> thread_check_time(0.0);
+    constexpr size_t batch_size = NARROW_PHASE_CCD_BLOCK_SIZE;
+
+    // Workers pull batches from the sorted list so the earliest candidates are
+    // always processed first.
+    const int num_workers = tbb::this_task_arena::max_concurrency();
+    tbb::parallel_for(0, num_workers, [&](int) {
+        while (true) {
+            const size_t begin = next_candidate.fetch_add(batch_size);
+            if (begin >= n) {
+                break;
+            }
+            const size_t end = std::min(begin + batch_size, n);
+
+            const Clock::time_point batch_start =
+                stats != nullptr ? Clock::now() : Clock::time_point();
+            const auto record_check_time = [&]() {
+                if (stats != nullptr) {
+                    thread_check_time.local() +=
+                        std::chrono::duration<double>(
+                            Clock::now() - batch_start)
+                            .count();
+                }
+            };
+
+            // Gather the batch's stencil positions in sorted order.
+            const NarrowPhaseCCDBlock block(
+                *this, mesh, vertices_t0, vertices_t1, order.data() + begin,
+                end - begin);
+
+            for (size_t k = begin; k < end; k++) {
+                const size_t i = order[k];
+                const size_t j = k - begin;
+                const double tmax = earliest_toi.load();
+
+                if (toi_lower_bounds[i] >= tmax) {
+                    // All remaining candidates have a larger lower bound.
+                    const size_t unclaimed = next_candidate.exchange(n);
+                    thread_filter_counts.local().toi_lower_bound +=
+                        (end - k) + (unclaimed < n ? n - unclaimed : 0);
+                    record_check_time();
+                    return;
                 }
 
-                const ContinuousCollisionCandidate& candidate = (*this)[i];
+                // Only send candidates that survive the conservative filters
+                // to the root finder. The ToI lower bound was checked above.
+                const CCDFilter filter = block.filter_with_initial_distance(
+                    j, initial_distances[i], min_distance, tmax);
+                thread_filter_counts.local().record(filter);
+                if (filter != CCDFilter::NONE) {
+                    continue;
+                }
 
                 double toi = std::numeric_limits<double>::infinity(); // output
-                const bool are_colliding = candidate.ccd(
-                    candidate.dof(vertices_t0, mesh.edges(), mesh.faces()),
-                    candidate.dof(vertices_t1, mesh.edges(), mesh.faces()), //
-                    toi, min_distance, tmax, tolerance, max_iterations);
+                const bool are_colliding = block.ccd(
+                    j, toi, min_distance, tmax, tolerance, max_iterations);
 
                 if (are_colliding) {
-                    std::unique_lock lock(earliest_toi_mutex);
-                    if (toi < earliest_toi) {
-                        earliest_toi = toi;
-                    }
+                    // Atomic min
+                    double prev_toi = earliest_toi.load();
+                    while (toi < prev_toi
+                           && !earliest_toi.compare_exchange_weak(
+                               prev_toi, toi)) { }
                 }
             }
-        });
+            record_check_time();
+        }
+    });
+
+    const CCDFilterCounts counts =
+        log_filter_counts(thread_filter_counts, n, filter_counts);
+    if (stats != nullptr) {
+        // Every candidate is either skipped by its ToI lower bound or checked.
+        stats->num_skipped = counts.toi_lower_bound;
+        stats->num_checked = n - counts.toi_lower_bound;
+        stats->check_time = 0;
+        for (const double local_check_time : thread_check_time) {
+            stats->check_time += local_check_time;
+        }
+        logger().trace(
+            "ToI-ordered narrow phase skipped {:d} of {:d} candidates, saving "
+            "an estimated {:g} s",
+            stats->num_skipped, n, stats->estimated_time_saved());
+    }
 
     assert(earliest_toi >= 0 && earliest_toi <= 1.0);
     return earliest_toi;
@@ -286,7 +506,7 @@ double Candidates::compute_collision_free_stepsize(
 
 double Candidates::compute_noncandidate_conservative_stepsize(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& displacements,
+    ConstRef<Eigen::MatrixXd> displacements,
     const double dhat) const
 {
     assert(displacements.rows() == mesh.num_vertices());
@@ -322,8 +542,8 @@ double Candidates::compute_noncandidate_conservative_stepsize(
 
 double Candidates::compute_cfl_stepsize(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     const double dhat,
     const BroadPhaseMethod broad_phase_method,
     const double min_distance,
@@ -411,7 +631,7 @@ const ContinuousCollisionCandidate& Candidates::operator[](size_t i) const
 
 bool Candidates::save_obj(
     const std::string& filename,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces) const
 {
@@ -12,6 +12,9 @@
 
 namespace ipc {
 
+struct CCDFilterCounts;
+struct CCDStepsizeStats;
+
 class Candidates {
 public:
     Candidates() { }
@@ -23,7 +26,7 @@ public:
     /// @param broad_phase_method Broad phase method to use.
     void build(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const double inflation_radius = 0,
         const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD);
 
@@ -36,11 +39,37 @@ public:
     /// @param broad_phase_method Broad phase method to use.
     void build(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices_t0,
-        const Eigen::MatrixXd& vertices_t1,
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
         const double inflation_radius = 0,
         const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD);
 
+    /// @brief Initialize the set of discrete collision detection candidates using a persistent broad phase.
+    /// @note The broad phase is updated in place, so it can be reused across calls.
+    /// @param mesh The surface of the collision mesh.
+    /// @param vertices Surface vertex positions (rowwise).
+    /// @param inflation_radius Amount to inflate the bounding boxes.
+    /// @param broad_phase Broad phase to update and query.
+    void build(
+        const CollisionMesh& mesh,
+        ConstRef<Eigen::MatrixXd> vertices,
+        const double inflation_radius,
+        const std::shared_ptr<BroadPhase>& broad_phase);
+
+    /// @brief Initialize the set of continuous collision detection candidates using a persistent broad phase.
+    /// @note Assumes the trajectory is linear. The broad phase is updated in place, so it can be reused across calls.
+    /// @param mesh The surface of the collision mesh.
+    /// @param vertices_t0 Surface vertex starting positions (rowwise).
+    /// @param vertices_t1 Surface vertex ending positions (rowwise).
+    /// @param inflation_radius Amount to inflate the bounding boxes.
+    /// @param broad_phase Broad phase to update and query.
+    void build(
+        const CollisionMesh& mesh,
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
+        const double inflation_radius,
+        const std::shared_ptr<BroadPhase>& broad_phase);
+
     size_t size() const;
 
     bool empty() const;
@@ -58,14 +87,16 @@ public:
     /// @param min_distance The minimum distance allowable between any two elements.
     /// @param tolerance The tolerance for the CCD algorithm.
     /// @param max_iterations The maximum number of iterations for the CCD algorithm.
+    /// @param[out] filter_counts If not null, the number of candidates rejected by each conservative CCD filter.
     /// @returns True if <b>any</b> collisions occur.
     bool is_step_collision_free(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices_t0,
-        const Eigen::MatrixXd& vertices_t1,
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
         const double min_distance = 0.0,
         const double tolerance = DEFAULT_CCD_TOLERANCE,
-        const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS) const;
+        const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
+        CCDFilterCounts* filter_counts = nullptr) const;
 
     /// @brief Computes a maximal step size that is collision free using the set of collision candidates.
     /// @note Assumes the trajectory is linear.
@@ -75,14 +106,18 @@ public:
     /// @param min_distance The minimum distance allowable between any two elements.
     /// @param tolerance The tolerance for the CCD algorithm.
     /// @param max_iterations The maximum number of iterations for the CCD algorithm.
+    /// @param[out] filter_counts If not null, the number of candidates rejected by each conservative CCD filter.
+    /// @param[out] stats If not null, the number of candidates skipped by the ToI-ordered scheduling and the estimated time saved.
     /// @returns A step-size \f$\in [0, 1]\f$ that is collision free. A value of 1.0 if a full step and 0.0 is no step.
     double compute_collision_free_stepsize(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices_t0,
-        const Eigen::MatrixXd& vertices_t1,
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
         const double min_distance = 0.0,
         const double tolerance = DEFAULT_CCD_TOLERANCE,
-        const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS) const;
+        const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
+        CCDFilterCounts* filter_counts = nullptr,
+        CCDStepsizeStats* stats = nullptr) const;
 
     /// @brief Computes a conservative bound on the largest-feasible step size for surface primitives not in collision.
     /// @param mesh The collision mesh.
@@ -90,7 +125,7 @@ public:
     /// @param dhat Barrier activation distance.
     double compute_noncandidate_conservative_stepsize(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& displacements,
+        ConstRef<Eigen::MatrixXd> displacements,
         const double dhat) const;
 
     /// @brief Computes a CFL-inspired CCD maximum step step size.
@@ -103,8 +138,8 @@ public:
     /// @param max_iterations The maximum number of iterations for the CCD algorithm.
     double compute_cfl_stepsize(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices_t0,
-        const Eigen::MatrixXd& vertices_t1,
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
         const double dhat,
         const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD,
         const double min_distance = 0.0,
@@ -113,7 +148,7 @@ public:
 
     bool save_obj(
         const std::string& filename,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces) const;
 
@@ -23,17 +23,18 @@ public:
         const Eigen::MatrixXi& edges, const Eigen::MatrixXi& faces) const = 0;
 
     /// @brief Get the vertex attributes of the collision stencil.
-    /// @tparam T Type of the attributes
+    /// @tparam Derived Type of the attributes
     /// @param vertices Vertex attributes
     /// @param edges Collision mesh edges
     /// @param faces Collision mesh faces
     /// @return The vertex positions of the collision stencil. Size is always 4, but elements i > num_vertices() are NaN.
-    template <typename T>
-    std::array<VectorMax3<T>, 4> vertices(
-        const MatrixX<T>& vertices,
+    template <typename Derived>
+    std::array<VectorMax3<typename Derived::Scalar>, 4> vertices(
+        const Eigen::MatrixBase<Derived>& vertices,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces) const
     {
+        using T = typename Derived::Scalar;
         constexpr double NaN = std::numeric_limits<double>::signaling_NaN();
 
         const std::array<long, 4> vertex_ids = this->vertex_ids(edges, faces);
@@ -51,19 +52,19 @@ public:
     }
 
     /// @brief Select this stencil's DOF from the full matrix of DOF.
-    /// @tparam T Type of the DOF
+    /// @tparam Derived Type of the full matrix of DOF
     /// @param X Full matrix of DOF (rowwise).
     /// @param edges Collision mesh edges
     /// @param faces Collision mesh faces
     /// @return This stencil's DOF.
-    template <typename T>
-    VectorMax12<T>
-    dof(const MatrixX<T>& X,
+    template <typename Derived>
+    VectorMax12<typename Derived::Scalar>
+    dof(const Eigen::MatrixBase<Derived>& X,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces) const
     {
         const int dim = X.cols();
-        VectorMax12<T> x(num_vertices() * dim);
+        VectorMax12<typename Derived::Scalar> x(num_vertices() * dim);
         const std::array<long, 4> idx = vertex_ids(edges, faces);
         for (int i = 0; i < num_vertices(); i++) {
             x.segment(i * dim, dim) = X.row(idx[i]);
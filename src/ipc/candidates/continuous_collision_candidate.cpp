@@ -1,7 +1,43 @@
 #include "continuous_collision_candidate.hpp"
 
+#include <ipc/ccd/ccd_filters.hpp>
+
+#include <cmath>
+
 namespace ipc {
 
+double ContinuousCollisionCandidate::compute_toi_lower_bound(
+    const VectorMax12d& vertices_t0,
+    const VectorMax12d& vertices_t1,
+    const double min_distance,
+    const double conservative_rescaling) const
+{
+    return compute_toi_lower_bound(
+        std::sqrt(compute_distance(vertices_t0)), vertices_t0, vertices_t1,
+        min_distance, conservative_rescaling);
+}
+
+double ContinuousCollisionCandidate::compute_toi_lower_bound(
+    const double initial_distance,
+    const VectorMax12d& vertices_t0,
+    const VectorMax12d& vertices_t1,
+    const double min_distance,
+    const double conservative_rescaling) const
+{
+    assert(vertices_t0.size() == vertices_t1.size());
+
+    const int dim = vertices_t0.size() / num_vertices();
+    assert(vertices_t0.size() % num_vertices() == 0);
+
+    // Each column of the map is the displacement of one stencil vertex.
+    const VectorMax12d displacements = vertices_t1 - vertices_t0;
+    return compute_additive_toi_lower_bound(
+        initial_distance,
+        Eigen::Map<const Eigen::MatrixXd>(
+            displacements.data(), dim, num_vertices()),
+        min_distance, conservative_rescaling);
+}
+
 std::ostream& ContinuousCollisionCandidate::write_ccd_query(
     std::ostream& out,
     const VectorMax12d& vertices_t0,
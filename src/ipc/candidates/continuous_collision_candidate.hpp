@@ -34,6 +34,35 @@ public:
         const double conservative_rescaling =
             DEFAULT_CCD_CONSERVATIVE_RESCALING) const = 0;
 
+    /// @brief Compute a conservative lower bound on the time of impact.
+    /// @note The distance between the stencil's primitives can shrink at most as fast as twice the largest vertex displacement relative to the stencil's mean displacement (i.e., the additive CCD bound of [Li et al. 2021]).
+    /// @param vertices_t0 Stencil vertices at the start of the time step.
+    /// @param vertices_t1 Stencil vertices at the end of the time step.
+    /// @param min_distance Minimum separation distance between primitives.
+    /// @param conservative_rescaling Conservative rescaling value used by ccd().
+    /// @return A lower bound on the time of impact reported by ccd(). Zero if the stencil is initially closer than min_distance and infinity if the stencil is not moving.
+    double compute_toi_lower_bound(
+        const VectorMax12d& vertices_t0,
+        const VectorMax12d& vertices_t1,
+        const double min_distance = 0.0,
+        const double conservative_rescaling =
+            DEFAULT_CCD_CONSERVATIVE_RESCALING) const;
+
+    /// @brief Compute a conservative lower bound on the time of impact given the initial distance.
+    /// @param initial_distance Distance between the primitives at the start of the time step.
+    /// @param vertices_t0 Stencil vertices at the start of the time step.
+    /// @param vertices_t1 Stencil vertices at the end of the time step.
+    /// @param min_distance Minimum separation distance between primitives.
+    /// @param conservative_rescaling Conservative rescaling value used by ccd().
+    /// @return A lower bound on the time of impact reported by ccd().
+    double compute_toi_lower_bound(
+        const double initial_distance,
+        const VectorMax12d& vertices_t0,
+        const VectorMax12d& vertices_t1,
+        const double min_distance = 0.0,
+        const double conservative_rescaling =
+            DEFAULT_CCD_CONSERVATIVE_RESCALING) const;
+
     /// @brief Write the CCD query to a stream.
     /// @param out Stream to write to.
     /// @param vertices_t0 Stencil vertices at the start of the time step.
@@ -0,0 +1,589 @@
+#include "narrow_phase_ccd.hpp"
+
+#include <ipc/ccd/ccd_filters.hpp>
+#include <ipc/distance/point_point.hpp>
+#include <ipc/distance/point_edge.hpp>
+#include <ipc/distance/edge_edge.hpp>
+#include <ipc/distance/point_triangle.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace ipc {
+
+namespace {
+    struct CCDParameters {
+        double min_distance;
+        double tmax;
+        double tolerance;
+        long max_iterations;
+        double conservative_rescaling;
+    };
+
+    // Statically dispatched root finders and filters. Each kernel receives
+    // the stencil positions of one candidate as the columns of a 3×N block in
+    // the order given by the candidate's vertex_ids(). The first
+    // NUM_FIRST_VERTICES columns belong to the first primitive.
+    template <typename Candidate> struct CCDKernel;
+
+    template <> struct CCDKernel<VertexVertexCandidate> {
+        static constexpr int NUM_VERTICES = 2;
+        static constexpr int NUM_FIRST_VERTICES = 1;
+
+        template <typename Stencil>
+        static double distance_squared(const Stencil& x)
+        {
+            return point_point_distance(x.col(0), x.col(1));
+        }
+
+        template <typename Stencil>
+        static Eigen::Vector3d separating_axis(const Stencil& x)
+        {
+            return x.col(1) - x.col(0);
+        }
+
+        template <typename Stencil>
+        static bool
+        sign_of_volume(const Stencil&, const Stencil&, const double)
+        {
+            return false; // No volume to check
+        }
+
+        template <typename Stencil>
+        static bool ccd(
+            const Stencil& x0,
+            const Stencil& x1,
+            double& toi,
+            const CCDParameters& p)
+        {
+            return point_point_ccd_3D(
+                x0.col(0), x0.col(1), x1.col(0), x1.col(1), toi,
+                p.min_distance, p.tmax, p.tolerance, p.max_iterations,
+                p.conservative_rescaling);
+        }
+    };
+
+    template <> struct CCDKernel<EdgeVertexCandidate> {
+        static constexpr int NUM_VERTICES = 3;
+        static constexpr int NUM_FIRST_VERTICES = 1;
+
+        template <typename Stencil>
+        static double distance_squared(const Stencil& x)
+        {
+            return point_edge_distance(x.col(0), x.col(1), x.col(2));
+        }
+
+        template <typename Stencil>
+        static Eigen::Vector3d separating_axis(const Stencil& x)
+        {
+            // Direction from the closest point on the edge to the point
+            const Eigen::Vector3d e = x.col(2) - x.col(1);
+            const double e_sq = e.squaredNorm();
+            const double alpha = e_sq > 0
+                ? std::clamp((x.col(0) - x.col(1)).dot(e) / e_sq, 0.0, 1.0)
+                : 0.0;
+            return x.col(0) - (x.col(1) + alpha * e);
+        }
+
+        template <typename Stencil>
+        static bool
+        sign_of_volume(const Stencil&, const Stencil&, const double)
+        {
+            return false; // No volume to check
+        }
+
+        template <typename Stencil>
+        static bool ccd(
+            const Stencil& x0,
+            const Stencil& x1,
+            double& toi,
+            const CCDParameters& p)
+        {
+            return point_edge_ccd_3D(
+                x0.col(0), x0.col(1), x0.col(2), //
+                x1.col(0), x1.col(1), x1.col(2), //
+                toi, p.min_distance, p.tmax, p.tolerance, p.max_iterations,
+                p.conservative_rescaling);
+        }
+    };
+
+    template <> struct CCDKernel<EdgeEdgeCandidate> {
+        static constexpr int NUM_VERTICES = 4;
+        static constexpr int NUM_FIRST_VERTICES = 2;
+
+        template <typename Stencil>
+        static double distance_squared(const Stencil& x)
+        {
+            return edge_edge_distance(x.col(0), x.col(1), x.col(2), x.col(3));
+        }
+
+        template <typename Stencil>
+        static Eigen::Vector3d separating_axis(const Stencil& x)
+        {
+            return (x.col(1) - x.col(0)).cross(x.col(3) - x.col(2));
+        }
+
+        template <typename Stencil>
+        static bool sign_of_volume(
+            const Stencil& x0, const Stencil& x1, const double threshold)
+        {
+            // Distance between the edges' lines
+            return sign_of_volume_filter(
+                x0.col(1) - x0.col(0), x1.col(1) - x1.col(0),
+                x0.col(3) - x0.col(2), x1.col(3) - x1.col(2),
+                x0.col(2) - x0.col(0), x1.col(2) - x1.col(0), threshold);
+        }
+
+        template <typename Stencil>
+        static bool ccd(
+            const Stencil& x0,
+            const Stencil& x1,
+            double& toi,
+            const CCDParameters& p)
+        {
+            return edge_edge_ccd(
+                x0.col(0), x0.col(1), x0.col(2), x0.col(3), //
+                x1.col(0), x1.col(1), x1.col(2), x1.col(3), //
+                toi, p.min_distance, p.tmax, p.tolerance, p.max_iterations,
+                p.conservative_rescaling);
+        }
+    };
+
+    template <> struct CCDKernel<FaceVertexCandidate> {
+        static constexpr int NUM_VERTICES = 4;
+        static constexpr int NUM_FIRST_VERTICES = 1;
+
+        template <typename Stencil>
+        static double distance_squared(const Stencil& x)
+        {
+            return point_triangle_distance(
+                x.col(0), x.col(1), x.col(2), x.col(3));
+        }
+
+        template <typename Stencil>
+        static Eigen::Vector3d separating_axis(const Stencil& x)
+        {
+            return (x.col(2) - x.col(1)).cross(x.col(3) - x.col(1));
+        }
+
+        template <typename Stencil>
+        static bool sign_of_volume(
+            const Stencil& x0, const Stencil& x1, const double threshold)
+        {
+            // Distance from the point to the triangle's plane
+            return sign_of_volume_filter(
+                x0.col(2) - x0.col(1), x1.col(2) - x1.col(1),
+                x0.col(3) - x0.col(1), x1.col(3) - x1.col(1),
+                x0.col(0) - x0.col(1), x1.col(0) - x1.col(1), threshold);
+        }
+
+        template <typename Stencil>
+        static bool ccd(
+            const Stencil& x0,
+            const Stencil& x1,
+            double& toi,
+            const CCDParameters& p)
+        {
+            return point_triangle_ccd(
+                x0.col(0), x0.col(1), x0.col(2), x0.col(3), //
+                x1.col(0), x1.col(1), x1.col(2), x1.col(3), //
+                toi, p.min_distance, p.tmax, p.tolerance, p.max_iterations,
+                p.conservative_rescaling);
+        }
+    };
+
+    // Gather the stencil positions of a candidate into four columns starting
+    // at col. 2D positions are embedded in the z = 0 plane.
+    template <typename Candidate>
+    void gather(
+        const Candidate& candidate,
+        const CollisionMesh& mesh,
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
+        const int col,
+        Eigen::Ref<Eigen::Matrix<double, 3, Eigen::Dynamic>> x0,
+        Eigen::Ref<Eigen::Matrix<double, 3, Eigen::Dynamic>> x1)
+    {
+        const int dim = vertices_t0.cols();
+        // Qualified call to avoid the virtual dispatch.
+        const std::array<long, 4> ids =
+            candidate.Candidate::vertex_ids(mesh.edges(), mesh.faces());
+        for (int k = 0; k < CCDKernel<Candidate>::NUM_VERTICES; k++) {
+            x0.col(col + k).head(dim) = vertices_t0.row(ids[k]).transpose();
+            x1.col(col + k).head(dim) = vertices_t1.row(ids[k]).transpose();
+        }
+    }
+
+    template <typename Candidate, typename Block>
+    bool run_kernel(
+        const Block& x0,
+        const Block& x1,
+        const int col,
+        double& toi,
+        const CCDParameters& parameters)
+    {
+        constexpr int N = CCDKernel<Candidate>::NUM_VERTICES;
+        return CCDKernel<Candidate>::ccd(
+            x0.template middleCols<N>(col), x1.template middleCols<N>(col),
+            toi, parameters);
+    }
+
+    template <typename Candidate, typename Block>
+    double run_initial_distance(const Block& x0_block, const int col)
+    {
+        constexpr int N = CCDKernel<Candidate>::NUM_VERTICES;
+        return std::sqrt(CCDKernel<Candidate>::distance_squared(
+            x0_block.template middleCols<N>(col)));
+    }
+
+    template <typename Candidate, typename Block>
+    double run_toi_lower_bound(
+        const Block& x0_block,
+        const Block& x1_block,
+        const int col,
+        const double initial_distance,
+        const double min_distance,
+        const double conservative_rescaling)
+    {
+        constexpr int N = CCDKernel<Candidate>::NUM_VERTICES;
+        const Eigen::Matrix<double, 3, N> dx =
+            x1_block.template middleCols<N>(col)
+            - x0_block.template middleCols<N>(col);
+        return compute_additive_toi_lower_bound(
+            initial_distance, dx, min_distance, conservative_rescaling);
+    }
+
+    /// @brief Apply the conservative filters to the candidate in the given columns.
+    /// @note If the initial distance is negative, it is computed here and the ToI lower bound is checked. Otherwise the caller has already checked the bound.
+    template <typename Candidate, typename Block>
+    CCDFilter run_filters(
+        const Block& x0_block,
+        const Block& x1_block,
+        const int col,
+        double initial_distance,
+        const double min_distance,
+        const double tmax,
+        const double conservative_rescaling)
+    {
+        using Kernel = CCDKernel<Candidate>;
+        constexpr int N = Kernel::NUM_VERTICES;
+        constexpr int K = Kernel::NUM_FIRST_VERTICES;
+        using Stencil = Eigen::Matrix<double, 3, N>;
+
+        const Stencil x0 = x0_block.template middleCols<N>(col);
+        const Stencil dx = x1_block.template middleCols<N>(col) - x0;
+
+        if (initial_distance < 0) {
+            initial_distance = std::sqrt(Kernel::distance_squared(x0));
+            if (initial_distance > min_distance
+                && compute_additive_toi_lower_bound(
+                       initial_distance, dx, min_distance,
+                       conservative_rescaling)
+                    >= tmax) {
+                return CCDFilter::TOI_LOWER_BOUND;
+            }
+        }
+
+        if (initial_distance <= min_distance) {
+            return CCDFilter::NONE; // ccd() reports an impact at t = 0
+        }
+
+        // Only the trajectory up to tmax matters.
+        const Stencil x1 = x0 + tmax * dx;
+
+        // ccd() can only report an impact once the distance drops to the
+        // minimum effective distance of ccd_strategy, which is at most this.
+        const double threshold = min_distance
+            + (1 - conservative_rescaling) * (initial_distance - min_distance);
+
+        std::array<Eigen::Vector3d, 5> axes {
+            { Eigen::Vector3d::UnitX(), Eigen::Vector3d::UnitY(),
+              Eigen::Vector3d::UnitZ(), Kernel::separating_axis(x0),
+              Kernel::separating_axis(x1) }
+        };
+        for (Eigen::Vector3d& axis : axes) {
+            const double norm = axis.norm();
+            if (norm == 0) {
+                continue; // Degenerate stencil
+            }
+            axis /= norm;
+            if (separating_axis_filter(
+                    axis, x0.template leftCols<K>(), x1.template leftCols<K>(),
+                    x0.template rightCols<N - K>(),
+                    x1.template rightCols<N - K>(), threshold)) {
+                return CCDFilter::SEPARATING_AXIS;
+            }
+        }
+
+        if (Kernel::sign_of_volume(x0, x1, threshold)) {
+            return CCDFilter::SIGN_OF_VOLUME;
+        }
+
+        return CCDFilter::NONE;
+    }
+} // namespace
+
+void CCDFilterCounts::record(const CCDFilter filter)
+{
+    switch (filter) {
+    case CCDFilter::NONE:
+        root_finding++;
+        break;
+    case CCDFilter::TOI_LOWER_BOUND:
+        toi_lower_bound++;
+        break;
+    case CCDFilter::SEPARATING_AXIS:
+        separating_axis++;
+        break;
+    case CCDFilter::SIGN_OF_VOLUME:
+        sign_of_volume++;
+        break;
+    }
+}
+
+CCDFilterCounts& CCDFilterCounts::operator+=(const CCDFilterCounts& other)
+{
+    toi_lower_bound += other.toi_lower_bound;
+    separating_axis += other.separating_axis;
+    sign_of_volume += other.sign_of_volume;
+    root_finding += other.root_finding;
+    return *this;
+}
+
+NarrowPhaseCCDBlock::NarrowPhaseCCDBlock(
+    const Candidates& candidates,
+    const CollisionMesh& mesh,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
+    const size_t* indices,
+    const size_t num_indices)
+    : m_size(num_indices)
+{
+    assert(num_indices <= NARROW_PHASE_CCD_BLOCK_SIZE);
+    assert(vertices_t0.rows() == mesh.num_vertices());
+    assert(vertices_t1.rows() == mesh.num_vertices());
+
+    if (vertices_t0.cols() == 2) {
+        m_vertices_t0.row(2).setZero();
+        m_vertices_t1.row(2).setZero();
+    }
+
+    // Resolve the type of each candidate from the contiguous index ranges of
+    // the typed arrays instead of going through Candidates::operator[].
+    const size_t ev_offset = candidates.vv_candidates.size();
+    const size_t ee_offset = ev_offset + candidates.ev_candidates.size();
+    const size_t fv_offset = ee_offset + candidates.ee_candidates.size();
+    const size_t end = fv_offset + candidates.fv_candidates.size();
+
+    for (size_t i = 0; i < num_indices; i++) {
+        const size_t ci = indices[i];
+        const int col = 4 * i;
+        if (ci < ev_offset) {
+            m_types[i] = CandidateType::VERTEX_VERTEX;
+            gather(
+                candidates.vv_candidates[ci], mesh, vertices_t0, vertices_t1,
+                col, m_vertices_t0, m_vertices_t1);
+        } else if (ci < ee_offset) {
+            m_types[i] = CandidateType::EDGE_VERTEX;
+            gather(
+                candidates.ev_candidates[ci - ev_offset], mesh, vertices_t0,
+                vertices_t1, col, m_vertices_t0, m_vertices_t1);
+        } else if (ci < fv_offset) {
+            m_types[i] = CandidateType::EDGE_EDGE;
+            gather(
+                candidates.ee_candidates[ci - ee_offset], mesh, vertices_t0,
+                vertices_t1, col, m_vertices_t0, m_vertices_t1);
+        } else if (ci < end) {
+            m_types[i] = CandidateType::FACE_VERTEX;
+            gather(
+                candidates.fv_candidates[ci - fv_offset], mesh, vertices_t0,
+                vertices_t1, col, m_vertices_t0, m_vertices_t1);
+        } else {
+            throw std::out_of_range("Candidate index is out of range!");
+        }
+    }
+}
+
+double NarrowPhaseCCDBlock::initial_distance(const size_t i) const
+{
+    assert(i < m_size);
+
+    const int col = 4 * i;
+    switch (m_types[i]) {
+    case CandidateType::VERTEX_VERTEX:
+        return run_initial_distance<VertexVertexCandidate>(m_vertices_t0, col);
+    case CandidateType::EDGE_VERTEX:
+        return run_initial_distance<EdgeVertexCandidate>(m_vertices_t0, col);
+    case CandidateType::EDGE_EDGE:
+        return run_initial_distance<EdgeEdgeCandidate>(m_vertices_t0, col);
+    case CandidateType::FACE_VERTEX:
+        return run_initial_distance<FaceVertexCandidate>(m_vertices_t0, col);
+    default:
+        throw std::runtime_error("Unknown candidate type!");
+    }
+}
+
+double NarrowPhaseCCDBlock::toi_lower_bound(
+    const size_t i,
+    const double initial_distance,
+    const double min_distance,
+    const double conservative_rescaling) const
+{
+    assert(i < m_size);
+
+    const int col = 4 * i;
+    switch (m_types[i]) {
+    case CandidateType::VERTEX_VERTEX:
+        return run_toi_lower_bound<VertexVertexCandidate>(
+            m_vertices_t0, m_vertices_t1, col, initial_distance,
+            min_distance, conservative_rescaling);
+    case CandidateType::EDGE_VERTEX:
+        return run_toi_lower_bound<EdgeVertexCandidate>(
+            m_vertices_t0, m_vertices_t1, col, initial_distance,
+            min_distance, conservative_rescaling);
+    case CandidateType::EDGE_EDGE:
+        return run_toi_lower_bound<EdgeEdgeCandidate>(
+            m_vertices_t0, m_vertices_t1, col, initial_distance,
+            min_distance, conservative_rescaling);
+    case CandidateType::FACE_VERTEX:
+        return run_toi_lower_bound<FaceVertexCandidate>(
+            m_vertices_t0, m_vertices_t1, col, initial_distance,
+            min_distance, conservative_rescaling);
+    default:
+        throw std::runtime_error("Unknown candidate type!");
+    }
+}
+
+CCDFilter NarrowPhaseCCDBlock::filter(
+    const size_t i,
+    const double min_distance,
+    const double tmax,
+    const double conservative_rescaling) const
+{
+    return filter_with_initial_distance(
+        i, /*initial_distance=*/-1, min_distance, tmax,
+        conservative_rescaling);
+}
+
+CCDFilter NarrowPhaseCCDBlock::filter_with_initial_distance(
+    const size_t i,
+    const double initial_distance,
+    const double min_distance,
+    const double tmax,
+    const double conservative_rescaling) const
+{
+    assert(i < m_size);
+
+    const int col = 4 * i;
+    switch (m_types[i]) {
+    case CandidateType::VERTEX_VERTEX:
+        return run_filters<VertexVertexCandidate>(
+            m_vertices_t0, m_vertices_t1, col, initial_distance,
+            min_distance, tmax, conservative_rescaling);
+    case CandidateType::EDGE_VERTEX:
+        return run_filters<EdgeVertexCandidate>(
+            m_vertices_t0, m_vertices_t1, col, initial_distance,
+            min_distance, tmax, conservative_rescaling);
+    case CandidateType::EDGE_EDGE:
+        return run_filters<EdgeEdgeCandidate>(
+            m_vertices_t0, m_vertices_t1, col, initial_distance,
+            min_distance, tmax, conservative_rescaling);
+    case CandidateType::FACE_VERTEX:
+        return run_filters<FaceVertexCandidate>(
+            m_vertices_t0, m_vertices_t1, col, initial_distance,
+            min_distance, tmax, conservative_rescaling);
+    default:
+        throw std::runtime_error("Unknown candidate type!");
+    }
+}
+
+bool NarrowPhaseCCDBlock::ccd(
+    const size_t i,
+    double& toi,
+    const double min_distance,
+    const double tmax,
+    const double tolerance,
+    const long max_iterations,
+    const double conservative_rescaling) const
+{
+    assert(i < m_size);
+
+    const CCDParameters parameters { min_distance, tmax, tolerance,
+                                     max_iterations, conservative_rescaling };
+
+    const int col = 4 * i;
+    switch (m_types[i]) {
+    case CandidateType::VERTEX_VERTEX:
+        return run_kernel<VertexVertexCandidate>(
+            m_vertices_t0, m_vertices_t1, col, toi, parameters);
+    case CandidateType::EDGE_VERTEX:
+        return run_kernel<EdgeVertexCandidate>(
+            m_vertices_t0, m_vertices_t1, col, toi, parameters);
+    case CandidateType::EDGE_EDGE:
+        return run_kernel<EdgeEdgeCandidate>(
+            m_vertices_t0, m_vertices_t1, col, toi, parameters);
+    case CandidateType::FACE_VERTEX:
+        return run_kernel<FaceVertexCandidate>(
+            m_vertices_t0, m_vertices_t1, col, toi, parameters);
+    default:
+        throw std::runtime_error("Unknown candidate type!");
+    }
+}
+
+std::vector<double> narrow_phase_ccd(
+    const Candidates& candidates,
+    const CollisionMesh& mesh,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
+    const double min_distance,
+    const double tmax,
+    const double tolerance,
+    const long max_iterations,
+    const double conservative_rescaling)
+{
+    std::vector<double> tois(candidates.size());
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(
+            0, candidates.size(), NARROW_PHASE_CCD_BLOCK_SIZE),
+        [&](const tbb::blocked_range<size_t>& r) {
+            std::array<size_t, NARROW_PHASE_CCD_BLOCK_SIZE> indices;
+            for (size_t begin = r.begin(); begin < r.end();
+                 begin += NARROW_PHASE_CCD_BLOCK_SIZE) {
+                const size_t n =
+                    std::min(NARROW_PHASE_CCD_BLOCK_SIZE, r.end() - begin);
+                std::iota(indices.begin(), indices.begin() + n, begin);
+
+                const NarrowPhaseCCDBlock block(
+                    candidates, mesh, vertices_t0, vertices_t1,
+                    indices.data(), n);
+
+                for (size_t i = 0; i < n; i++) {
+                    double toi;
+                    if (block.filter(
+                            i, min_distance, tmax, conservative_rescaling)
+                        != CCDFilter::NONE) {
+                        tois[begin + i] =
+                            std::numeric_limits<double>::infinity();
+                        continue;
+                    }
+                    tois[begin + i] = block.ccd(
+                                          i, toi, min_distance, tmax,
+                                          tolerance, max_iterations,
+                                          conservative_rescaling)
+                        ? toi
+                        : std::numeric_limits<double>::infinity();
+                }
+            }
+        });
+
+    return tois;
+}
+
+} // namespace ipc
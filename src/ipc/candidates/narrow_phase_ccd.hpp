@@ -0,0 +1,193 @@
+#pragma once
+
+#include <ipc/candidates/candidates.hpp>
+#include <ipc/ccd/ccd.hpp>
+
+#include <Eigen/Core>
+
+#include <array>
+#include <vector>
+
+namespace ipc {
+
+/// Maximum number of candidates processed together by the batched narrow
+/// phase.
+static constexpr size_t NARROW_PHASE_CCD_BLOCK_SIZE = 64;
+
+/// @brief Conservative filters applied to a candidate before root finding.
+enum class CCDFilter {
+    /// The candidate was not rejected and needs root finding.
+    NONE,
+    /// The additive CCD lower bound on the time of impact exceeds tmax.
+    TOI_LOWER_BOUND,
+    /// An axis separates the swept primitives.
+    SEPARATING_AXIS,
+    /// The signed volume of the stencil keeps a constant sign.
+    SIGN_OF_VOLUME
+};
+
+/// @brief Number of candidates rejected by each conservative CCD filter.
+struct CCDFilterCounts {
+    /// Number of candidates rejected by the ToI lower bound.
+    size_t toi_lower_bound = 0;
+    /// Number of candidates rejected by the separating-axis test.
+    size_t separating_axis = 0;
+    /// Number of candidates rejected by the sign-of-volume test.
+    size_t sign_of_volume = 0;
+    /// Number of candidates passed on to root finding.
+    size_t root_finding = 0;
+
+    /// @brief Count a candidate by the filter that rejected it.
+    /// @param filter Filter that rejected the candidate (NONE if none did).
+    void record(const CCDFilter filter);
+
+    CCDFilterCounts& operator+=(const CCDFilterCounts& other);
+};
+
+/// @brief Work saved by the ToI-ordered narrow phase of Candidates::compute_collision_free_stepsize.
+struct CCDStepsizeStats {
+    /// Number of candidates skipped because their ToI lower bound was at least the current step size.
+    size_t num_skipped = 0;
+    /// Number of candidates checked by the conservative filters (and root finding if they survived).
+    size_t num_checked = 0;
+    /// Time spent checking candidates, summed over all threads (in seconds).
+    double check_time = 0;
+
+    /// @brief Estimated time the skipped candidates would have taken to check (in seconds).
+    /// @note Assumes a skipped candidate costs as much as the average checked one.
+    double estimated_time_saved() const
+    {
+        return num_checked == 0 ? 0 : (check_time * num_skipped / num_checked);
+    }
+};
+
+/// @brief A block of continuous collision candidates gathered for the narrow phase.
+/// @note The stencil positions of the block are gathered up front into contiguous column blocks, and each query calls its root finder through a statically dispatched kernel, bypassing the virtual ContinuousCollisionCandidate::dof() and ccd() calls.
+class NarrowPhaseCCDBlock {
+public:
+    /// @brief Gather the stencil positions of a block of candidates.
+    /// @param candidates The candidates to check.
+    /// @param mesh The collision mesh.
+    /// @param vertices_t0 Surface vertex starting positions (rowwise).
+    /// @param vertices_t1 Surface vertex ending positions (rowwise).
+    /// @param indices Indices (as in Candidates::operator[]) of the candidates in the block.
+    /// @param num_indices Number of candidates in the block (at most NARROW_PHASE_CCD_BLOCK_SIZE).
+    NarrowPhaseCCDBlock(
+        const Candidates& candidates,
+        const CollisionMesh& mesh,
+        ConstRef<Eigen::MatrixXd> vertices_t0,
+        ConstRef<Eigen::MatrixXd> vertices_t1,
+        const size_t* indices,
+        const size_t num_indices);
+
+    /// @brief Get the number of candidates in the block.
+    size_t size() const { return m_size; }
+
+    /// @brief Compute the distance between the i-th candidate's primitives at the start of the step.
+    /// @param i Index of the candidate in the block.
+    /// @return The initial distance.
+    double initial_distance(const size_t i) const;
+
+    /// @brief Compute the additive lower bound on the i-th candidate's time of impact.
+    /// @param i Index of the candidate in the block.
+    /// @param initial_distance Distance between the candidate's primitives at t = 0 (see initial_distance()).
+    /// @param min_distance Minimum separation distance between primitives.
+    /// @param conservative_rescaling Conservative rescaling value used by ccd().
+    /// @return A lower bound on the time of impact (infinity if the stencil only translates).
+    double toi_lower_bound(
+        const size_t i,
+        const double initial_distance,
+        const double min_distance = 0.0,
+        const double conservative_rescaling =
+            DEFAULT_CCD_CONSERVATIVE_RESCALING) const;
+
+    /// @brief Apply conservative filters to the i-th candidate of the block.
+    /// @note The filters only reject a candidate if its primitives provably stay farther apart than the minimum effective distance used by ccd() (see ccd_strategy) up to tmax. The cheapest filters are applied first.
+    /// @param[in] i Index of the candidate in the block.
+    /// @param[in] min_distance Minimum separation distance between primitives.
+    /// @param[in] tmax Maximum time (normalized) to look for collisions.
+    /// @param[in] conservative_rescaling Conservative rescaling value used by ccd().
+    /// @return The filter that rejected the candidate, or CCDFilter::NONE if it needs root finding.
+    CCDFilter filter(
+        const size_t i,
+        const double min_distance = 0.0,
+        const double tmax = 1.0,
+        const double conservative_rescaling =
+            DEFAULT_CCD_CONSERVATIVE_RESCALING) const;
+
+    /// @brief Apply the geometric filters to the i-th candidate of the block given its initial distance.
+    /// @note The ToI lower bound is not checked, so this is for callers that already compared a precomputed bound against tmax.
+    /// @param[in] i Index of the candidate in the block.
+    /// @param[in] initial_distance Distance between the candidate's primitives at t = 0.
+    /// @param[in] min_distance Minimum separation distance between primitives.
+    /// @param[in] tmax Maximum time (normalized) to look for collisions.
+    /// @param[in] conservative_rescaling Conservative rescaling value used by ccd().
+    /// @return The filter that rejected the candidate, or CCDFilter::NONE if it needs root finding.
+    CCDFilter filter_with_initial_distance(
+        const size_t i,
+        const double initial_distance,
+        const double min_distance = 0.0,
+        const double tmax = 1.0,
+        const double conservative_rescaling =
+            DEFAULT_CCD_CONSERVATIVE_RESCALING) const;
+
+    /// @brief Perform narrow-phase CCD on the i-th candidate of the block.
+    /// @param[in] i Index of the candidate in the block.
+    /// @param[out] toi Computed time of impact (normalized).
+    /// @param[in] min_distance Minimum separation distance between primitives.
+    /// @param[in] tmax Maximum time (normalized) to look for collisions.
+    /// @param[in] tolerance CCD tolerance used by Tight-Inclusion CCD.
+    /// @param[in] max_iterations Maximum iterations used by Tight-Inclusion CCD.
+    /// @param[in] conservative_rescaling Conservative rescaling value used to avoid taking steps exactly to impact.
+    /// @return If the candidate had a collision over the linear trajectory.
+    bool ccd(
+        const size_t i,
+        double& toi,
+        const double min_distance = 0.0,
+        const double tmax = 1.0,
+        const double tolerance = DEFAULT_CCD_TOLERANCE,
+        const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
+        const double conservative_rescaling =
+            DEFAULT_CCD_CONSERVATIVE_RESCALING) const;
+
+private:
+    enum class CandidateType {
+        VERTEX_VERTEX,
+        EDGE_VERTEX,
+        EDGE_EDGE,
+        FACE_VERTEX
+    };
+
+    /// @brief Stencil positions at the start of the step (columns 4i to 4i+3 hold candidate i).
+    Eigen::Matrix<double, 3, 4 * NARROW_PHASE_CCD_BLOCK_SIZE> m_vertices_t0;
+    /// @brief Stencil positions at the end of the step (columns 4i to 4i+3 hold candidate i).
+    Eigen::Matrix<double, 3, 4 * NARROW_PHASE_CCD_BLOCK_SIZE> m_vertices_t1;
+    /// @brief Type of each candidate in the block.
+    std::array<CandidateType, NARROW_PHASE_CCD_BLOCK_SIZE> m_types;
+    /// @brief Number of candidates in the block.
+    size_t m_size;
+};
+
+/// @brief Compute the time of impact of every candidate using the batched narrow phase.
+/// @param candidates The candidates to check.
+/// @param mesh The collision mesh.
+/// @param vertices_t0 Surface vertex starting positions (rowwise).
+/// @param vertices_t1 Surface vertex ending positions (rowwise).
+/// @param min_distance The minimum distance allowable between any two elements.
+/// @param tmax The maximum time to check for collisions.
+/// @param tolerance The tolerance for the CCD algorithm.
+/// @param max_iterations The maximum number of iterations for the CCD algorithm.
+/// @param conservative_rescaling The conservative rescaling of the time of impact.
+/// @return Time of impact of each candidate in the order of Candidates::operator[] (infinity if there is no impact before tmax).
+std::vector<double> narrow_phase_ccd(
+    const Candidates& candidates,
+    const CollisionMesh& mesh,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
+    const double min_distance = 0.0,
+    const double tmax = 1.0,
+    const double tolerance = DEFAULT_CCD_TOLERANCE,
+    const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
+    const double conservative_rescaling = DEFAULT_CCD_CONSERVATIVE_RESCALING);
+
+} // namespace ipc
@@ -0,0 +1,120 @@
+#include "ccd_filters.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace ipc {
+
+namespace {
+    /// Multiple of machine epsilon used to bound the rounding error of the
+    /// filters' projections and determinants relative to their inputs.
+    constexpr double ROUNDING_ERROR_SCALE =
+        16 * std::numeric_limits<double>::epsilon();
+} // namespace
+
+double compute_additive_toi_lower_bound(
+    const double initial_distance,
+    const Eigen::Ref<const Eigen::MatrixXd>& displacements,
+    const double min_distance,
+    const double conservative_rescaling)
+{
+    if (initial_distance <= min_distance) {
+        return 0;
+    }
+
+    // Subtract the mean displacement because distances are translation
+    // invariant.
+    VectorMax3d mean = VectorMax3d::Zero(displacements.rows());
+    for (int i = 0; i < displacements.cols(); i++) {
+        mean += displacements.col(i);
+    }
+    mean /= displacements.cols();
+
+    double max_displacement_sq = 0;
+    for (int i = 0; i < displacements.cols(); i++) {
+        max_displacement_sq = std::max(
+            max_displacement_sq, (displacements.col(i) - mean).squaredNorm());
+    }
+
+    if (max_displacement_sq == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    // tₗ = η ⋅ (d - ξ) / lₚ where lₚ ≤ 2 max‖Δxᵢ - mean(Δx)‖
+    return conservative_rescaling * (initial_distance - min_distance)
+        / (2 * std::sqrt(max_displacement_sq));
+}
+
+bool separating_axis_filter(
+    const Eigen::Vector3d& axis,
+    const Eigen::Ref<const Eigen::Matrix<double, 3, Eigen::Dynamic>>& a_t0,
+    const Eigen::Ref<const Eigen::Matrix<double, 3, Eigen::Dynamic>>& a_t1,
+    const Eigen::Ref<const Eigen::Matrix<double, 3, Eigen::Dynamic>>& b_t0,
+    const Eigen::Ref<const Eigen::Matrix<double, 3, Eigen::Dynamic>>& b_t1,
+    const double threshold)
+{
+    assert(a_t0.cols() == a_t1.cols() && b_t0.cols() == b_t1.cols());
+
+    // Gap between the projected intervals with the first set below the second
+    const auto gap = [&](const auto& below, const auto& above) {
+        return (axis.transpose() * above).minCoeff()
+            - (axis.transpose() * below).maxCoeff();
+    };
+
+    // Only trust gaps larger than the rounding error of the projections.
+    const double max_coordinate = std::max(
+        { a_t0.cwiseAbs().maxCoeff(), a_t1.cwiseAbs().maxCoeff(),
+          b_t0.cwiseAbs().maxCoeff(), b_t1.cwiseAbs().maxCoeff() });
+    const double min_gap = threshold + ROUNDING_ERROR_SCALE * max_coordinate;
+
+    return (gap(a_t0, b_t0) > min_gap && gap(a_t1, b_t1) > min_gap)
+        || (gap(b_t0, a_t0) > min_gap && gap(b_t1, a_t1) > min_gap);
+}
+
+bool sign_of_volume_filter(
+    const Eigen::Vector3d& a_t0,
+    const Eigen::Vector3d& a_t1,
+    const Eigen::Vector3d& b_t0,
+    const Eigen::Vector3d& b_t1,
+    const Eigen::Vector3d& c_t0,
+    const Eigen::Vector3d& c_t1,
+    const double threshold)
+{
+    const auto det = [](const Eigen::Vector3d& a, const Eigen::Vector3d& b,
+                        const Eigen::Vector3d& c) { return a.cross(b).dot(c); };
+
+    // Bernstein coefficients of the cubic det(a(t), b(t), c(t))
+    const std::array<double, 4> volume { {
+        det(a_t0, b_t0, c_t0),
+        (det(a_t1, b_t0, c_t0) + det(a_t0, b_t1, c_t0) + det(a_t0, b_t0, c_t1))
+            / 3,
+        (det(a_t0, b_t1, c_t1) + det(a_t1, b_t0, c_t1) + det(a_t1, b_t1, c_t0))
+            / 3,
+        det(a_t1, b_t1, c_t1),
+    } };
+
+    // The quadratic a(t) × b(t) lies in the convex hull of its Bernstein
+    // coefficients, so its norm is bounded by theirs.
+    const double max_area = std::max({
+        a_t0.cross(b_t0).norm(),
+        (a_t0.cross(b_t1) + a_t1.cross(b_t0)).norm() / 2,
+        a_t1.cross(b_t1).norm(),
+    });
+
+    // Only trust volumes larger than the rounding error of the determinants.
+    const double max_volume_scale = std::max(a_t0.norm(), a_t1.norm())
+        * std::max(b_t0.norm(), b_t1.norm())
+        * std::max(c_t0.norm(), c_t1.norm());
+    const double min_volume_magnitude =
+        threshold * max_area + ROUNDING_ERROR_SCALE * max_volume_scale;
+
+    const auto [min_volume, max_volume] =
+        std::minmax_element(volume.begin(), volume.end());
+
+    return *min_volume > min_volume_magnitude
+        || *max_volume < -min_volume_magnitude;
+}
+
+} // namespace ipc
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <ipc/utils/eigen_ext.hpp>
+
+namespace ipc {
+
+/// @brief Compute a conservative lower bound on the time of impact using the additive CCD bound of [Li et al. 2021].
+/// @note The distance between the stencil's primitives can shrink at most as fast as twice the largest vertex displacement relative to the stencil's mean displacement.
+/// @param initial_distance Distance between the primitives at the start of the time step.
+/// @param displacements Displacement of each stencil vertex (columnwise).
+/// @param min_distance Minimum separation distance between primitives.
+/// @param conservative_rescaling Conservative rescaling value used by the CCD.
+/// @return A lower bound on the time of impact. Zero if the stencil is initially closer than min_distance and infinity if the stencil is not moving.
+double compute_additive_toi_lower_bound(
+    const double initial_distance,
+    const Eigen::Ref<const Eigen::MatrixXd>& displacements,
+    const double min_distance,
+    const double conservative_rescaling);
+
+/// @brief Conservative separating-axis test on the linear trajectories of two primitives over t ∈ [0, 1].
+/// @note Projections onto a fixed axis are linear in t, so the gap between the projected intervals of the primitives is concave in t and attains its minimum at t = 0 or t = 1.
+/// @param axis Unit-length axis to project onto.
+/// @param a_t0 Vertices of the first primitive at t = 0 (columnwise).
+/// @param a_t1 Vertices of the first primitive at t = 1 (columnwise).
+/// @param b_t0 Vertices of the second primitive at t = 0 (columnwise).
+/// @param b_t1 Vertices of the second primitive at t = 1 (columnwise).
+/// @param threshold Separation distance to test against.
+/// @return True if the projections stay farther apart than threshold for all t ∈ [0, 1], which implies the primitives do too.
+bool separating_axis_filter(
+    const Eigen::Vector3d& axis,
+    const Eigen::Ref<const Eigen::Matrix<double, 3, Eigen::Dynamic>>& a_t0,
+    const Eigen::Ref<const Eigen::Matrix<double, 3, Eigen::Dynamic>>& a_t1,
+    const Eigen::Ref<const Eigen::Matrix<double, 3, Eigen::Dynamic>>& b_t0,
+    const Eigen::Ref<const Eigen::Matrix<double, 3, Eigen::Dynamic>>& b_t1,
+    const double threshold);
+
+/// @brief Conservative sign-of-volume test on three linearly interpolated vectors a(t), b(t), and c(t) over t ∈ [0, 1].
+/// @note |det(a, b, c)| / ‖a × b‖ is the distance of c from the plane spanned by a and b. The cubic det(a, b, c) and the quadratic a × b are bounded by their Bernstein coefficients. With a and b the edges of a triangle (or two edges) and c the offset of the point (or second edge), this bounds the distance to the triangle's plane (or between the edges' lines) from below.
+/// @param a_t0 First vector at t = 0.
+/// @param a_t1 First vector at t = 1.
+/// @param b_t0 Second vector at t = 0.
+/// @param b_t1 Second vector at t = 1.
+/// @param c_t0 Third vector at t = 0.
+/// @param c_t1 Third vector at t = 1.
+/// @param threshold Separation distance to test against.
+/// @return True if the volume keeps a constant sign and c stays farther than threshold from the plane spanned by a and b for all t ∈ [0, 1].
+bool sign_of_volume_filter(
+    const Eigen::Vector3d& a_t0,
+    const Eigen::Vector3d& a_t1,
+    const Eigen::Vector3d& b_t0,
+    const Eigen::Vector3d& b_t1,
+    const Eigen::Vector3d& c_t0,
+    const Eigen::Vector3d& c_t1,
+    const double threshold);
+
+} // namespace ipc
@@ -9,7 +9,7 @@
 namespace ipc {
 
 CollisionMesh::CollisionMesh(
-    const Eigen::MatrixXd& rest_positions,
+    ConstRef<Eigen::MatrixXd> rest_positions,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
     const Eigen::SparseMatrix<double>& displacement_map)
@@ -24,7 +24,7 @@ CollisionMesh::CollisionMesh(
 
 CollisionMesh::CollisionMesh(
     const std::vector<bool>& include_vertex,
-    const Eigen::MatrixXd& full_rest_positions,
+    ConstRef<Eigen::MatrixXd> full_rest_positions,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
     const Eigen::SparseMatrix<double>& displacement_map)
@@ -376,7 +376,7 @@ void CollisionMesh::init_area_jacobians()
 // ============================================================================/
 
 Eigen::MatrixXd
-CollisionMesh::vertices(const Eigen::MatrixXd& full_positions) const
+CollisionMesh::vertices(ConstRef<Eigen::MatrixXd> full_positions) const
 {
     // full_U = full_V - full_V_rest
     assert(full_positions.rows() == full_num_vertices());
@@ -385,14 +385,14 @@ CollisionMesh::vertices(const Eigen::MatrixXd& full_positions) const
 }
 
 Eigen::MatrixXd CollisionMesh::displace_vertices(
-    const Eigen::MatrixXd& full_displacements) const
+    ConstRef<Eigen::MatrixXd> full_displacements) const
 {
     // V_rest + S * T * full_U; m_displacement_map = S * T
     return m_rest_positions + map_displacements(full_displacements);
 }
 
 Eigen::MatrixXd CollisionMesh::map_displacements(
-    const Eigen::MatrixXd& full_displacements) const
+    ConstRef<Eigen::MatrixXd> full_displacements) const
 {
     assert(m_displacement_map.cols() == full_displacements.rows());
     assert(full_displacements.cols() == dim());
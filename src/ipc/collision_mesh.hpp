@@ -1,5 +1,6 @@
 #pragma once
 
+#include <ipc/utils/eigen_ext.hpp>
 #include <ipc/utils/unordered_map_and_set.hpp>
 
 #include <Eigen/Core>
@@ -20,7 +21,7 @@ public:
     /// @param faces The faces of the collision mesh (#F × 3).
     /// @param displacement_map The displacement mapping from displacements on the full mesh to the collision mesh.
     CollisionMesh(
-        const Eigen::MatrixXd& rest_positions,
+        ConstRef<Eigen::MatrixXd> rest_positions,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         const Eigen::SparseMatrix<double>& displacement_map =
@@ -34,7 +35,7 @@ public:
     /// @param displacement_map The displacement mapping from displacements on the full mesh to the collision mesh.
     CollisionMesh(
         const std::vector<bool>& include_vertex,
-        const Eigen::MatrixXd& full_rest_positions,
+        ConstRef<Eigen::MatrixXd> full_rest_positions,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         const Eigen::SparseMatrix<double>& displacement_map =
@@ -46,7 +47,7 @@ public:
     /// @param faces The face matrix of mesh (#F × 3).
     /// @return Constructed CollisionMesh.
     static CollisionMesh build_from_full_mesh(
-        const Eigen::MatrixXd& full_rest_positions,
+        ConstRef<Eigen::MatrixXd> full_rest_positions,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces)
     {
@@ -126,19 +127,19 @@ public:
     /// @brief Compute the vertex positions from the positions of the full mesh.
     /// @param full_positions The vertex positions of the full mesh (#FV × dim).
     /// @return The vertex positions of the collision mesh (#V × dim).
-    Eigen::MatrixXd vertices(const Eigen::MatrixXd& full_positions) const;
+    Eigen::MatrixXd vertices(ConstRef<Eigen::MatrixXd> full_positions) const;
 
     /// @brief Compute the vertex positions from vertex displacements on the full mesh.
     /// @param full_displacements The vertex displacements on the full mesh (#FV × dim).
     /// @return The vertex positions of the collision mesh (#V × dim).
     Eigen::MatrixXd
-    displace_vertices(const Eigen::MatrixXd& full_displacements) const;
+    displace_vertices(ConstRef<Eigen::MatrixXd> full_displacements) const;
 
     /// @brief Map vertex displacements on the full mesh to vertex displacements on the collision mesh.
     /// @param full_displacements The vertex displacements on the full mesh (#FV × dim).
     /// @return The vertex displacements on the collision mesh (#V × dim).
     Eigen::MatrixXd
-    map_displacements(const Eigen::MatrixXd& full_displacements) const;
+    map_displacements(ConstRef<Eigen::MatrixXd> full_displacements) const;
 
     /// @brief Map a vertex ID to the corresponding vertex ID in the full mesh.
     /// @param id Vertex ID in the collision mesh.
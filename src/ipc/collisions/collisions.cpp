@@ -28,7 +28,7 @@ namespace {
     std::vector<VertexVertexCandidate>
     element_vertex_to_vertex_vertex_candidates(
         const Eigen::MatrixXi& elements,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const std::vector<Candidate>& candidates,
         const std::function<bool(double)>& is_active)
     {
@@ -54,7 +54,7 @@ namespace {
 
     std::vector<VertexVertexCandidate> edge_vertex_to_vertex_vertex_candidates(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const std::vector<EdgeVertexCandidate>& ev_candidates,
         const std::function<bool(double)>& is_active)
     {
@@ -64,7 +64,7 @@ namespace {
 
     std::vector<VertexVertexCandidate> face_vertex_to_vertex_vertex_candidates(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const std::vector<FaceVertexCandidate>& fv_candidates,
         const std::function<bool(double)>& is_active)
     {
@@ -74,7 +74,7 @@ namespace {
 
     std::vector<EdgeVertexCandidate> face_vertex_to_edge_vertex_candidates(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const std::vector<FaceVertexCandidate>& fv_candidates,
         const std::function<bool(double)>& is_active)
     {
@@ -103,7 +103,7 @@ namespace {
 
     std::vector<EdgeVertexCandidate> edge_edge_to_edge_vertex_candidates(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const std::vector<EdgeEdgeCandidate>& ee_candidates,
         const std::function<bool(double)>& is_active)
     {
@@ -139,7 +139,7 @@ namespace {
 
 void Collisions::build(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const double dhat,
     const double dmin,
     const BroadPhaseMethod broad_phase_method)
@@ -157,7 +157,7 @@ void Collisions::build(
 void Collisions::build(
     const Candidates& candidates,
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const double dhat,
     const double dmin)
 {
@@ -173,7 +173,8 @@ void Collisions::build(
     };
 
     tbb::enumerable_thread_specific<CollisionsBuilder> storage(
-        use_convergent_formulation(), are_shape_derivatives_enabled());
+        use_convergent_formulation(), are_shape_derivatives_enabled(),
+        use_batch_culling());
 
     tbb::parallel_for(
         tbb::blocked_range<size_t>(size_t(0), candidates.vv_candidates.size()),
@@ -326,7 +327,7 @@ void Collisions::set_are_shape_derivatives_enabled(
 
 // NOTE: Actually distance squared
 double Collisions::compute_minimum_distance(
-    const CollisionMesh& mesh, const Eigen::MatrixXd& vertices) const
+    const CollisionMesh& mesh, ConstRef<Eigen::MatrixXd> vertices) const
 {
     assert(vertices.rows() == mesh.num_vertices());
 
@@ -466,7 +467,7 @@ bool Collisions::is_plane_vertex(size_t i) const
 }
 
 std::string Collisions::to_string(
-    const CollisionMesh& mesh, const Eigen::MatrixXd& vertices) const
+    const CollisionMesh& mesh, ConstRef<Eigen::MatrixXd> vertices) const
 {
     std::stringstream ss;
     for (const auto& vv : vv_collisions) {
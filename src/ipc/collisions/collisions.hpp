@@ -32,7 +32,7 @@ public:
     /// @param broad_phase_method Broad-phase method to use.
     void build(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const double dhat,
         const double dmin = 0,
         const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD);
@@ -46,7 +46,7 @@ public:
     void build(
         const Candidates& candidates,
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const double dhat,
         const double dmin = 0);
 
@@ -57,7 +57,7 @@ public:
     /// @param vertices Vertices of the collision mesh.
     /// @returns The minimum distance between any non-adjacent elements.
     double compute_minimum_distance(
-        const CollisionMesh& mesh, const Eigen::MatrixXd& vertices) const;
+        const CollisionMesh& mesh, ConstRef<Eigen::MatrixXd> vertices) const;
 
     // ------------------------------------------------------------------------
 
@@ -132,8 +132,20 @@ public:
     void
     set_are_shape_derivatives_enabled(const bool are_shape_derivatives_enabled);
 
-    std::string
-    to_string(const CollisionMesh& mesh, const Eigen::MatrixXd& vertices) const;
+    /// @brief Get if the face-vertex candidates are culled with batched distance lower bounds while building.
+    /// @return If the candidates are culled with batched distance lower bounds.
+    bool use_batch_culling() const { return m_use_batch_culling; }
+
+    /// @brief Set if the face-vertex candidates are culled with batched distance lower bounds while building.
+    /// @note The cull only skips candidates that the scalar distance checks would reject, so this does not change the built collisions.
+    /// @param use_batch_culling If the candidates should be culled with batched distance lower bounds.
+    void set_use_batch_culling(const bool use_batch_culling)
+    {
+        m_use_batch_culling = use_batch_culling;
+    }
+
+    std::string to_string(
+        const CollisionMesh& mesh, ConstRef<Eigen::MatrixXd> vertices) const;
 
 public:
     std::vector<VertexVertexCollision> vv_collisions;
@@ -145,6 +157,7 @@ public:
 protected:
     bool m_use_convergent_formulation = false;
     bool m_are_shape_derivatives_enabled = false;
+    bool m_use_batch_culling = true;
 };
 
 } // namespace ipc
@@ -1,5 +1,6 @@
 #include "collisions_builder.hpp"
 
+#include <ipc/distance/distance_batch.hpp>
 #include <ipc/distance/distance_type.hpp>
 #include <ipc/distance/point_point.hpp>
 #include <ipc/distance/point_edge.hpp>
@@ -7,13 +8,74 @@
 #include <ipc/distance/edge_edge_mollifier.hpp>
 #include <ipc/distance/point_triangle.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_scan.h>
+#include <tbb/parallel_sort.h>
+
+#include <functional>
+#include <numeric>
+
 namespace ipc {
 
+namespace {
+    /// @brief Flag the face-vertex candidates that may be active using the batched distance lower bounds.
+    /// @note This is only a conservative cull: the lower bounds never exceed the scalar distances, and the survivors are re-evaluated with the scalar functions. 2D meshes have no face-vertex candidates, so the cull only runs in 3D.
+    /// @param mesh The collision mesh.
+    /// @param vertices Vertices of the collision mesh.
+    /// @param candidates Face-vertex candidates.
+    /// @param is_active Function to determine if a candidate is active.
+    /// @param start_i Index of the first candidate to check.
+    /// @param end_i Index one past the last candidate to check.
+    /// @return Flag for each candidate in [start_i, end_i).
+    std::vector<bool> cull_face_vertex_candidates_batch(
+        const CollisionMesh& mesh,
+        ConstRef<Eigen::MatrixXd> vertices,
+        const std::vector<FaceVertexCandidate>& candidates,
+        const std::function<bool(double)>& is_active,
+        const size_t start_i,
+        const size_t end_i)
+    {
+        constexpr int N = DISTANCE_BATCH_SIZE;
+
+        std::vector<bool> maybe_active(end_i - start_i, true);
+        if (vertices.cols() != 3) {
+            return maybe_active;
+        }
+
+        std::array<BatchPoints<N>, 4> points;
+        BatchScalar<N> lower_bound;
+
+        for (size_t i = start_i; i < end_i; i += N) {
+            for (int j = 0; j < N; j++) {
+                // Pad the last batch by repeating its last candidate
+                const size_t ci = std::min(i + j, end_i - 1);
+                const std::array<long, 4> vids =
+                    candidates[ci].vertex_ids(mesh.edges(), mesh.faces());
+                for (int k = 0; k < 4; k++) {
+                    points[k].row(j) = vertices.row(vids[k]).array();
+                }
+            }
+
+            point_triangle_distance_lower_bound_batch<N>(
+                points[0], points[1], points[2], points[3], lower_bound);
+
+            for (int j = 0; j < N && i + j < end_i; j++) {
+                maybe_active[i + j - start_i] = is_active(lower_bound[j]);
+            }
+        }
+
+        return maybe_active;
+    }
+} // namespace
+
 CollisionsBuilder::CollisionsBuilder(
     const bool _use_convergent_formulation,
-    const bool _should_compute_weight_gradient)
+    const bool _should_compute_weight_gradient,
+    const bool _use_batch_culling)
     : use_convergent_formulation(_use_convergent_formulation)
     , should_compute_weight_gradient(_should_compute_weight_gradient)
+    , use_batch_culling(_use_batch_culling)
 {
 }
 
@@ -21,7 +83,7 @@ CollisionsBuilder::CollisionsBuilder(
 
 void CollisionsBuilder::add_vertex_vertex_collisions(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const std::vector<VertexVertexCandidate>& candidates,
     const std::function<bool(double)>& is_active,
     const size_t start_i,
@@ -60,7 +122,7 @@ void CollisionsBuilder::add_vertex_vertex_collisions(
 
 void CollisionsBuilder::add_edge_vertex_collisions(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const std::vector<EdgeVertexCandidate>& candidates,
     const std::function<bool(double)>& is_active,
     const size_t start_i,
@@ -125,7 +187,7 @@ void CollisionsBuilder::add_edge_vertex_collision(
 
 void CollisionsBuilder::add_edge_edge_collisions(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const std::vector<EdgeEdgeCandidate>& candidates,
     const std::function<bool(double)>& is_active,
     const size_t start_i,
@@ -225,13 +287,21 @@ void CollisionsBuilder::add_edge_edge_collisions(
 
 void CollisionsBuilder::add_face_vertex_collisions(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const std::vector<FaceVertexCandidate>& candidates,
     const std::function<bool(double)>& is_active,
     const size_t start_i,
     const size_t end_i)
 {
+    const std::vector<bool> maybe_active = use_batch_culling
+        ? cull_face_vertex_candidates_batch(
+            mesh, vertices, candidates, is_active, start_i, end_i)
+        : std::vector<bool>(end_i - start_i, true);
+
     for (size_t i = start_i; i < end_i; i++) {
+        if (!maybe_active[i - start_i])
+            continue;
+
         const auto& [fi, vi] = candidates[i];
         const long f0i = mesh.faces()(fi, 0), f1i = mesh.faces()(fi, 1),
                    f2i = mesh.faces()(fi, 2);
@@ -303,7 +373,7 @@ void CollisionsBuilder::add_face_vertex_collisions(
 
 void CollisionsBuilder::add_edge_vertex_negative_vertex_vertex_collisions(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const std::vector<VertexVertexCandidate>& candidates,
     const size_t start_i,
     const size_t end_i)
@@ -348,7 +418,7 @@ void CollisionsBuilder::add_edge_vertex_negative_vertex_vertex_collisions(
 
 void CollisionsBuilder::add_face_vertex_positive_vertex_vertex_collisions(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const std::vector<VertexVertexCandidate>& candidates,
     const size_t start_i,
     const size_t end_i)
@@ -391,7 +461,7 @@ void CollisionsBuilder::add_face_vertex_positive_vertex_vertex_collisions(
 
 void CollisionsBuilder::add_face_vertex_negative_edge_vertex_collisions(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const std::vector<EdgeVertexCandidate>& candidates,
     const size_t start_i,
     const size_t end_i)
@@ -429,7 +499,7 @@ void CollisionsBuilder::add_face_vertex_negative_edge_vertex_collisions(
 
 void CollisionsBuilder::add_edge_edge_negative_edge_vertex_collisions(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const std::vector<EdgeVertexCandidate>& candidates,
     const size_t start_i,
     const size_t end_i)
@@ -574,61 +644,134 @@ void CollisionsBuilder::add_edge_edge_collision(
 
 // ============================================================================
 
-void CollisionsBuilder::merge(
-    const tbb::enumerable_thread_specific<CollisionsBuilder>& local_storage,
-    Collisions& merged_collisions)
+namespace {
+    /// @brief Merge thread-local collisions by sorting and reducing equal stencils.
+    /// @note Equal collisions are summed in thread order and the result keeps the order of first occurrence, so this matches inserting into a hash map one collision at a time.
+    /// @param local_collisions Collisions of each thread-local builder, each without duplicates.
+    /// @param merged_collisions Vector to append the merged collisions to.
+    template <typename TCollision>
+    void merge_sorted(
+        const std::vector<const std::vector<TCollision>*>& local_collisions,
+        std::vector<TCollision>& merged_collisions)
+    {
+        std::vector<size_t> offsets(local_collisions.size() + 1, 0);
+        for (size_t i = 0; i < local_collisions.size(); i++) {
+            offsets[i + 1] = offsets[i] + local_collisions[i]->size();
+        }
+        const size_t n = offsets.back();
+        if (n == 0) {
+            return;
+        } else if (local_collisions.size() == 1) {
+            // Nothing to deduplicate
+            merged_collisions.insert(
+                merged_collisions.end(), local_collisions[0]->begin(),
+                local_collisions[0]->end());
+            return;
+        }
+
+        // Flatten the thread-local collisions (index = order of insertion)
+        std::vector<const TCollision*> collisions(n);
+        tbb::parallel_for(size_t(0), local_collisions.size(), [&](size_t i) {
+            for (size_t j = 0; j < local_collisions[i]->size(); j++) {
+                collisions[offsets[i] + j] = &(*local_collisions[i])[j];
+            }
+        });
+
+        // Sort by stencil and then by order of insertion
+        std::vector<size_t> order(n);
+        std::iota(order.begin(), order.end(), size_t(0));
+        tbb::parallel_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            if (*collisions[a] < *collisions[b]) {
+                return true;
+            } else if (*collisions[b] < *collisions[a]) {
+                return false;
+            }
+            return a < b;
+        });
+
+        // Flag the first collision of each run of equal stencils
+        const auto is_run_start = [&](const size_t i) {
+            return i == 0 || *collisions[order[i - 1]] < *collisions[order[i]];
+        };
+
+        // Number the runs with a prefix sum of the flags
+        std::vector<size_t> run_starts(n + 1);
+        const size_t num_runs = tbb::parallel_scan(
+            tbb::blocked_range<size_t>(size_t(0), n), size_t(0),
+            [&](const tbb::blocked_range<size_t>& r, size_t num_starts,
+                const bool is_final_scan) {
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    if (is_run_start(i)) {
+                        if (is_final_scan) {
+                            run_starts[num_starts] = i;
+                        }
+                        num_starts++;
+                    }
+                }
+                return num_starts;
+            },
+            std::plus<size_t>());
+        run_starts.resize(num_runs + 1);
+        run_starts[num_runs] = n;
+
+        // Output the runs in order of their first occurrence
+        std::vector<size_t> run_order(num_runs);
+        std::iota(run_order.begin(), run_order.end(), size_t(0));
+        tbb::parallel_sort(
+            run_order.begin(), run_order.end(), [&](size_t a, size_t b) {
+                return order[run_starts[a]] < order[run_starts[b]];
+            });
+
+        // TCollision is not default constructible, so fill with a placeholder
+        // without a weight gradient to keep the serial fill cheap.
+        const size_t merged_offset = merged_collisions.size();
+        TCollision placeholder = *collisions[0];
+        placeholder.weight_gradient = Eigen::SparseVector<double>();
+        merged_collisions.resize(merged_offset + num_runs, placeholder);
+
+        // Copy the first collision of each run and sum the weights of the
+        // duplicates in order of insertion
+        tbb::parallel_for(size_t(0), num_runs, [&](size_t i) {
+            const size_t r = run_order[i];
+            TCollision& merged = merged_collisions[merged_offset + i];
+            merged = *collisions[order[run_starts[r]]];
+            for (size_t j = run_starts[r] + 1; j < run_starts[r + 1]; j++) {
+                assert(*collisions[order[j]] == merged);
+                merged.weight += collisions[order[j]]->weight;
+                merged.weight_gradient += collisions[order[j]]->weight_gradient;
+            }
+        });
+    }
+} // namespace
+
+template <typename LocalStorage>
+void CollisionsBuilder::merge_builders(
+    const LocalStorage& local_storage, Collisions& merged_collisions)
 {
-    unordered_map<VertexVertexCollision, long> vv_to_id;
-    unordered_map<EdgeVertexCollision, long> ev_to_id;
-    unordered_map<EdgeEdgeCollision, long> ee_to_id;
     auto& vv_collisions = merged_collisions.vv_collisions;
     auto& ev_collisions = merged_collisions.ev_collisions;
     auto& ee_collisions = merged_collisions.ee_collisions;
     auto& fv_collisions = merged_collisions.fv_collisions;
 
-    // size up the hash items
-    size_t n_vv = 0, n_ev = 0, n_ee = 0, n_fv = 0;
-    for (const auto& storage : local_storage) {
-        // This is an conservative estimate
-        n_vv += storage.vv_collisions.size();
-        n_ev += storage.ev_collisions.size();
-        n_ee += storage.ee_collisions.size();
-        n_fv += storage.fv_collisions.size();
+    std::vector<const std::vector<VertexVertexCollision>*> local_vv;
+    std::vector<const std::vector<EdgeVertexCollision>*> local_ev;
+    std::vector<const std::vector<EdgeEdgeCollision>*> local_ee;
+    size_t n_fv = 0;
+    for (const auto& builder : local_storage) {
+        local_vv.push_back(&builder.vv_collisions);
+        local_ev.push_back(&builder.ev_collisions);
+        local_ee.push_back(&builder.ee_collisions);
+        n_fv += builder.fv_collisions.size();
     }
-    vv_collisions.reserve(n_vv);
-    ev_collisions.reserve(n_ev);
-    ee_collisions.reserve(n_ee);
-    fv_collisions.reserve(n_fv);
 
     // merge
-    for (const auto& builder : local_storage) {
-        if (vv_collisions.empty()) {
-            vv_to_id = builder.vv_to_id;
-            vv_collisions = builder.vv_collisions;
-        } else {
-            for (const auto& vv : builder.vv_collisions) {
-                add_vertex_vertex_collision(vv, vv_to_id, vv_collisions);
-            }
-        }
-
-        if (ev_collisions.empty()) {
-            ev_to_id = builder.ev_to_id;
-            ev_collisions = builder.ev_collisions;
-        } else {
-            for (const auto& ev : builder.ev_collisions) {
-                add_edge_vertex_collision(ev, ev_to_id, ev_collisions);
-            }
-        }
-
-        if (ee_collisions.empty()) {
-            ee_to_id = builder.ee_to_id;
-            ee_collisions = builder.ee_collisions;
-        } else {
-            for (const auto& ee : builder.ee_collisions) {
-                add_edge_edge_collision(ee, ee_to_id, ee_collisions);
-            }
-        }
+    merge_sorted(local_vv, vv_collisions);
+    merge_sorted(local_ev, ev_collisions);
+    merge_sorted(local_ee, ee_collisions);
 
+    // Face-vertex collisions are unique across threads
+    fv_collisions.reserve(fv_collisions.size() + n_fv);
+    for (const auto& builder : local_storage) {
         fv_collisions.insert(
             fv_collisions.end(), builder.fv_collisions.begin(),
             builder.fv_collisions.end());
@@ -656,4 +799,18 @@ void CollisionsBuilder::merge(
         ee_collisions.end());
 }
 
+void CollisionsBuilder::merge(
+    const tbb::enumerable_thread_specific<CollisionsBuilder>& local_storage,
+    Collisions& merged_collisions)
+{
+    merge_builders(local_storage, merged_collisions);
+}
+
+void CollisionsBuilder::merge(
+    const std::vector<CollisionsBuilder>& local_storage,
+    Collisions& merged_collisions)
+{
+    merge_builders(local_storage, merged_collisions);
+}
+
 } // namespace ipc
\ No newline at end of file
@@ -13,11 +13,12 @@ class CollisionsBuilder {
 public:
     CollisionsBuilder(
         const bool use_convergent_formulation,
-        const bool are_shape_derivatives_enabled);
+        const bool are_shape_derivatives_enabled,
+        const bool use_batch_culling = true);
 
     void add_vertex_vertex_collisions(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const std::vector<VertexVertexCandidate>& candidates,
         const std::function<bool(double)>& is_active,
         const size_t start_i,
@@ -25,7 +26,7 @@ public:
 
     void add_edge_vertex_collisions(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const std::vector<EdgeVertexCandidate>& candidates,
         const std::function<bool(double)>& is_active,
         const size_t start_i,
@@ -33,7 +34,7 @@ public:
 
     void add_edge_edge_collisions(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const std::vector<EdgeEdgeCandidate>& candidates,
         const std::function<bool(double)>& is_active,
         const size_t start_i,
@@ -41,7 +42,7 @@ public:
 
     void add_face_vertex_collisions(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const std::vector<FaceVertexCandidate>& candidates,
         const std::function<bool(double)>& is_active,
         const size_t start_i,
@@ -52,28 +53,28 @@ public:
 
     void add_edge_vertex_negative_vertex_vertex_collisions(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const std::vector<VertexVertexCandidate>& candidates,
         const size_t start_i,
         const size_t end_i);
 
     void add_face_vertex_positive_vertex_vertex_collisions(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const std::vector<VertexVertexCandidate>& candidates,
         const size_t start_i,
         const size_t end_i);
 
     void add_face_vertex_negative_edge_vertex_collisions(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const std::vector<EdgeVertexCandidate>& candidates,
         const size_t start_i,
         const size_t end_i);
 
     void add_edge_edge_negative_edge_vertex_collisions(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const std::vector<EdgeVertexCandidate>& candidates,
         const size_t start_i,
         const size_t end_i);
@@ -84,8 +85,19 @@ public:
         const tbb::enumerable_thread_specific<CollisionsBuilder>& local_storage,
         Collisions& merged_collisions);
 
+    /// @brief Merge builders filled in a known order (e.g., by hand instead of one per thread).
+    static void merge(
+        const std::vector<CollisionsBuilder>& local_storage,
+        Collisions& merged_collisions);
+
     // -------------------------------------------------------------------------
 protected:
+    template <typename LocalStorage>
+    static void merge_builders(
+        const LocalStorage& local_storage, Collisions& merged_collisions);
+
+    // -------------------------------------------------------------------------
+
     static void add_vertex_vertex_collision(
         const VertexVertexCollision& vv_collision,
         unordered_map<VertexVertexCollision, long>& vv_to_id,
@@ -165,6 +177,8 @@ protected:
 
     const bool use_convergent_formulation;
     const bool should_compute_weight_gradient;
+    /// @brief Cull face-vertex candidates with the batched distance lower bounds before the scalar distance checks.
+    const bool use_batch_culling;
 };
 
 } // namespace ipc
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "compact_collisions.hpp"
+
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+
+namespace ipc {
+
+namespace {
+    /// @brief Copy the data specific to a collision type (none by default).
+    template <typename TCollision, typename Arrays>
+    void copy_type_data(const TCollision&, const size_t, Arrays&)
+    {
+    }
+
+    void copy_type_data(
+        const EdgeEdgeCollision& collision,
+        const size_t i,
+        EdgeEdgeCollisionArrays& arrays)
+    {
+        arrays.eps_x[i] = collision.eps_x;
+        arrays.dtype[i] = collision.dtype;
+    }
+
+    void copy_type_data(
+        const PlaneVertexCollision& collision,
+        const size_t i,
+        PlaneVertexCollisionArrays& arrays)
+    {
+        arrays.plane_origin[i] = collision.plane_origin;
+        arrays.plane_normal[i] = collision.plane_normal;
+    }
+
+    template <typename TCollision, typename Arrays>
+    void copy_collisions(
+        const std::vector<TCollision>& collisions,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        Arrays& arrays)
+    {
+        arrays.resize(collisions.size());
+        tbb::parallel_for(size_t(0), collisions.size(), [&](size_t i) {
+            const TCollision& collision = collisions[i];
+            const std::array<long, 4> ids = collision.vertex_ids(edges, faces);
+            std::copy_n(
+                ids.begin(), arrays.vertex_ids[i].size(),
+                arrays.vertex_ids[i].begin());
+            arrays.dmin[i] = collision.dmin;
+            arrays.weight[i] = collision.weight;
+            copy_type_data(collision, i, arrays);
+        });
+    }
+} // namespace
+
+void CompactCollisions::build(
+    const Collisions& collisions, const CollisionMesh& mesh)
+{
+    const Eigen::MatrixXi& edges = mesh.edges();
+    const Eigen::MatrixXi& faces = mesh.faces();
+
+    copy_collisions(collisions.vv_collisions, edges, faces, vv);
+    copy_collisions(collisions.ev_collisions, edges, faces, ev);
+    copy_collisions(collisions.ee_collisions, edges, faces, ee);
+    copy_collisions(collisions.fv_collisions, edges, faces, fv);
+    copy_collisions(collisions.pv_collisions, edges, faces, pv);
+}
+
+size_t CompactCollisions::size() const
+{
+    return vv.size() + ev.size() + ee.size() + fv.size() + pv.size();
+}
+
+bool CompactCollisions::empty() const
+{
+    return vv.empty() && ev.empty() && ee.empty() && fv.empty() && pv.empty();
+}
+
+void CompactCollisions::clear()
+{
+    vv.clear();
+    ev.clear();
+    ee.clear();
+    fv.clear();
+    pv.clear();
+}
+
+} // namespace ipc
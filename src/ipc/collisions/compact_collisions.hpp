@@ -0,0 +1,117 @@
+#pragma once
+
+#include <ipc/collision_mesh.hpp>
+#include <ipc/collisions/collisions.hpp>
+#include <ipc/distance/distance_type.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <array>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Contiguous (structure-of-arrays) storage of collisions of a single type.
+/// @tparam N Number of vertices in each collision stencil.
+template <int N> struct CollisionArrays {
+    /// @brief Vertex ids of each collision stencil (in stencil order).
+    std::vector<std::array<long, N>> vertex_ids;
+    /// @brief The minimum separation distance of each collision.
+    std::vector<double> dmin;
+    /// @brief The weight of each collision (e.g., collision area).
+    std::vector<double> weight;
+
+    /// @brief Get the number of collisions.
+    size_t size() const { return vertex_ids.size(); }
+
+    /// @brief Get if there are no collisions.
+    bool empty() const { return vertex_ids.empty(); }
+
+    /// @brief Resize the arrays to hold n collisions.
+    void resize(const size_t n)
+    {
+        vertex_ids.resize(n);
+        dmin.resize(n);
+        weight.resize(n);
+    }
+
+    /// @brief Clear the arrays.
+    void clear() { resize(0); }
+};
+
+/// @brief Contiguous storage of edge-edge collisions.
+struct EdgeEdgeCollisionArrays : CollisionArrays<4> {
+    /// @brief Mollifier activation threshold of each collision.
+    std::vector<double> eps_x;
+    /// @brief Distance type of each collision.
+    std::vector<EdgeEdgeDistanceType> dtype;
+
+    void resize(const size_t n)
+    {
+        CollisionArrays<4>::resize(n);
+        eps_x.resize(n);
+        dtype.resize(n);
+    }
+
+    void clear() { resize(0); }
+};
+
+/// @brief Contiguous storage of plane-vertex collisions.
+struct PlaneVertexCollisionArrays : CollisionArrays<1> {
+    /// @brief The origin of each collision's plane.
+    std::vector<VectorMax3d> plane_origin;
+    /// @brief The normal of each collision's plane.
+    std::vector<VectorMax3d> plane_normal;
+
+    void resize(const size_t n)
+    {
+        CollisionArrays<1>::resize(n);
+        plane_origin.resize(n);
+        plane_normal.resize(n);
+    }
+
+    void clear() { resize(0); }
+};
+
+/// @brief A compact, contiguous copy of a collision set.
+///
+/// Each collision type is stored in its own structure of arrays with the
+/// stencils' vertex ids resolved, so potentials can be evaluated over
+/// homogeneous ranges without virtual dispatch or per-collision heap storage.
+/// Vertex-vertex, edge-vertex, and face-vertex collisions always use the
+/// point-point, point-line, and point-plane distances, respectively.
+/// @note Weight gradients (for shape derivatives) are not stored.
+class CompactCollisions {
+public:
+    CompactCollisions() = default;
+
+    /// @brief Build the compact collisions from a collision set.
+    /// @param collisions The collision set.
+    /// @param mesh The collision mesh.
+    CompactCollisions(const Collisions& collisions, const CollisionMesh& mesh)
+    {
+        build(collisions, mesh);
+    }
+
+    /// @brief Build the compact collisions from a collision set.
+    /// @param collisions The collision set.
+    /// @param mesh The collision mesh.
+    void build(const Collisions& collisions, const CollisionMesh& mesh);
+
+    /// @brief Get the number of collisions.
+    size_t size() const;
+
+    /// @brief Get if there are no collisions.
+    bool empty() const;
+
+    /// @brief Clear the collisions.
+    void clear();
+
+public:
+    CollisionArrays<2> vv;
+    CollisionArrays<3> ev;
+    EdgeEdgeCollisionArrays ee;
+    CollisionArrays<4> fv;
+    PlaneVertexCollisionArrays pv;
+};
+
+} // namespace ipc
@@ -0,0 +1,135 @@
+#include "distance_batch.hpp"
+
+#include <array>
+#include <limits>
+
+namespace ipc {
+
+namespace {
+    template <int N>
+    BatchScalar<N> dot(const BatchPoints<N>& a, const BatchPoints<N>& b)
+    {
+        return (a * b).rowwise().sum();
+    }
+
+    template <int N>
+    BatchScalar<N>
+    cross_squarednorm(const BatchPoints<N>& a, const BatchPoints<N>& b)
+    {
+        return (a.col(1) * b.col(2) - a.col(2) * b.col(1)).square()
+            + (a.col(2) * b.col(0) - a.col(0) * b.col(2)).square()
+            + (a.col(0) * b.col(1) - a.col(1) * b.col(0)).square();
+    }
+
+    template <int N>
+    BatchPoints<N> cross(const BatchPoints<N>& a, const BatchPoints<N>& b)
+    {
+        BatchPoints<N> c;
+        c.col(0) = a.col(1) * b.col(2) - a.col(2) * b.col(1);
+        c.col(1) = a.col(2) * b.col(0) - a.col(0) * b.col(2);
+        c.col(2) = a.col(0) * b.col(1) - a.col(1) * b.col(0);
+        return c;
+    }
+
+    /// @brief Relative rounding error allowed for by the distance lower bounds.
+    constexpr double ROUNDING_ERROR_SCALE =
+        1024 * std::numeric_limits<double>::epsilon();
+
+    /// @brief Finish a distance lower bound from the separations of a stencil of two primitives.
+    ///
+    /// The scalar distance functions resolve the closest pair through the
+    /// cross product n = a × b of two edges of the stencil. The edges carry
+    /// an absolute rounding error of O(ε M), where M is the largest
+    /// coordinate of the stencil, so the direction of n has a relative error
+    /// of O(ε (1 + M / |a| + M / |b|) / sin θ), where θ is the angle between
+    /// a and b. The closest points (and so the distance) of the scalar path
+    /// are therefore off by at most O(ε (M + R (1 + M / |a| + M / |b|) /
+    /// sin θ)), where R is the stencil's bounding box diagonal. The margin is
+    /// that bound with a generous constant. Degenerate stencils (sin θ = 0 or
+    /// NaN inputs) get an infinite or NaN margin and a zero bound.
+    ///
+    /// @param box_gap Per-axis separation of the primitives' bounding boxes.
+    /// @param axis_gap Separation along the normal n (NaN or ∞ if n = 0).
+    /// @param points All points of the stencil.
+    /// @param a First edge spanning n.
+    /// @param b Second edge spanning n.
+    /// @return The lower bound on the squared distance.
+    template <int N>
+    BatchScalar<N> finish_lower_bound(
+        const BatchPoints<N>& box_gap,
+        const BatchScalar<N>& axis_gap,
+        const std::array<const BatchPoints<N>*, 4>& points,
+        const BatchPoints<N>& a,
+        const BatchPoints<N>& b)
+    {
+        BatchPoints<N> min = *points[0], max = *points[0];
+        for (int i = 1; i < 4; i++) {
+            min = min.min(*points[i]);
+            max = max.max(*points[i]);
+        }
+        const BatchScalar<N> M =
+            min.abs().max(max.abs()).rowwise().maxCoeff();
+        const BatchScalar<N> R = (max - min).square().rowwise().sum().sqrt();
+
+        const BatchScalar<N> a_norm = dot<N>(a, a).sqrt();
+        const BatchScalar<N> b_norm = dot<N>(b, b).sqrt();
+        const BatchScalar<N> sin_theta =
+            cross_squarednorm<N>(a, b).sqrt() / (a_norm * b_norm);
+
+        const BatchScalar<N> margin = ROUNDING_ERROR_SCALE
+            * (M + R * (1 + M / a_norm + M / b_norm) / sin_theta);
+
+        // The axis gap only counts where it is finite.
+        const BatchScalar<N> gap = box_gap.square().rowwise().sum().sqrt().max(
+            (axis_gap < std::numeric_limits<double>::infinity())
+                .select(axis_gap, 0.0));
+
+        // Comparisons with NaN are false, so NaN margins give a zero bound.
+        return (gap > margin).select((gap - margin).square(), 0.0);
+    }
+
+    template <int N>
+    BatchPoints<N> box_separation(
+        const BatchPoints<N>& a_min,
+        const BatchPoints<N>& a_max,
+        const BatchPoints<N>& b_min,
+        const BatchPoints<N>& b_max)
+    {
+        return (b_min - a_max).max(a_min - b_max).max(0.0);
+    }
+} // namespace
+
+template <int N>
+void point_triangle_distance_lower_bound_batch(
+    const BatchPoints<N>& p,
+    const BatchPoints<N>& t0,
+    const BatchPoints<N>& t1,
+    const BatchPoints<N>& t2,
+    BatchScalar<N>& lower_bound)
+{
+    const BatchPoints<N> ab = t1 - t0, ac = t2 - t0;
+    const BatchPoints<N> normal = cross<N>(ab, ac);
+
+    const BatchScalar<N> plane_gap =
+        dot<N>(normal, p - t0).abs() / dot<N>(normal, normal).sqrt();
+
+    lower_bound = finish_lower_bound<N>(
+        box_separation<N>(p, p, t0.min(t1).min(t2), t0.max(t1).max(t2)),
+        plane_gap, { { &p, &t0, &t1, &t2 } }, ab, ac);
+}
+
+// Explicit template instantiation
+template void point_triangle_distance_lower_bound_batch<4>(
+    const BatchPoints<4>&,
+    const BatchPoints<4>&,
+    const BatchPoints<4>&,
+    const BatchPoints<4>&,
+    BatchScalar<4>&);
+template void point_triangle_distance_lower_bound_batch<8>(
+    const BatchPoints<8>&,
+    const BatchPoints<8>&,
+    const BatchPoints<8>&,
+    const BatchPoints<8>&,
+    BatchScalar<8>&);
+
+} // namespace ipc
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Eigen/Core>
+
+namespace ipc {
+
+/// @brief Number of stencils processed together by the batched distance lower bounds.
+constexpr int DISTANCE_BATCH_SIZE = 8;
+
+/// @brief One value per stencil in a batch.
+template <int N> using BatchScalar = Eigen::Array<double, N, 1>;
+
+/// @brief One 3D point per stencil in a batch (structure-of-arrays: each column holds one coordinate of every stencil).
+template <int N> using BatchPoints = Eigen::Array<double, N, 3>;
+
+/// @brief Compute a lower bound on the distance between a batch of points and triangles.
+/// @note The bound is actually squared. It is the larger of the separation of the bounding boxes and the distance to the triangle's plane, less a margin on the rounding error of point_triangle_distance(), so it never exceeds the scalar distance.
+/// @tparam N Number of stencils in the batch (4 or 8).
+/// @param[in] p The points.
+/// @param[in] t0 The triangles' first vertices.
+/// @param[in] t1 The triangles' second vertices.
+/// @param[in] t2 The triangles' third vertices.
+/// @param[out] lower_bound The lower bound on the squared distance of each stencil.
+template <int N>
+void point_triangle_distance_lower_bound_batch(
+    const BatchPoints<N>& p,
+    const BatchPoints<N>& t0,
+    const BatchPoints<N>& t1,
+    const BatchPoints<N>& t2,
+    BatchScalar<N>& lower_bound);
+
+} // namespace ipc
@@ -17,7 +17,7 @@ EdgeEdgeFrictionCollision::EdgeEdgeFrictionCollision(
 
 EdgeEdgeFrictionCollision::EdgeEdgeFrictionCollision(
     const EdgeEdgeCollision& collision,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
     const double dhat,
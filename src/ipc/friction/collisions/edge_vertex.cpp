@@ -17,7 +17,7 @@ EdgeVertexFrictionCollision::EdgeVertexFrictionCollision(
 
 EdgeVertexFrictionCollision::EdgeVertexFrictionCollision(
     const EdgeVertexCollision& collision,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
     const double dhat,
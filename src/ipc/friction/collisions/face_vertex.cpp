@@ -17,7 +17,7 @@ FaceVertexFrictionCollision::FaceVertexFrictionCollision(
 
 FaceVertexFrictionCollision::FaceVertexFrictionCollision(
     const FaceVertexCollision& collision,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
     const double dhat,
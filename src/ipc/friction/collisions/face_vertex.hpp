@@ -15,7 +15,7 @@ public:
 
     FaceVertexFrictionCollision(
         const FaceVertexCollision& collision,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         const double dhat,
@@ -9,7 +9,7 @@
 namespace ipc {
 
 void FrictionCollision::init(
-    const Eigen::MatrixXd& positions,
+    ConstRef<Eigen::MatrixXd> positions,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
     const double dhat,
@@ -19,7 +19,7 @@ protected:
     /// @param barrier_stiffness Barrier stiffness
     /// @param dmin Minimum distance
     void init(
-        const Eigen::MatrixXd& positions,
+        ConstRef<Eigen::MatrixXd> positions,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         const double dhat,
@@ -17,7 +17,7 @@ VertexVertexFrictionCollision::VertexVertexFrictionCollision(
 
 VertexVertexFrictionCollision::VertexVertexFrictionCollision(
     const VertexVertexCollision& collision,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const Eigen::MatrixXi& edges,
     const Eigen::MatrixXi& faces,
     const double dhat,
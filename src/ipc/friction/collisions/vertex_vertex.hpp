@@ -15,7 +15,7 @@ public:
 
     VertexVertexFrictionCollision(
         const VertexVertexCollision& collision,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const Eigen::MatrixXi& edges,
         const Eigen::MatrixXi& faces,
         const double dhat,
@@ -11,9 +11,55 @@
 
 namespace ipc {
 
+namespace {
+    /// @brief Build the friction collisions of one type in parallel.
+    /// @note The output keeps the order of the collisions; skipped collisions are compacted away afterwards.
+    /// @param collisions Normal collisions to build from.
+    /// @param build Function building the friction collision of a normal collision, returning false if it should be skipped.
+    /// @param[out] friction_collisions The built friction collisions.
+    template <typename TFrictionCollision, typename TCollision, typename Build>
+    void build_friction_collisions(
+        const std::vector<TCollision>& collisions,
+        const Build& build,
+        std::vector<TFrictionCollision>& friction_collisions)
+    {
+        if (collisions.empty()) {
+            return;
+        }
+
+        // Size the list up front; every entry is overwritten below.
+        friction_collisions.resize(
+            collisions.size(), TFrictionCollision(collisions[0]));
+
+        std::vector<char> is_kept(collisions.size(), true);
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), collisions.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    is_kept[i] = build(collisions[i], friction_collisions[i]);
+                }
+            });
+
+        // Remove the skipped collisions while keeping the order.
+        size_t num_kept = 0;
+        for (size_t i = 0; i < collisions.size(); i++) {
+            if (!is_kept[i]) {
+                continue;
+            }
+            if (num_kept != i) {
+                friction_collisions[num_kept] =
+                    std::move(friction_collisions[i]);
+            }
+            num_kept++;
+        }
+        friction_collisions.erase(
+            friction_collisions.begin() + num_kept, friction_collisions.end());
+    }
+} // namespace
+
 void FrictionCollisions::build(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const Collisions& collisions,
     const double dhat,
     const double barrier_stiffness,
@@ -33,60 +79,76 @@ void FrictionCollisions::build(
     const auto& C_fv = collisions.fv_collisions;
     auto& [FC_vv, FC_ev, FC_ee, FC_fv] = *this;
 
-    FC_vv.reserve(C_vv.size());
-    for (const auto& c_vv : C_vv) {
-        FC_vv.emplace_back(
-            c_vv, vertices, edges, faces, dhat, barrier_stiffness);
-        const auto& [v0i, v1i, _, __] = FC_vv.back().vertex_ids(edges, faces);
-
-        FC_vv.back().mu = blend_mu(mus(v0i), mus(v1i));
-    }
-
-    FC_ev.reserve(C_ev.size());
-    for (const auto& c_ev : C_ev) {
-        FC_ev.emplace_back(
-            c_ev, vertices, edges, faces, dhat, barrier_stiffness);
-        const auto& [vi, e0i, e1i, _] = FC_ev.back().vertex_ids(edges, faces);
-
-        const double edge_mu =
-            (mus(e1i) - mus(e0i)) * FC_ev.back().closest_point[0] + mus(e0i);
-        FC_ev.back().mu = blend_mu(edge_mu, mus(vi));
-    }
-
-    FC_ee.reserve(C_ee.size());
-    for (const auto& c_ee : C_ee) {
-        const auto& [ea0i, ea1i, eb0i, eb1i] = c_ee.vertex_ids(edges, faces);
-        const Eigen::Vector3d ea0 = vertices.row(ea0i);
-        const Eigen::Vector3d ea1 = vertices.row(ea1i);
-        const Eigen::Vector3d eb0 = vertices.row(eb0i);
-        const Eigen::Vector3d eb1 = vertices.row(eb1i);
-
-        // Skip EE collisions that are close to parallel
-        if (edge_edge_cross_squarednorm(ea0, ea1, eb0, eb1) < c_ee.eps_x) {
-            continue;
-        }
-
-        FC_ee.emplace_back(
-            c_ee, vertices, edges, faces, dhat, barrier_stiffness);
-
-        double ea_mu =
-            (mus(ea1i) - mus(ea0i)) * FC_ee.back().closest_point[0] + mus(ea0i);
-        double eb_mu =
-            (mus(eb1i) - mus(eb0i)) * FC_ee.back().closest_point[1] + mus(eb0i);
-        FC_ee.back().mu = blend_mu(ea_mu, eb_mu);
-    }
-
-    FC_fv.reserve(C_fv.size());
-    for (const auto& c_fv : C_fv) {
-        FC_fv.emplace_back(
-            c_fv, vertices, edges, faces, dhat, barrier_stiffness);
-        const auto& [vi, f0i, f1i, f2i] = FC_fv.back().vertex_ids(edges, faces);
-
-        double face_mu = mus(f0i)
-            + FC_fv.back().closest_point[0] * (mus(f1i) - mus(f0i))
-            + FC_fv.back().closest_point[1] * (mus(f2i) - mus(f0i));
-        FC_fv.back().mu = blend_mu(face_mu, mus(vi));
-    }
+    build_friction_collisions(
+        C_vv,
+        [&](const VertexVertexCollision& c_vv,
+            VertexVertexFrictionCollision& fc_vv) {
+            fc_vv = VertexVertexFrictionCollision(
+                c_vv, vertices, edges, faces, dhat, barrier_stiffness);
+            const auto& [v0i, v1i, _, __] = fc_vv.vertex_ids(edges, faces);
+
+            fc_vv.mu = blend_mu(mus(v0i), mus(v1i));
+            return true;
+        },
+        FC_vv);
+
+    build_friction_collisions(
+        C_ev,
+        [&](const EdgeVertexCollision& c_ev,
+            EdgeVertexFrictionCollision& fc_ev) {
+            fc_ev = EdgeVertexFrictionCollision(
+                c_ev, vertices, edges, faces, dhat, barrier_stiffness);
+            const auto& [vi, e0i, e1i, _] = fc_ev.vertex_ids(edges, faces);
+
+            const double edge_mu =
+                (mus(e1i) - mus(e0i)) * fc_ev.closest_point[0] + mus(e0i);
+            fc_ev.mu = blend_mu(edge_mu, mus(vi));
+            return true;
+        },
+        FC_ev);
+
+    build_friction_collisions(
+        C_ee,
+        [&](const EdgeEdgeCollision& c_ee, EdgeEdgeFrictionCollision& fc_ee) {
+            const auto& [ea0i, ea1i, eb0i, eb1i] =
+                c_ee.vertex_ids(edges, faces);
+            const Eigen::Vector3d ea0 = vertices.row(ea0i);
+            const Eigen::Vector3d ea1 = vertices.row(ea1i);
+            const Eigen::Vector3d eb0 = vertices.row(eb0i);
+            const Eigen::Vector3d eb1 = vertices.row(eb1i);
+
+            // Skip EE collisions that are close to parallel
+            if (edge_edge_cross_squarednorm(ea0, ea1, eb0, eb1) < c_ee.eps_x) {
+                return false;
+            }
+
+            fc_ee = EdgeEdgeFrictionCollision(
+                c_ee, vertices, edges, faces, dhat, barrier_stiffness);
+
+            double ea_mu =
+                (mus(ea1i) - mus(ea0i)) * fc_ee.closest_point[0] + mus(ea0i);
+            double eb_mu =
+                (mus(eb1i) - mus(eb0i)) * fc_ee.closest_point[1] + mus(eb0i);
+            fc_ee.mu = blend_mu(ea_mu, eb_mu);
+            return true;
+        },
+        FC_ee);
+
+    build_friction_collisions(
+        C_fv,
+        [&](const FaceVertexCollision& c_fv,
+            FaceVertexFrictionCollision& fc_fv) {
+            fc_fv = FaceVertexFrictionCollision(
+                c_fv, vertices, edges, faces, dhat, barrier_stiffness);
+            const auto& [vi, f0i, f1i, f2i] = fc_fv.vertex_ids(edges, faces);
+
+            double face_mu = mus(f0i)
+                + fc_fv.closest_point[0] * (mus(f1i) - mus(f0i))
+                + fc_fv.closest_point[1] * (mus(f2i) - mus(f0i));
+            fc_fv.mu = blend_mu(face_mu, mus(vi));
+            return true;
+        },
+        FC_fv);
 }
 
 // ============================================================================
@@ -25,7 +25,7 @@ public:
 
     void build(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const Collisions& collisions,
         double dhat,
         double barrier_stiffness,
@@ -36,9 +36,11 @@ public:
             Eigen::VectorXd::Constant(vertices.rows(), mu));
     }
 
+    /// @brief Build the friction collisions from the normal collisions.
+    /// @note The collisions are built in parallel, so blend_mu must be thread-safe.
     void build(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices,
+        ConstRef<Eigen::MatrixXd> vertices,
         const Collisions& collisions,
         const double dhat,
         const double barrier_stiffness,
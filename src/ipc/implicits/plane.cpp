@@ -2,15 +2,81 @@
 
 #include <ipc/distance/point_plane.hpp>
 #include <ipc/ccd/point_static_plane.hpp>
+#include <ipc/utils/merge_thread_local.hpp>
 
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range.h>
 #include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_sort.h>
+
+#include <atomic>
 
 namespace ipc {
 
+namespace {
+    /// @brief Relative slack applied to the culling bounds to cover rounding.
+    constexpr double CULLING_SLACK = 1e-6;
+
+    /// @brief Compute the signed distances from a block of points to a plane.
+    /// @param points Points as rows of a matrix.
+    /// @param plane_origin Plane origin as a row vector.
+    /// @param plane_normal Plane normal as a row vector.
+    /// @return Signed distance of each point.
+    Eigen::VectorXd point_plane_signed_distances(
+        ConstRef<Eigen::MatrixXd> points,
+        const Eigen::Ref<const Eigen::RowVectorXd>& plane_origin,
+        const Eigen::Ref<const Eigen::RowVectorXd>& plane_normal)
+    {
+        return (points.rowwise() - plane_origin) * plane_normal.transpose()
+            / plane_normal.norm();
+    }
+
+    /// @brief Call a function for every point-plane pair whose CCD may report a collision.
+    /// @note A pair is culled if the point's displacement cannot bring it within the conservative minimum distance of point_static_plane_ccd().
+    /// @param points_t0 Points at start as rows of a matrix.
+    /// @param displacements Length of each point's trajectory.
+    /// @param begin Index of the first point in the block.
+    /// @param plane_origins Plane origins as rows of a matrix.
+    /// @param plane_normals Plane normals as rows of a matrix.
+    /// @param can_collide Function to determine if a point can collide with a plane.
+    /// @param f Function called with the point and plane ids; returns false to stop.
+    template <typename F>
+    void for_each_ccd_candidate(
+        ConstRef<Eigen::MatrixXd> points_t0,
+        const Eigen::Ref<const Eigen::VectorXd>& displacements,
+        const size_t begin,
+        const Eigen::MatrixXd& plane_origins,
+        const Eigen::MatrixXd& plane_normals,
+        const std::function<bool(size_t, size_t)>& can_collide,
+        F&& f)
+    {
+        constexpr double MAX_DISPLACEMENT_RATIO =
+            DEFAULT_CCD_CONSERVATIVE_RESCALING * (1 - CULLING_SLACK);
+
+        for (size_t pi = 0; pi < plane_origins.rows(); pi++) {
+            const Eigen::VectorXd distances = point_plane_signed_distances(
+                points_t0, plane_origins.row(pi), plane_normals.row(pi));
+
+            for (size_t i = 0; i < distances.size(); i++) {
+                if (displacements[i]
+                    < MAX_DISPLACEMENT_RATIO * std::abs(distances[i])) {
+                    continue; // cannot reach the plane in this step
+                }
+
+                if (!can_collide(begin + i, pi)) {
+                    continue;
+                }
+
+                if (!f(begin + i, pi)) {
+                    return;
+                }
+            }
+        }
+    }
+} // namespace
+
 void construct_point_plane_collisions(
-    const Eigen::MatrixXd& points,
+    ConstRef<Eigen::MatrixXd> points,
     const Eigen::MatrixXd& plane_origins,
     const Eigen::MatrixXd& plane_normals,
     const double dhat,
@@ -23,37 +89,68 @@ void construct_point_plane_collisions(
     double dhat_squared = dhat * dhat;
     double dmin_squared = dmin * dmin;
 
-    // Cull the candidates by measuring the distance and dropping those that are
-    // greater than dhat.
-
     size_t n_planes = plane_origins.rows();
     assert(plane_normals.rows() == n_planes);
 
-    for (size_t vi = 0; vi < points.rows(); vi++) {
-        for (size_t pi = 0; pi < n_planes; pi++) {
-            if (!can_collide(vi, pi)) {
-                continue;
-            }
+    // Cull the candidates by measuring the signed distance of a block of
+    // points to each plane and dropping those that are clearly greater than
+    // dhat. The survivors are checked with the exact squared distance.
+    const double max_distance = (dmin + dhat) * (1 + CULLING_SLACK);
+
+    tbb::enumerable_thread_specific<std::vector<std::pair<size_t, size_t>>>
+        storage;
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), size_t(points.rows())),
+        [&](const tbb::blocked_range<size_t>& r) {
+            auto& local_pairs = storage.local();
+
+            const auto block = points.middleRows(r.begin(), r.size());
 
-            const auto& plane_origin = plane_origins.row(pi);
-            const auto& plane_normal = plane_normals.row(pi);
+            for (size_t pi = 0; pi < n_planes; pi++) {
+                const Eigen::VectorXd distances = point_plane_signed_distances(
+                    block, plane_origins.row(pi), plane_normals.row(pi));
+
+                for (size_t i = 0; i < r.size(); i++) {
+                    if (!(std::abs(distances[i]) < max_distance)) {
+                        continue;
+                    }
+
+                    const size_t vi = r.begin() + i;
+                    if (!can_collide(vi, pi)) {
+                        continue;
+                    }
 
-            double distance_sqr = point_plane_distance(
-                points.row(vi), plane_origin, plane_normal);
+                    double distance_sqr = point_plane_distance(
+                        points.row(vi), plane_origins.row(pi),
+                        plane_normals.row(pi));
 
-            if (distance_sqr - dmin_squared < 2 * dmin * dhat + dhat_squared) {
-                pv_collisions.emplace_back(plane_origin, plane_normal, vi);
-                pv_collisions.back().dmin = dmin;
+                    if (distance_sqr - dmin_squared
+                        < 2 * dmin * dhat + dhat_squared) {
+                        local_pairs.emplace_back(vi, pi);
+                    }
+                }
             }
-        }
+        });
+
+    std::vector<std::pair<size_t, size_t>> pairs;
+    merge_thread_local_vectors(storage, pairs);
+    // Order the collisions by point and then by plane
+    tbb::parallel_sort(pairs.begin(), pairs.end());
+
+    pv_collisions.reserve(pairs.size());
+    for (const auto& [vi, pi] : pairs) {
+        pv_collisions.emplace_back(
+            plane_origins.row(pi), plane_normals.row(pi), vi);
+        pv_collisions.back().dmin = dmin;
     }
 }
 
 // ============================================================================
 
 bool is_step_point_plane_collision_free(
-    const Eigen::MatrixXd& points_t0,
-    const Eigen::MatrixXd& points_t1,
+    ConstRef<Eigen::MatrixXd> points_t0,
+    ConstRef<Eigen::MatrixXd> points_t1,
     const Eigen::MatrixXd& plane_origins,
     const Eigen::MatrixXd& plane_normals,
     const std::function<bool(size_t, size_t)>& can_collide)
@@ -62,34 +159,49 @@ bool is_step_point_plane_collision_free(
     assert(plane_normals.rows() == n_planes);
     assert(points_t0.rows() == points_t1.rows());
 
-    for (size_t vi = 0; vi < points_t0.rows(); vi++) {
-        for (size_t pi = 0; pi < n_planes; pi++) {
-            if (!can_collide(vi, pi)) {
-                continue;
-            }
-
-            const auto& plane_origin = plane_origins.row(pi);
-            const auto& plane_normal = plane_normals.row(pi);
+    // Stop all workers as soon as any collision is found.
+    std::atomic<bool> is_collision_free = true;
+    tbb::task_group_context context;
 
-            double toi;
-            bool is_collision = point_static_plane_ccd(
-                points_t0.row(vi), points_t1.row(vi), plane_origin,
-                plane_normal, toi);
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), size_t(points_t0.rows())),
+        [&](const tbb::blocked_range<size_t>& r) {
+            const auto block_t0 = points_t0.middleRows(r.begin(), r.size());
+            const auto block_t1 = points_t1.middleRows(r.begin(), r.size());
+            const Eigen::VectorXd displacements =
+                (block_t1 - block_t0).rowwise().norm();
+
+            for_each_ccd_candidate(
+                block_t0, displacements, r.begin(), plane_origins,
+                plane_normals, can_collide, [&](size_t vi, size_t pi) {
+                    if (!is_collision_free.load(std::memory_order_relaxed)) {
+                        return false; // Another worker found a collision
+                    }
 
-            if (is_collision) {
-                return false;
-            }
-        }
-    }
+                    double toi;
+                    bool is_collision = point_static_plane_ccd(
+                        points_t0.row(vi), points_t1.row(vi),
+                        plane_origins.row(pi), plane_normals.row(pi), toi);
+
+                    if (is_collision) {
+                        is_collision_free.store(
+                            false, std::memory_order_relaxed);
+                        context.cancel_group_execution();
+                        return false;
+                    }
+                    return true;
+                });
+        },
+        context);
 
-    return true;
+    return is_collision_free;
 }
 
 // ============================================================================
 
 double compute_point_plane_collision_free_stepsize(
-    const Eigen::MatrixXd& points_t0,
-    const Eigen::MatrixXd& points_t1,
+    ConstRef<Eigen::MatrixXd> points_t0,
+    ConstRef<Eigen::MatrixXd> points_t1,
     const Eigen::MatrixXd& plane_origins,
     const Eigen::MatrixXd& plane_normals,
     const std::function<bool(size_t, size_t)>& can_collide)
@@ -101,31 +213,30 @@ double compute_point_plane_collision_free_stepsize(
     tbb::enumerable_thread_specific<double> storage(1);
 
     tbb::parallel_for(
-        tbb::blocked_range<size_t>(0, points_t0.rows()),
-        [&](tbb::blocked_range<size_t> r) {
+        tbb::blocked_range<size_t>(size_t(0), size_t(points_t0.rows())),
+        [&](const tbb::blocked_range<size_t>& r) {
             double& earliest_toi = storage.local();
 
-            for (size_t vi = r.begin(); vi < r.end(); vi++) {
-                for (size_t pi = 0; pi < n_planes; pi++) {
-                    if (!can_collide(vi, pi)) {
-                        continue;
-                    }
-
-                    const auto& plane_origin = plane_origins.row(pi);
-                    const auto& plane_normal = plane_normals.row(pi);
+            const auto block_t0 = points_t0.middleRows(r.begin(), r.size());
+            const auto block_t1 = points_t1.middleRows(r.begin(), r.size());
+            const Eigen::VectorXd displacements =
+                (block_t1 - block_t0).rowwise().norm();
 
+            for_each_ccd_candidate(
+                block_t0, displacements, r.begin(), plane_origins,
+                plane_normals, can_collide, [&](size_t vi, size_t pi) {
                     double toi;
                     bool are_colliding = point_static_plane_ccd(
-                        points_t0.row(vi), points_t1.row(vi), plane_origin,
-                        plane_normal, toi);
+                        points_t0.row(vi), points_t1.row(vi),
+                        plane_origins.row(pi), plane_normals.row(pi), toi);
 
                     if (are_colliding) {
                         if (toi < earliest_toi) {
                             earliest_toi = toi;
                         }
                     }
-                }
-            }
+                    return true;
+                });
         });
 
     const double earliest_toi =
@@ -23,7 +23,7 @@ inline bool default_can_point_plane_collide(size_t, size_t) { return true; }
 /// @param[in] dmin  Minimum distance.
 /// @param[in] can_collide A function that takes a vertex ID (row numbers in points) and a plane ID (row number in plane_origins) then returns true if the vertex can collide with the plane. By default all points can collide with all planes.
 void construct_point_plane_collisions(
-    const Eigen::MatrixXd& points,
+    ConstRef<Eigen::MatrixXd> points,
     const Eigen::MatrixXd& plane_origins,
     const Eigen::MatrixXd& plane_normals,
     const double dhat,
@@ -46,8 +46,8 @@ void construct_point_plane_collisions(
 /// @param[in] can_collide A function that takes a vertex ID (row numbers in points) and a plane ID (row number in plane_origins) then returns true if the vertex can collide with the plane. By default all points can collide with all planes.
 /// @returns True if <b>any</b> collisions occur.
 bool is_step_point_plane_collision_free(
-    const Eigen::MatrixXd& points_t0,
-    const Eigen::MatrixXd& points_t1,
+    ConstRef<Eigen::MatrixXd> points_t0,
+    ConstRef<Eigen::MatrixXd> points_t1,
     const Eigen::MatrixXd& plane_origins,
     const Eigen::MatrixXd& plane_normals,
     const std::function<bool(size_t, size_t)>& can_collide =
@@ -66,8 +66,8 @@ bool is_step_point_plane_collision_free(
 /// @param can_collide A function that takes a vertex ID (row numbers in points) and a plane ID (row number in plane_origins) then returns true if the vertex can collide with the plane. By default all points can collide with all planes.
 /// @returns A step-size \f$\in [0, 1]\f$ that is collision free.
 double compute_point_plane_collision_free_stepsize(
-    const Eigen::MatrixXd& points_t0,
-    const Eigen::MatrixXd& points_t1,
+    ConstRef<Eigen::MatrixXd> points_t0,
+    ConstRef<Eigen::MatrixXd> points_t1,
     const Eigen::MatrixXd& plane_origins,
     const Eigen::MatrixXd& plane_normals,
     const std::function<bool(size_t, size_t)>& can_collide =
@@ -2,6 +2,7 @@
 
 #include <ipc/candidates/candidates.hpp>
 #include <ipc/utils/intersection.hpp>
+#include <ipc/utils/merge_thread_local.hpp>
 #include <ipc/utils/world_bbox_diagonal_length.hpp>
 
 #include <ipc/config.hpp>
@@ -11,13 +12,18 @@
 #endif
 
 #include <igl/predicates/segment_segment_intersect.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include <atomic>
 
 namespace ipc {
 
 bool is_step_collision_free(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     const BroadPhaseMethod broad_phase_method,
     const double min_distance,
     const double tolerance,
@@ -26,11 +32,29 @@ bool is_step_collision_free(
     assert(vertices_t0.rows() == mesh.num_vertices());
     assert(vertices_t1.rows() == mesh.num_vertices());
 
+    return is_step_collision_free(
+        mesh, vertices_t0, vertices_t1,
+        BroadPhase::make_broad_phase(broad_phase_method), min_distance,
+        tolerance, max_iterations);
+}
+
+bool is_step_collision_free(
+    const CollisionMesh& mesh,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
+    const std::shared_ptr<BroadPhase>& broad_phase,
+    const double min_distance,
+    const double tolerance,
+    const long max_iterations)
+{
+    assert(vertices_t0.rows() == mesh.num_vertices());
+    assert(vertices_t1.rows() == mesh.num_vertices());
+
     // Broad phase
     Candidates candidates;
     candidates.build(
         mesh, vertices_t0, vertices_t1,
-        /*inflation_radius=*/min_distance / 2, broad_phase_method);
+        /*inflation_radius=*/min_distance / 2, broad_phase);
 
     // Narrow phase
     return candidates.is_step_collision_free(
@@ -42,8 +66,8 @@ bool is_step_collision_free(
 
 double compute_collision_free_stepsize(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     const BroadPhaseMethod broad_phase_method,
     const double min_distance,
     const double tolerance,
@@ -68,11 +92,36 @@ double compute_collision_free_stepsize(
 #endif
     }
 
+    return compute_collision_free_stepsize(
+        mesh, vertices_t0, vertices_t1,
+        BroadPhase::make_broad_phase(broad_phase_method), min_distance,
+        tolerance, max_iterations);
+}
+
+double compute_collision_free_stepsize(
+    const CollisionMesh& mesh,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
+    const std::shared_ptr<BroadPhase>& broad_phase,
+    const double min_distance,
+    const double tolerance,
+    const long max_iterations)
+{
+    assert(vertices_t0.rows() == mesh.num_vertices());
+    assert(vertices_t1.rows() == mesh.num_vertices());
+
+    if (broad_phase->method() == BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE_GPU) {
+        // The GPU pipeline fuses the broad and narrow phases.
+        return compute_collision_free_stepsize(
+            mesh, vertices_t0, vertices_t1, broad_phase->method(),
+            min_distance, tolerance, max_iterations);
+    }
+
     // Broad phase
     Candidates candidates;
     candidates.build(
         mesh, vertices_t0, vertices_t1, /*inflation_radius=*/min_distance / 2,
-        broad_phase_method);
+        broad_phase);
 
     // Narrow phase
     return candidates.compute_collision_free_stepsize(
@@ -84,59 +133,188 @@ double compute_collision_free_stepsize(
 
 bool has_intersections(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const BroadPhaseMethod broad_phase_method)
 {
-    assert(vertices.rows() == mesh.num_vertices());
+    return has_intersections(
+        mesh, vertices, BroadPhase::make_broad_phase(broad_phase_method));
+}
 
-    const double conservative_inflation_radius =
-        1e-6 * world_bbox_diagonal_length(vertices);
+namespace {
+    /// @brief Update the broad phase and detect the candidate pairs of the intersection checks.
+    /// @note In 2D the edge-edge candidates are filled and in 3D the edge-face candidates are filled.
+    void detect_intersection_candidates(
+        const CollisionMesh& mesh,
+        ConstRef<Eigen::MatrixXd> vertices,
+        const std::shared_ptr<BroadPhase>& broad_phase,
+        std::vector<EdgeEdgeCandidate>& ee_candidates,
+        std::vector<EdgeFaceCandidate>& ef_candidates)
+    {
+        assert(vertices.rows() == mesh.num_vertices());
 
-    std::shared_ptr<BroadPhase> broad_phase =
-        BroadPhase::make_broad_phase(broad_phase_method);
-    broad_phase->can_vertices_collide = mesh.can_collide;
+        // The inflation only guards the box tests against rounding, so any
+        // radius of the same order works. Keep the radius of the last build
+        // while it lies in [r, 4r] for the minimum radius r; otherwise every
+        // motion would change the radius and force update() to rebuild.
+        const double min_inflation_radius =
+            1e-6 * world_bbox_diagonal_length(vertices);
+        double inflation_radius = broad_phase->last_build_inflation_radius();
+        if (!(inflation_radius >= min_inflation_radius
+              && inflation_radius <= 4 * min_inflation_radius)) {
+            inflation_radius = 2 * min_inflation_radius;
+        }
 
-    broad_phase->build(
-        vertices, mesh.edges(), mesh.faces(), conservative_inflation_radius);
+        broad_phase->can_vertices_collide = mesh.can_collide;
 
-    if (vertices.cols() == 2) {
-        // Need to check segment-segment intersections in 2D
-        std::vector<EdgeEdgeCandidate> ee_candidates;
+        broad_phase->update(
+            vertices, mesh.edges(), mesh.faces(), inflation_radius);
 
-        broad_phase->detect_edge_edge_candidates(ee_candidates);
-        broad_phase->clear();
+        if (vertices.cols() == 2) {
+            // Need to check segment-segment intersections in 2D
+            broad_phase->detect_edge_edge_candidates(ee_candidates);
+        } else {
+            // Need to check segment-triangle intersections in 3D
+            assert(vertices.cols() == 3);
+            broad_phase->detect_edge_face_candidates(ef_candidates);
+        }
 
-        // narrow-phase using igl
+        // The exact predicates are initialized once here instead of
+        // concurrently by the narrow phase workers.
         igl::predicates::exactinit();
-        for (const auto& [ea_id, eb_id] : ee_candidates) {
-            if (igl::predicates::segment_segment_intersect(
-                    vertices.row(mesh.edges()(ea_id, 0)).head<2>(),
-                    vertices.row(mesh.edges()(ea_id, 1)).head<2>(),
-                    vertices.row(mesh.edges()(eb_id, 0)).head<2>(),
-                    vertices.row(mesh.edges()(eb_id, 1)).head<2>())) {
-                return true;
-            }
-        }
-    } else {
-        // Need to check segment-triangle intersections in 3D
-        assert(vertices.cols() == 3);
-
-        std::vector<EdgeFaceCandidate> ef_candidates;
-        broad_phase->detect_edge_face_candidates(ef_candidates);
-        broad_phase->clear();
-
-        for (const auto& [e_id, f_id] : ef_candidates) {
-            if (is_edge_intersecting_triangle(
-                    vertices.row(mesh.edges()(e_id, 0)),
-                    vertices.row(mesh.edges()(e_id, 1)),
-                    vertices.row(mesh.faces()(f_id, 0)),
-                    vertices.row(mesh.faces()(f_id, 1)),
-                    vertices.row(mesh.faces()(f_id, 2)))) {
-                return true;
-            }
-        }
     }
 
-    return false;
+    bool is_intersecting(
+        const CollisionMesh& mesh,
+        ConstRef<Eigen::MatrixXd> vertices,
+        const EdgeEdgeCandidate& candidate)
+    {
+        const auto& [ea_id, eb_id] = candidate;
+        return igl::predicates::segment_segment_intersect(
+            vertices.row(mesh.edges()(ea_id, 0)).head<2>(),
+            vertices.row(mesh.edges()(ea_id, 1)).head<2>(),
+            vertices.row(mesh.edges()(eb_id, 0)).head<2>(),
+            vertices.row(mesh.edges()(eb_id, 1)).head<2>());
+    }
+
+    bool is_intersecting(
+        const CollisionMesh& mesh,
+        ConstRef<Eigen::MatrixXd> vertices,
+        const EdgeFaceCandidate& candidate)
+    {
+        const auto& [e_id, f_id] = candidate;
+        return is_edge_intersecting_triangle(
+            vertices.row(mesh.edges()(e_id, 0)),
+            vertices.row(mesh.edges()(e_id, 1)),
+            vertices.row(mesh.faces()(f_id, 0)),
+            vertices.row(mesh.faces()(f_id, 1)),
+            vertices.row(mesh.faces()(f_id, 2)));
+    }
+
+    /// @brief Check the candidates in parallel, stopping all workers at the first intersection.
+    template <typename Candidate>
+    bool is_any_intersecting(
+        const CollisionMesh& mesh,
+        ConstRef<Eigen::MatrixXd> vertices,
+        const std::vector<Candidate>& candidates)
+    {
+        std::atomic<bool> has_intersection = false;
+        tbb::task_group_context context;
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, candidates.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    if (has_intersection.load(std::memory_order_relaxed)) {
+                        return; // Another worker found an intersection
+                    }
+
+                    if (is_intersecting(mesh, vertices, candidates[i])) {
+                        has_intersection.store(
+                            true, std::memory_order_relaxed);
+                        context.cancel_group_execution();
+                        return;
+                    }
+                }
+            },
+            context);
+
+        return has_intersection;
+    }
+
+    /// @brief Check all candidates in parallel and gather the intersecting pairs.
+    template <typename Candidate>
+    std::vector<std::pair<long, long>> intersecting_pairs(
+        const CollisionMesh& mesh,
+        ConstRef<Eigen::MatrixXd> vertices,
+        const std::vector<Candidate>& candidates)
+    {
+        tbb::enumerable_thread_specific<std::vector<std::pair<long, long>>>
+            storage;
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, candidates.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& local_pairs = storage.local();
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    if (is_intersecting(mesh, vertices, candidates[i])) {
+                        const auto& [id0, id1] = candidates[i];
+                        local_pairs.emplace_back(id0, id1);
+                    }
+                }
+            });
+
+        std::vector<std::pair<long, long>> pairs;
+        merge_thread_local_vectors(storage, pairs);
+        return pairs;
+    }
+} // namespace
+
+bool has_intersections(
+    const CollisionMesh& mesh,
+    ConstRef<Eigen::MatrixXd> vertices,
+    const std::shared_ptr<BroadPhase>& broad_phase)
+{
+    std::vector<EdgeEdgeCandidate> ee_candidates;
+    std::vector<EdgeFaceCandidate> ef_candidates;
+    detect_intersection_candidates(
+        mesh, vertices, broad_phase, ee_candidates, ef_candidates);
+
+    return is_any_intersecting(mesh, vertices, ee_candidates)
+        || is_any_intersecting(mesh, vertices, ef_candidates);
+}
+
+Eigen::MatrixXi compute_intersecting_pairs(
+    const CollisionMesh& mesh,
+    ConstRef<Eigen::MatrixXd> vertices,
+    const BroadPhaseMethod broad_phase_method)
+{
+    return compute_intersecting_pairs(
+        mesh, vertices, BroadPhase::make_broad_phase(broad_phase_method));
 }
+
+Eigen::MatrixXi compute_intersecting_pairs(
+    const CollisionMesh& mesh,
+    ConstRef<Eigen::MatrixXd> vertices,
+    const std::shared_ptr<BroadPhase>& broad_phase)
+{
+    std::vector<EdgeEdgeCandidate> ee_candidates;
+    std::vector<EdgeFaceCandidate> ef_candidates;
+    detect_intersection_candidates(
+        mesh, vertices, broad_phase, ee_candidates, ef_candidates);
+
+    std::vector<std::pair<long, long>> pairs =
+        vertices.cols() == 2
+        ? intersecting_pairs(mesh, vertices, ee_candidates)
+        : intersecting_pairs(mesh, vertices, ef_candidates);
+    // Order the pairs independently of the broad phase and thread schedule
+    tbb::parallel_sort(pairs.begin(), pairs.end());
+
+    Eigen::MatrixXi intersections(pairs.size(), 2);
+    for (size_t i = 0; i < pairs.size(); i++) {
+        intersections(i, 0) = pairs[i].first;
+        intersections(i, 1) = pairs[i].second;
+    }
+    return intersections;
+}
+
 } // namespace ipc
@@ -24,13 +24,32 @@ namespace ipc {
 /// @returns True if <b>any</b> collisions occur.
 bool is_step_collision_free(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD,
     const double min_distance = 0.0,
     const double tolerance = DEFAULT_CCD_TOLERANCE,
     const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS);
 
+/// @brief Determine if the step is collision free using a persistent broad phase.
+/// @note Assumes the trajectory is linear. The broad phase is updated in place, so it can be reused across calls.
+/// @param mesh The collision mesh.
+/// @param vertices_t0 Surface vertex vertices at start as rows of a matrix.
+/// @param vertices_t1 Surface vertex vertices at end as rows of a matrix.
+/// @param broad_phase The broad phase to update and query.
+/// @param min_distance The minimum distance allowable between any two elements.
+/// @param tolerance The tolerance for the CCD algorithm.
+/// @param max_iterations The maximum number of iterations for the CCD algorithm.
+/// @returns True if <b>any</b> collisions occur.
+bool is_step_collision_free(
+    const CollisionMesh& mesh,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
+    const std::shared_ptr<BroadPhase>& broad_phase,
+    const double min_distance = 0.0,
+    const double tolerance = DEFAULT_CCD_TOLERANCE,
+    const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS);
+
 /// @brief Computes a maximal step size that is collision free.
 /// @note Assumes the trajectory is linear.
 /// @param mesh The collision mesh.
@@ -43,24 +62,77 @@ bool is_step_collision_free(
 /// @returns A step-size \f$\in [0, 1]\f$ that is collision free. A value of 1.0 if a full step and 0.0 is no step.
 double compute_collision_free_stepsize(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices_t0,
-    const Eigen::MatrixXd& vertices_t1,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
     const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD,
     const double min_distance = 0.0,
     const double tolerance = DEFAULT_CCD_TOLERANCE,
     const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS);
 
+/// @brief Computes a maximal step size that is collision free using a persistent broad phase.
+/// @note Assumes the trajectory is linear. The broad phase is updated in place, so it can be reused across calls.
+/// @param mesh The collision mesh.
+/// @param vertices_t0 Vertex vertices at start as rows of a matrix. Assumes vertices_t0 is intersection free.
+/// @param vertices_t1 Surface vertex vertices at end as rows of a matrix.
+/// @param broad_phase The broad phase to update and query.
+/// @param min_distance The minimum distance allowable between any two elements.
+/// @param tolerance The tolerance for the CCD algorithm.
+/// @param max_iterations The maximum number of iterations for the CCD algorithm.
+/// @returns A step-size \f$\in [0, 1]\f$ that is collision free. A value of 1.0 if a full step and 0.0 is no step.
+double compute_collision_free_stepsize(
+    const CollisionMesh& mesh,
+    ConstRef<Eigen::MatrixXd> vertices_t0,
+    ConstRef<Eigen::MatrixXd> vertices_t1,
+    const std::shared_ptr<BroadPhase>& broad_phase,
+    const double min_distance = 0.0,
+    const double tolerance = DEFAULT_CCD_TOLERANCE,
+    const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS);
+
 // ============================================================================
 // Utilities
 
 /// @brief Determine if the mesh has self intersections.
+/// @note The candidates are checked in parallel and all workers stop at the first intersection found.
 /// @param mesh The collision mesh.
 /// @param vertices Vertices of the collision mesh.
 /// @param broad_phase_method The broad phase method to use.
 /// @return A boolean for if the mesh has intersections.
 bool has_intersections(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices,
+    ConstRef<Eigen::MatrixXd> vertices,
     const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD);
 
+/// @brief Determine if the mesh has self intersections using a persistent broad phase.
+/// @note The candidates are checked in parallel and all workers stop at the first intersection found.
+/// @param mesh The collision mesh.
+/// @param vertices Vertices of the collision mesh.
+/// @param broad_phase The broad phase to update and query.
+/// @return A boolean for if the mesh has intersections.
+bool has_intersections(
+    const CollisionMesh& mesh,
+    ConstRef<Eigen::MatrixXd> vertices,
+    const std::shared_ptr<BroadPhase>& broad_phase);
+
+/// @brief Find all pairs of intersecting elements of the mesh.
+/// @note The candidates are checked in parallel.
+/// @param mesh The collision mesh.
+/// @param vertices Vertices of the collision mesh.
+/// @param broad_phase_method The broad phase method to use.
+/// @return #I by 2 matrix of intersecting pairs sorted lexicographically: edge-edge pairs in 2D and edge-face pairs in 3D.
+Eigen::MatrixXi compute_intersecting_pairs(
+    const CollisionMesh& mesh,
+    ConstRef<Eigen::MatrixXd> vertices,
+    const BroadPhaseMethod broad_phase_method = DEFAULT_BROAD_PHASE_METHOD);
+
+/// @brief Find all pairs of intersecting elements of the mesh using a persistent broad phase.
+/// @note The candidates are checked in parallel.
+/// @param mesh The collision mesh.
+/// @param vertices Vertices of the collision mesh.
+/// @param broad_phase The broad phase to update and query.
+/// @return #I by 2 matrix of intersecting pairs sorted lexicographically: edge-edge pairs in 2D and edge-face pairs in 3D.
+Eigen::MatrixXi compute_intersecting_pairs(
+    const CollisionMesh& mesh,
+    ConstRef<Eigen::MatrixXd> vertices,
+    const std::shared_ptr<BroadPhase>& broad_phase);
+
 } // namespace ipc
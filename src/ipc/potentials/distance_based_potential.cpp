@@ -1,50 +1,618 @@
 #include "distance_based_potential.hpp"
 
+#include <ipc/distance/edge_edge.hpp>
+#include <ipc/distance/edge_edge_mollifier.hpp>
+#include <ipc/distance/point_line.hpp>
+#include <ipc/distance/point_plane.hpp>
+#include <ipc/utils/column_starts.hpp>
+#include <ipc/utils/local_to_global.hpp>
+#include <ipc/utils/merge_thread_local.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
 namespace ipc {
 
 // -- Cumulative methods -------------------------------------------------------
 
+namespace {
+    // -- Fixed-size kernels ---------------------------------------------------
+    // Each kernel computes the distance (and mollifier) of a single collision
+    // type from the stencil's positions stacked in a fixed-size vector.
+
+    template <int N, int DIM> struct KernelBase {
+        static constexpr int NUM_VERTICES = N;
+        static constexpr int DIMENSION = DIM;
+        static constexpr int NDOF = N * DIM;
+        static constexpr bool IS_MOLLIFIED = false;
+
+        using Vector = Eigen::Matrix<double, NDOF, 1>;
+        using Matrix = Eigen::Matrix<double, NDOF, NDOF>;
+
+        template <typename Arrays>
+        KernelBase(const Arrays& collisions, const size_t i)
+            : weight(collisions.weight[i])
+            , dmin(collisions.dmin[i])
+        {
+        }
+
+        double weight;
+        double dmin;
+    };
+
+    template <int DIM> struct VertexVertexKernel : KernelBase<2, DIM> {
+        using Base = KernelBase<2, DIM>;
+        using typename Base::Matrix;
+        using typename Base::Vector;
+        using Base::Base;
+
+        double distance(const Vector& x) const
+        {
+            return (x.template head<DIM>() - x.template tail<DIM>())
+                .squaredNorm();
+        }
+
+        Vector distance_gradient(const Vector& x) const
+        {
+            Vector grad;
+            grad.template head<DIM>() =
+                2.0 * (x.template head<DIM>() - x.template tail<DIM>());
+            grad.template tail<DIM>() = -grad.template head<DIM>();
+            return grad;
+        }
+
+        Matrix distance_hessian(const Vector& x) const
+        {
+            Matrix hess;
+            const auto I = Eigen::Matrix<double, DIM, DIM>::Identity();
+            hess << 2 * I, -2 * I, -2 * I, 2 * I;
+            return hess;
+        }
+    };
+
+    template <int DIM> struct EdgeVertexKernel : KernelBase<3, DIM> {
+        using Base = KernelBase<3, DIM>;
+        using typename Base::Matrix;
+        using typename Base::Vector;
+        using Base::Base;
+
+        double distance(const Vector& x) const
+        {
+            return point_line_distance(
+                x.template segment<DIM>(0), x.template segment<DIM>(DIM),
+                x.template segment<DIM>(2 * DIM));
+        }
+
+        Vector distance_gradient(const Vector& x) const
+        {
+            Vector grad;
+            if constexpr (DIM == 2) {
+                autogen::point_line_distance_gradient_2D(
+                    x[0], x[1], x[2], x[3], x[4], x[5], grad.data());
+            } else {
+                autogen::point_line_distance_gradient_3D(
+                    x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7], x[8],
+                    grad.data());
+            }
+            return grad;
+        }
+
+        Matrix distance_hessian(const Vector& x) const
+        {
+            Matrix hess;
+            if constexpr (DIM == 2) {
+                autogen::point_line_distance_hessian_2D(
+                    x[0], x[1], x[2], x[3], x[4], x[5], hess.data());
+            } else {
+                autogen::point_line_distance_hessian_3D(
+                    x[0], x[1], x[2], x[3], x[4], x[5], x[6], x[7], x[8],
+                    hess.data());
+            }
+            return hess;
+        }
+    };
+
+    struct EdgeEdgeKernel : KernelBase<4, 3> {
+        static constexpr bool IS_MOLLIFIED = true;
+
+        EdgeEdgeKernel(
+            const EdgeEdgeCollisionArrays& collisions, const size_t i)
+            : KernelBase(collisions, i)
+            , eps_x(collisions.eps_x[i])
+            , dtype(collisions.dtype[i])
+        {
+        }
+
+        double distance(const Vector& x) const
+        {
+            return edge_edge_distance(
+                x.segment<3>(0), x.segment<3>(3), x.segment<3>(6),
+                x.segment<3>(9), dtype);
+        }
+
+        Vector distance_gradient(const Vector& x) const
+        {
+            return edge_edge_distance_gradient(
+                x.segment<3>(0), x.segment<3>(3), x.segment<3>(6),
+                x.segment<3>(9), dtype);
+        }
+
+        Matrix distance_hessian(const Vector& x) const
+        {
+            return edge_edge_distance_hessian(
+                x.segment<3>(0), x.segment<3>(3), x.segment<3>(6),
+                x.segment<3>(9), dtype);
+        }
+
+        double mollifier(const Vector& x) const
+        {
+            return edge_edge_mollifier(
+                x.segment<3>(0), x.segment<3>(3), x.segment<3>(6),
+                x.segment<3>(9), eps_x);
+        }
+
+        Vector mollifier_gradient(const Vector& x) const
+        {
+            return edge_edge_mollifier_gradient(
+                x.segment<3>(0), x.segment<3>(3), x.segment<3>(6),
+                x.segment<3>(9), eps_x);
+        }
+
+        Matrix mollifier_hessian(const Vector& x) const
+        {
+            return edge_edge_mollifier_hessian(
+                x.segment<3>(0), x.segment<3>(3), x.segment<3>(6),
+                x.segment<3>(9), eps_x);
+        }
+
+        double eps_x;
+        EdgeEdgeDistanceType dtype;
+    };
+
+    struct FaceVertexKernel : KernelBase<4, 3> {
+        using KernelBase::KernelBase;
+
+        double distance(const Vector& x) const
+        {
+            return point_plane_distance(
+                x.segment<3>(0), x.segment<3>(3), x.segment<3>(6),
+                x.segment<3>(9));
+        }
+
+        Vector distance_gradient(const Vector& x) const
+        {
+            return point_plane_distance_gradient(
+                x.segment<3>(0), x.segment<3>(3), x.segment<3>(6),
+                x.segment<3>(9));
+        }
+
+        Matrix distance_hessian(const Vector& x) const
+        {
+            return point_plane_distance_hessian(
+                x.segment<3>(0), x.segment<3>(3), x.segment<3>(6),
+                x.segment<3>(9));
+        }
+    };
+
+    template <int DIM> struct PlaneVertexKernel : KernelBase<1, DIM> {
+        using Base = KernelBase<1, DIM>;
+        using typename Base::Matrix;
+        using typename Base::Vector;
+
+        PlaneVertexKernel(
+            const PlaneVertexCollisionArrays& collisions, const size_t i)
+            : Base(collisions, i)
+            , origin(collisions.plane_origin[i])
+            , normal(collisions.plane_normal[i])
+        {
+        }
+
+        double distance(const Vector& x) const
+        {
+            const double point_to_plane = (x - origin).dot(normal);
+            return point_to_plane * point_to_plane / normal.squaredNorm();
+        }
+
+        Vector distance_gradient(const Vector& x) const
+        {
+            return (2 / normal.squaredNorm()) * (x - origin).dot(normal)
+                * normal;
+        }
+
+        Matrix distance_hessian(const Vector& x) const
+        {
+            return (2 / normal.squaredNorm()) * normal * normal.transpose();
+        }
+
+        Vector origin;
+        Vector normal;
+    };
+
+    template <typename Kernel> struct KernelTag {
+        using type = Kernel;
+    };
+
+    /// @brief Call f(tag, collisions) for each homogeneous range of collisions.
+    template <typename F>
+    void for_each_range(
+        const CompactCollisions& collisions, const int dim, const F& f)
+    {
+        if (dim == 2) {
+            assert(collisions.ee.empty() && collisions.fv.empty());
+            f(KernelTag<VertexVertexKernel<2>>(), collisions.vv);
+            f(KernelTag<EdgeVertexKernel<2>>(), collisions.ev);
+            f(KernelTag<PlaneVertexKernel<2>>(), collisions.pv);
+        } else {
+            assert(dim == 3);
+            f(KernelTag<VertexVertexKernel<3>>(), collisions.vv);
+            f(KernelTag<EdgeVertexKernel<3>>(), collisions.ev);
+            f(KernelTag<EdgeEdgeKernel>(), collisions.ee);
+            f(KernelTag<FaceVertexKernel>(), collisions.fv);
+            f(KernelTag<PlaneVertexKernel<3>>(), collisions.pv);
+        }
+    }
+
+    /// @brief Gather the stencil's positions into a fixed-size vector.
+    template <typename Kernel, typename Arrays>
+    typename Kernel::Vector gather_positions(
+        const Arrays& collisions, const size_t i, ConstRef<Eigen::MatrixXd> V)
+    {
+        constexpr int DIM = Kernel::DIMENSION;
+        typename Kernel::Vector x;
+        for (int j = 0; j < Kernel::NUM_VERTICES; j++) {
+            x.template segment<DIM>(DIM * j) =
+                V.row(collisions.vertex_ids[i][j]).transpose();
+        }
+        return x;
+    }
+} // namespace
+
+double DistanceBasedPotential::operator()(
+    const CompactCollisions& collisions,
+    ConstRef<Eigen::MatrixXd> vertices) const
+{
+    double potential = 0;
+    for_each_range(
+        collisions, vertices.cols(), [&](auto tag, const auto& range) {
+            using Kernel = typename decltype(tag)::type;
+            potential += tbb::parallel_reduce(
+                tbb::blocked_range<size_t>(size_t(0), range.size()), 0.0,
+                [&](const tbb::blocked_range<size_t>& r, double sum) {
+                    for (size_t i = r.begin(); i < r.end(); i++) {
+                        sum += kernel_potential(
+                            Kernel(range, i),
+                            gather_positions<Kernel>(range, i, vertices));
+                    }
+                    return sum;
+                },
+                std::plus<double>());
+        });
+    return potential;
+}
+
+Eigen::VectorXd DistanceBasedPotential::gradient(
+    const CompactCollisions& collisions,
+    ConstRef<Eigen::MatrixXd> vertices) const
+{
+    tbb::enumerable_thread_specific<std::vector<std::pair<long, double>>>
+        storage;
+
+    for_each_range(
+        collisions, vertices.cols(), [&](auto tag, const auto& range) {
+            using Kernel = typename decltype(tag)::type;
+            tbb::parallel_for(
+                tbb::blocked_range<size_t>(size_t(0), range.size()),
+                [&](const tbb::blocked_range<size_t>& r) {
+                    auto& grad_entries = storage.local();
+                    for (size_t i = r.begin(); i < r.end(); i++) {
+                        local_gradient_to_global_gradient(
+                            kernel_gradient(
+                                Kernel(range, i),
+                                gather_positions<Kernel>(range, i, vertices)),
+                            range.vertex_ids[i], Kernel::DIMENSION,
+                            grad_entries);
+                    }
+                });
+        });
+
+    return merge_thread_local_gradients(storage, vertices.size());
+}
+
+Eigen::SparseMatrix<double> DistanceBasedPotential::hessian(
+    const CompactCollisions& collisions,
+    ConstRef<Eigen::MatrixXd> vertices,
+    const bool project_hessian_to_psd) const
+{
+    tbb::enumerable_thread_specific<std::vector<Eigen::Triplet<double>>>
+        storage;
+
+    for_each_range(
+        collisions, vertices.cols(), [&](auto tag, const auto& range) {
+            using Kernel = typename decltype(tag)::type;
+            tbb::parallel_for(
+                tbb::blocked_range<size_t>(size_t(0), range.size()),
+                [&](const tbb::blocked_range<size_t>& r) {
+                    auto& hess_triplets = storage.local();
+                    for (size_t i = r.begin(); i < r.end(); i++) {
+                        local_hessian_to_global_triplets(
+                            kernel_hessian(
+                                Kernel(range, i),
+                                gather_positions<Kernel>(range, i, vertices),
+                                project_hessian_to_psd),
+                            range.vertex_ids[i], Kernel::DIMENSION,
+                            hess_triplets);
+                    }
+                });
+        });
+
+    return merge_thread_local_triplets(
+        storage, vertices.size(), vertices.size());
+}
+
+// -- Fixed-size kernel methods ------------------------------------------------
+
+template <typename Kernel>
+double DistanceBasedPotential::kernel_potential(
+    const Kernel& kernel, const typename Kernel::Vector& x) const
+{
+    // w * m(x) * f(d(x))
+    const double f =
+        distance_based_potential(kernel.distance(x), kernel.dmin);
+    if constexpr (Kernel::IS_MOLLIFIED) {
+        return kernel.weight * kernel.mollifier(x) * f;
+    } else {
+        return kernel.weight * f;
+    }
+}
+
+template <typename Kernel>
+typename Kernel::Vector DistanceBasedPotential::kernel_gradient(
+    const Kernel& kernel, const typename Kernel::Vector& x) const
+{
+    const double d = kernel.distance(x);
+    // ∇[w f(d(x))] = w f'(d(x)) ∇d(x)
+    const typename Kernel::Vector grad_f =
+        (kernel.weight * distance_based_potential_gradient(d, kernel.dmin))
+        * kernel.distance_gradient(x);
+
+    if constexpr (Kernel::IS_MOLLIFIED) {
+        // ∇[w m(x) f(d(x))] = w f(d(x)) ∇m(x) + m(x) ∇[w f(d(x))]
+        return (kernel.weight * distance_based_potential(d, kernel.dmin))
+            * kernel.mollifier_gradient(x)
+            + kernel.mollifier(x) * grad_f;
+    } else {
+        return grad_f;
+    }
+}
+
+template <typename Kernel>
+typename Kernel::Matrix DistanceBasedPotential::kernel_hessian(
+    const Kernel& kernel,
+    const typename Kernel::Vector& x,
+    const bool project_hessian_to_psd) const
+{
+    using Vector = typename Kernel::Vector;
+    using Matrix = typename Kernel::Matrix;
+
+    // d(x)
+    const double d = kernel.distance(x);
+    // ∇d(x)
+    const Vector grad_d = kernel.distance_gradient(x);
+    // f'(d(x))
+    const double grad_f = distance_based_potential_gradient(d, kernel.dmin);
+    // f"(d(x))
+    const double hess_f = distance_based_potential_hessian(d, kernel.dmin);
+
+    // ∇²[f(d(x))] = f"(d(x)) ∇d(x) ∇d(x)ᵀ + f'(d(x)) ∇²d(x)
+    Matrix hess = hess_f * grad_d * grad_d.transpose()
+        + grad_f * kernel.distance_hessian(x);
+
+    if constexpr (Kernel::IS_MOLLIFIED) {
+        const double f = distance_based_potential(d, kernel.dmin);
+        const double m = kernel.mollifier(x);
+        const Vector grad_m = kernel.mollifier_gradient(x);
+
+        // ∇²[m(x) f(d(x))] = f(d(x)) ∇²m(x) + ∇f(d(x)) ∇m(x)ᵀ
+        //                    + ∇m(x) ∇f(d(x))ᵀ + m(x) ∇²f(d(x))
+        const Matrix grad_f_grad_m = grad_f * grad_d * grad_m.transpose();
+        hess = f * kernel.mollifier_hessian(x) + grad_f_grad_m
+            + grad_f_grad_m.transpose() + m * hess;
+    }
+
+    hess *= kernel.weight;
+
+    // Need to project entire hessian because w can be negative
+    // NOTE: Only plane-vertex stencils depend on absolute positions.
+    return project_hessian_to_psd
+        ? project_local_hessian_to_psd(
+            hess, Kernel::DIMENSION, Kernel::NUM_VERTICES > 1)
+        : hess;
+}
+
 Eigen::SparseMatrix<double> DistanceBasedPotential::shape_derivative(
     const Collisions& collisions,
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& vertices) const
+    ConstRef<Eigen::MatrixXd> vertices) const
 {
     assert(vertices.rows() == mesh.num_vertices());
 
+    const int ndof = vertices.size();
+
     if (collisions.empty()) {
-        return Eigen::SparseMatrix<double>(vertices.size(), vertices.size());
+        return Eigen::SparseMatrix<double>(ndof, ndof);
     }
 
     const Eigen::MatrixXd& rest_positions = mesh.rest_positions();
     const Eigen::MatrixXi& edges = mesh.edges();
     const Eigen::MatrixXi& faces = mesh.faces();
 
-    const int ndof = vertices.size();
+    const int dim = vertices.cols();
+    const size_t num_collisions = collisions.size();
+
+    // Each collision c contributes to the columns of its weight gradient's
+    // nonzeros (first term) and of its stencil DOFs (second term). In both
+    // cases the rows are the stencil DOFs.
+    //
+    // Local values of collision c: ∇b (n) followed by the second term (n × n),
+    // where n is the number of stencil DOFs.
+    std::vector<std::array<long, 4>> stencils(num_collisions);
+    std::vector<size_t> local_offsets(num_collisions + 1);
+    std::vector<size_t> entry_offsets(num_collisions + 1);
+    local_offsets[0] = entry_offsets[0] = 0;
+    for (size_t i = 0; i < num_collisions; i++) {
+        const Collision& collision = collisions[i];
+        if (collision.weight_gradient.size() <= 0) {
+            throw std::runtime_error(
+                "Shape derivative is not computed for collisions!");
+        }
+        const size_t n = dim * collision.num_vertices();
+        local_offsets[i + 1] = local_offsets[i] + n + n * n;
+        entry_offsets[i + 1] =
+            entry_offsets[i] + collision.weight_gradient.nonZeros() + n;
+    }
 
-    tbb::enumerable_thread_specific<std::vector<Eigen::Triplet<double>>>
-        storage;
+    // A collision's contribution to a single column.
+    struct Entry {
+        int col;
+        /// Local column of the second term or -1 for the first term.
+        int local_col;
+        size_t collision;
+        /// Weight gradient coefficient of the first term.
+        double weight_gradient;
+    };
+
+    std::vector<double> local_values(local_offsets.back());
+    std::vector<Entry> entries(entry_offsets.back());
 
     tbb::parallel_for(
-        tbb::blocked_range<size_t>(size_t(0), collisions.size()),
+        tbb::blocked_range<size_t>(size_t(0), num_collisions),
         [&](const tbb::blocked_range<size_t>& r) {
-            auto& local_triplets = storage.local();
-
+            VectorMax12d grad_b;
+            MatrixMax12d local_hess;
             for (size_t i = r.begin(); i < r.end(); i++) {
-                this->shape_derivative(
-                    collisions[i], collisions[i].vertex_ids(edges, faces),
-                    collisions[i].dof(rest_positions, edges, faces),
-                    collisions[i].dof(vertices, edges, faces), local_triplets);
+                const Collision& collision = collisions[i];
+                stencils[i] = collision.vertex_ids(edges, faces);
+
+                this->shape_derivative_terms(
+                    collision, collision.dof(rest_positions, edges, faces),
+                    collision.dof(vertices, edges, faces), grad_b,
+                    local_hess);
+
+                const int n = dim * collision.num_vertices();
+                double* values = local_values.data() + local_offsets[i];
+                if (grad_b.size()) {
+                    std::copy(grad_b.data(), grad_b.data() + n, values);
+                } else {
+                    std::fill(values, values + n, 0.0);
+                }
+                std::copy(
+                    local_hess.data(), local_hess.data() + n * n, values + n);
+
+                size_t k = entry_offsets[i];
+                using Itr = Eigen::SparseVector<double>::InnerIterator;
+                for (Itr j(collision.weight_gradient); j; ++j) {
+                    entries[k++] = { int(j.index()), -1, i, j.value() };
+                }
+                for (int c = 0; c < n; c++) {
+                    entries[k++] = {
+                        int(dim * stencils[i][c / dim] + c % dim), c, i, 0.0
+                    };
+                }
+                assert(k == entry_offsets[i + 1]);
             }
         });
 
-    Eigen::SparseMatrix<double> shape_derivative(ndof, ndof);
-    for (const auto& local_triplets : storage) {
-        Eigen::SparseMatrix<double> local_shape_derivative(ndof, ndof);
-        local_shape_derivative.setFromTriplets(
-            local_triplets.begin(), local_triplets.end());
-        shape_derivative += local_shape_derivative;
-    }
-    return shape_derivative;
+    // Group the entries by column (the order within a column makes the sums
+    // deterministic).
+    tbb::parallel_sort(
+        entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+            return std::tie(a.col, a.collision, a.local_col)
+                < std::tie(b.col, b.collision, b.local_col);
+        });
+
+    std::vector<size_t> col_starts(ndof + 1);
+    fill_column_starts(
+        entries.size(), [&](const size_t i) { return entries[i].col; }, ndof,
+        col_starts.data());
+
+    const auto num_stencil_dof = [&](const std::array<long, 4>& ids) {
+        return dim
+            * int(std::count_if(
+                ids.begin(), ids.end(), [](long id) { return id >= 0; }));
+    };
+
+    // Sorted rows of column j (the union of its collisions' stencil DOFs).
+    // These are rebuilt in per-thread scratch by both passes below, so only
+    // the matrix's own inner indices are stored at nonzero count.
+    const auto column_rows = [&](const int j, std::vector<int>& rows) {
+        rows.clear();
+        for (size_t e = col_starts[j]; e < col_starts[j + 1]; e++) {
+            const std::array<long, 4>& ids = stencils[entries[e].collision];
+            for (int lr = 0; lr < num_stencil_dof(ids); lr++) {
+                rows.push_back(dim * ids[lr / dim] + lr % dim);
+            }
+        }
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    };
+
+    Eigen::SparseMatrix<double> jac(ndof, ndof);
+    int* outer = jac.outerIndexPtr();
+
+    outer[0] = 0;
+    tbb::parallel_for(
+        tbb::blocked_range<int>(0, ndof),
+        [&](const tbb::blocked_range<int>& r) {
+            std::vector<int> rows;
+            for (int j = r.begin(); j < r.end(); j++) {
+                column_rows(j, rows);
+                outer[j + 1] = rows.size();
+            }
+        });
+    std::partial_sum(outer, outer + ndof + 1, outer);
+
+    jac.resizeNonZeros(outer[ndof]);
+    int* inner = jac.innerIndexPtr();
+    double* values = jac.valuePtr();
+
+    tbb::parallel_for(
+        tbb::blocked_range<int>(0, ndof),
+        [&](const tbb::blocked_range<int>& r) {
+            std::vector<int> rows;
+            for (int j = r.begin(); j < r.end(); j++) {
+                column_rows(j, rows);
+                int* col_inner = inner + outer[j];
+                double* col_values = values + outer[j];
+                std::copy(rows.begin(), rows.end(), col_inner);
+                std::fill(col_values, col_values + rows.size(), 0.0);
+
+                for (size_t e = col_starts[j]; e < col_starts[j + 1]; e++) {
+                    const Entry& entry = entries[e];
+                    const std::array<long, 4>& ids = stencils[entry.collision];
+                    const double* local =
+                        local_values.data() + local_offsets[entry.collision];
+                    const int n = num_stencil_dof(ids);
+                    for (int lr = 0; lr < n; lr++) {
+                        const int row = dim * ids[lr / dim] + lr % dim;
+                        const size_t k = std::lower_bound(
+                                             col_inner,
+                                             col_inner + rows.size(), row)
+                            - col_inner;
+                        // (∇ₓw)(∇ᵤb)ᵀ or w ∇ₓ∇ᵤb
+                        col_values[k] += entry.local_col < 0
+                            ? local[lr] * entry.weight_gradient
+                            : local[n * (entry.local_col + 1) + lr];
+                    }
+                }
+            }
+        });
+
+    return jac;
 }
 
 // -- Single collision methods -------------------------------------------------
@@ -135,7 +703,12 @@ MatrixMax12d DistanceBasedPotential::hessian(
     }
 
     // Need to project entire hessian because w can be negative
-    return project_hessian_to_psd ? project_to_psd(hess) : hess;
+    // NOTE: Only plane-vertex stencils depend on absolute positions.
+    return project_hessian_to_psd
+        ? project_local_hessian_to_psd(
+            hess, positions.size() / collision.num_vertices(),
+            collision.num_vertices() > 1)
+        : hess;
 }
 
 void DistanceBasedPotential::shape_derivative(
@@ -145,11 +718,41 @@ void DistanceBasedPotential::shape_derivative(
     const VectorMax12d& positions,      // = x̄ + u
     std::vector<Eigen::Triplet<double>>& out) const
 {
-    assert(rest_positions.size() == positions.size());
-
     const int dim = positions.size() / collision.num_vertices();
     assert(positions.size() % collision.num_vertices() == 0);
 
+    VectorMax12d grad_b;
+    MatrixMax12d local_hess;
+    shape_derivative_terms(
+        collision, rest_positions, positions, grad_b, local_hess);
+
+    // First term:
+    if (grad_b.size()) {
+        for (int i = 0; i < collision.num_vertices(); i++) {
+            for (int d = 0; d < dim; d++) {
+                using Itr = Eigen::SparseVector<double>::InnerIterator;
+                for (Itr j(collision.weight_gradient); j; ++j) {
+                    out.emplace_back(
+                        vertex_ids[i] * dim + d, j.index(),
+                        grad_b[dim * i + d] * j.value());
+                }
+            }
+        }
+    }
+
+    // Second term:
+    local_hessian_to_global_triplets(local_hess, vertex_ids, dim, out);
+}
+
+void DistanceBasedPotential::shape_derivative_terms(
+    const Collision& collision,
+    const VectorMax12d& rest_positions, // = x̄
+    const VectorMax12d& positions,      // = x̄ + u
+    VectorMax12d& grad_b,
+    MatrixMax12d& local_hess) const
+{
+    assert(rest_positions.size() == positions.size());
+
     // Compute:
     // ∇ₓ (w ∇ᵤf(d(x̄+u))) = (∇ₓw)(∇ᵤf(d(x̄+u)))ᵀ + w ∇ₓ∇ᵤf(d(x̄+u))
     //                         (first term)        (second term)
@@ -161,24 +764,14 @@ void DistanceBasedPotential::shape_derivative(
     }
 
     if (collision.weight_gradient.nonZeros()) {
-        VectorMax12d grad_b = gradient(collision, positions);
+        grad_b = gradient(collision, positions);
         assert(collision.weight != 0);
         grad_b.array() /= collision.weight; // remove weight
-
-        for (int i = 0; i < collision.num_vertices(); i++) {
-            for (int d = 0; d < dim; d++) {
-                using Itr = Eigen::SparseVector<double>::InnerIterator;
-                for (Itr j(collision.weight_gradient); j; ++j) {
-                    out.emplace_back(
-                        vertex_ids[i] * dim + d, j.index(),
-                        grad_b[dim * i + d] * j.value());
-                }
-            }
-        }
+    } else {
+        grad_b.resize(0);
     }
 
     // Second term:
-    MatrixMax12d local_hess;
     if (!collision.is_mollified()) {
         // w ∇ₓ∇ᵤf = w ∇ᵤ²f
         local_hess =
@@ -230,8 +823,6 @@ void DistanceBasedPotential::shape_derivative(
         local_hess = f * jac_m + gradx_m * gradu_f.transpose()
             + gradu_f * gradu_m.transpose() + m * hessu_f;
     }
-
-    local_hessian_to_global_triplets(local_hess, vertex_ids, dim, out);
 }
 
 } // namespace ipc
\ No newline at end of file
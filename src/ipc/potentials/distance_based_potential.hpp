@@ -2,6 +2,7 @@
 
 #include <ipc/potentials/potential.hpp>
 #include <ipc/collisions/collisions.hpp>
+#include <ipc/collisions/compact_collisions.hpp>
 
 namespace ipc {
 
@@ -21,16 +22,46 @@ public:
     using Super::gradient;
     using Super::hessian;
 
+    /// @brief Compute the potential for a set of compact collisions.
+    /// @note Each collision type is evaluated in its own loop with fixed-size kernels.
+    /// @param collisions The set of compact collisions.
+    /// @param vertices Vertices of the collision mesh.
+    /// @returns The sum of all potentials.
+    double operator()(
+        const CompactCollisions& collisions,
+        ConstRef<Eigen::MatrixXd> vertices) const;
+
+    /// @brief Compute the gradient of the potential for a set of compact collisions.
+    /// @note Each collision type is evaluated in its own loop with fixed-size kernels.
+    /// @param collisions The set of compact collisions.
+    /// @param vertices Vertices of the collision mesh.
+    /// @returns The gradient of the potential w.r.t. the vertices.
+    Eigen::VectorXd gradient(
+        const CompactCollisions& collisions,
+        ConstRef<Eigen::MatrixXd> vertices) const;
+
+    /// @brief Compute the hessian of the potential for a set of compact collisions.
+    /// @note Each collision type is evaluated in its own loop with fixed-size kernels.
+    /// @param collisions The set of compact collisions.
+    /// @param vertices Vertices of the collision mesh.
+    /// @param project_hessian_to_psd Make sure the hessian is positive semi-definite.
+    /// @returns The Hessian of the potential w.r.t. the vertices.
+    Eigen::SparseMatrix<double> hessian(
+        const CompactCollisions& collisions,
+        ConstRef<Eigen::MatrixXd> vertices,
+        const bool project_hessian_to_psd = false) const;
+
     /// @brief Compute the shape derivative of the potential.
     /// @param collisions The set of collisions.
     /// @param mesh The collision mesh.
     /// @param vertices Vertices of the collision mesh.
+    /// @note The matrix is assembled directly in compressed form, column by column, without expanding the weight gradients into triplets.
     /// @throws std::runtime_error If the collision collisions were not built with shape derivatives enabled.
     /// @returns The derivative of the force with respect to X, the rest vertices.
     Eigen::SparseMatrix<double> shape_derivative(
         const Collisions& collisions,
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& vertices) const;
+        ConstRef<Eigen::MatrixXd> vertices) const;
 
     // -- Single collision methods ---------------------------------------------
 
@@ -72,6 +103,46 @@ public:
         std::vector<Eigen::Triplet<double>>& out) const;
 
 protected:
+    /// @brief Compute the local terms of the shape derivative for a single collision.
+    /// @param[in] collision The collision.
+    /// @param[in] rest_positions The collision stencil's rest positions.
+    /// @param[in] positions The collision stencil's positions.
+    /// @param[out] grad_b Gradient of the unweighted potential, multiplied by the weight gradient in the first term (empty if the weight gradient is zero).
+    /// @param[out] local_hess Local matrix of the second term.
+    void shape_derivative_terms(
+        const Collision& collision,
+        const VectorMax12d& rest_positions,
+        const VectorMax12d& positions,
+        VectorMax12d& grad_b,
+        MatrixMax12d& local_hess) const;
+
+    /// @brief Compute the potential of a single collision with a fixed-size kernel.
+    /// @param kernel The collision's distance kernel.
+    /// @param x The collision stencil's positions.
+    /// @return The potential.
+    template <typename Kernel>
+    double kernel_potential(
+        const Kernel& kernel, const typename Kernel::Vector& x) const;
+
+    /// @brief Compute the gradient of the potential of a single collision with a fixed-size kernel.
+    /// @param kernel The collision's distance kernel.
+    /// @param x The collision stencil's positions.
+    /// @return The gradient of the potential.
+    template <typename Kernel>
+    typename Kernel::Vector kernel_gradient(
+        const Kernel& kernel, const typename Kernel::Vector& x) const;
+
+    /// @brief Compute the hessian of the potential of a single collision with a fixed-size kernel.
+    /// @param kernel The collision's distance kernel.
+    /// @param x The collision stencil's positions.
+    /// @param project_hessian_to_psd Make sure the hessian is positive semi-definite.
+    /// @return The hessian of the potential.
+    template <typename Kernel>
+    typename Kernel::Matrix kernel_hessian(
+        const Kernel& kernel,
+        const typename Kernel::Vector& x,
+        const bool project_hessian_to_psd) const;
+
     /// @brief Compute the unmollified distance-based potential for a collisions.
     /// @param distance_sqr The distance (squared) between the two objects.
     /// @param dmin The minimum distance (unsquared) between the two objects.
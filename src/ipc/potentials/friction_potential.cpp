@@ -1,5 +1,7 @@
 #include "friction_potential.hpp"
 
+#include <ipc/utils/merge_thread_local.hpp>
+
 namespace ipc {
 
 FrictionPotential::FrictionPotential(const double epsv) : Super()
@@ -12,9 +14,9 @@ FrictionPotential::FrictionPotential(const double epsv) : Super()
 Eigen::VectorXd FrictionPotential::force(
     const FrictionCollisions& collisions,
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& rest_positions,
-    const Eigen::MatrixXd& lagged_displacements,
-    const Eigen::MatrixXd& velocities,
+    ConstRef<Eigen::MatrixXd> rest_positions,
+    ConstRef<Eigen::MatrixXd> lagged_displacements,
+    ConstRef<Eigen::MatrixXd> velocities,
     const double dhat,
     const double barrier_stiffness,
     const double dmin,
@@ -28,13 +30,14 @@ Eigen::VectorXd FrictionPotential::force(
     const Eigen::MatrixXi& edges = mesh.edges();
     const Eigen::MatrixXi& faces = mesh.faces();
 
-    tbb::enumerable_thread_specific<Eigen::VectorXd> storage(
-        Eigen::VectorXd::Zero(velocities.size()));
+    // Only the DOFs referenced by the collision stencils are stored per thread.
+    tbb::enumerable_thread_specific<std::vector<std::pair<long, double>>>
+        storage;
 
     tbb::parallel_for(
         tbb::blocked_range<size_t>(size_t(0), collisions.size()),
         [&](const tbb::blocked_range<size_t>& r) {
-            Eigen::VectorXd& global_force = storage.local();
+            auto& force_entries = storage.local();
             for (size_t i = r.begin(); i < r.end(); i++) {
                 const auto& collision = collisions[i];
 
@@ -48,20 +51,19 @@ Eigen::VectorXd FrictionPotential::force(
                     collision.vertex_ids(mesh.edges(), mesh.faces());
 
                 local_gradient_to_global_gradient(
-                    local_force, vis, dim, global_force);
+                    local_force, vis, dim, force_entries);
             }
         });
 
-    return storage.combine([](const Eigen::VectorXd& a,
-                              const Eigen::VectorXd& b) { return a + b; });
+    return merge_thread_local_gradients(storage, velocities.size());
 }
 
 Eigen::SparseMatrix<double> FrictionPotential::force_jacobian(
     const FrictionCollisions& collisions,
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& rest_positions,
-    const Eigen::MatrixXd& lagged_displacements,
-    const Eigen::MatrixXd& velocities,
+    ConstRef<Eigen::MatrixXd> rest_positions,
+    ConstRef<Eigen::MatrixXd> lagged_displacements,
+    ConstRef<Eigen::MatrixXd> velocities,
     const double dhat,
     const double barrier_stiffness,
     const DiffWRT wrt,
@@ -87,10 +89,15 @@ Eigen::SparseMatrix<double> FrictionPotential::force_jacobian(
             for (size_t i = r.begin(); i < r.end(); i++) {
                 const FrictionCollision& collision = collisions[i];
 
+                const VectorMax12d rest_dof =
+                    collision.dof(rest_positions, edges, faces);
+                const VectorMax12d lagged_dof =
+                    collision.dof(lagged_displacements, edges, faces);
+                const VectorMax12d velocity_dof =
+                    collision.dof(velocities, edges, faces);
+
                 const MatrixMax12d local_force_jacobian = force_jacobian(
-                    collision, collision.dof(rest_positions, edges, faces),
-                    collision.dof(lagged_displacements, edges, faces),
-                    collision.dof(velocities, edges, faces), //
+                    collision, rest_dof, lagged_dof, velocity_dof, //
                     dhat, barrier_stiffness, wrt, dmin);
 
                 const std::array<long, 4> vis =
@@ -98,46 +105,42 @@ Eigen::SparseMatrix<double> FrictionPotential::force_jacobian(
 
                 local_hessian_to_global_triplets(
                     local_force_jacobian, vis, dim, jac_triplets);
-            }
-        });
-
-    Eigen::SparseMatrix<double> jacobian(velocities.size(), velocities.size());
-    for (const auto& local_jac_triplets : storage) {
-        Eigen::SparseMatrix<double> local_jacobian(
-            velocities.size(), velocities.size());
-        local_jacobian.setFromTriplets(
-            local_jac_triplets.begin(), local_jac_triplets.end());
-        jacobian += local_jacobian;
-    }
-
-    // if wrt == X then compute ∇ₓ w(x)
-    if (wrt == DiffWRT::REST_POSITIONS) {
-        for (int i = 0; i < collisions.size(); i++) {
-            const FrictionCollision& collision = collisions[i];
-            assert(collision.weight_gradient.size() == rest_positions.size());
-            if (collision.weight_gradient.size() != rest_positions.size()) {
-                throw std::runtime_error(
-                    "Shape derivative is not computed for friction collision!");
-            }
 
-            VectorMax12d local_force = force(
-                collision, collision.dof(rest_positions, edges, faces),
-                collision.dof(lagged_displacements, edges, faces),
-                collision.dof(velocities, edges, faces), //
-                dhat, barrier_stiffness, dmin);
-            assert(collision.weight != 0);
-            local_force /= collision.weight;
+                if (wrt != DiffWRT::REST_POSITIONS) {
+                    continue;
+                }
 
-            Eigen::SparseVector<double> force(rest_positions.size());
-            force.reserve(local_force.size());
-            local_gradient_to_global_gradient(
-                local_force, collision.vertex_ids(edges, faces), dim, force);
+                // ∇ₓ w(x) term: the outer product (F / w) (∇ₓ w)ᵀ
+                assert(
+                    collision.weight_gradient.size() == rest_positions.size());
+                if (collision.weight_gradient.size()
+                    != rest_positions.size()) {
+                    throw std::runtime_error(
+                        "Shape derivative is not computed for friction "
+                        "collision!");
+                }
 
-            jacobian += force * collision.weight_gradient.transpose();
-        }
-    }
+                VectorMax12d local_force = force(
+                    collision, rest_dof, lagged_dof, velocity_dof, //
+                    dhat, barrier_stiffness, dmin);
+                assert(collision.weight != 0);
+                local_force /= collision.weight;
+
+                using Itr = Eigen::SparseVector<double>::InnerIterator;
+                for (int vi = 0; vi < collision.num_vertices(); vi++) {
+                    for (int d = 0; d < dim; d++) {
+                        for (Itr j(collision.weight_gradient); j; ++j) {
+                            jac_triplets.emplace_back(
+                                vis[vi] * dim + d, j.index(),
+                                local_force[dim * vi + d] * j.value());
+                        }
+                    }
+                }
+            }
+        });
 
-    return jacobian;
+    return merge_thread_local_triplets(
+        storage, velocities.size(), velocities.size());
 }
 // -- Single collision methods -------------------------------------------------
 
@@ -246,7 +249,10 @@ MatrixMax12d FrictionPotential::hessian(
         inner_hess.diagonal().array() += f1_over_norm_u;
         inner_hess *= scale; // NOTE: negative scaling will be projected out
         if (project_hessian_to_psd) {
-            inner_hess = project_to_psd(inner_hess);
+            inner_hess =
+                m_psd_projection_method == PSDProjectionMethod::REDUCED
+                ? project_to_psd_direct(inner_hess)
+                : project_to_psd(inner_hess);
         }
 
         hess = T * inner_hess * T.transpose();
@@ -54,9 +54,9 @@ public:
     Eigen::VectorXd force(
         const FrictionCollisions& collisions,
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& rest_positions,
-        const Eigen::MatrixXd& lagged_displacements,
-        const Eigen::MatrixXd& velocities,
+        ConstRef<Eigen::MatrixXd> rest_positions,
+        ConstRef<Eigen::MatrixXd> lagged_displacements,
+        ConstRef<Eigen::MatrixXd> velocities,
         const double dhat,
         const double barrier_stiffness,
         const double dmin = 0,
@@ -76,9 +76,9 @@ public:
     Eigen::SparseMatrix<double> force_jacobian(
         const FrictionCollisions& collisions,
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& rest_positions,
-        const Eigen::MatrixXd& lagged_displacements,
-        const Eigen::MatrixXd& velocities,
+        ConstRef<Eigen::MatrixXd> rest_positions,
+        ConstRef<Eigen::MatrixXd> lagged_displacements,
+        ConstRef<Eigen::MatrixXd> velocities,
         const double dhat,
         const double barrier_stiffness,
         const DiffWRT wrt,
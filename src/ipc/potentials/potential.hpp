@@ -2,6 +2,7 @@
 
 #include <ipc/collision_mesh.hpp>
 #include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/sparsity_pattern.hpp>
 
 namespace ipc {
 
@@ -15,6 +16,19 @@ public:
     Potential() { }
     virtual ~Potential() { }
 
+    /// @brief Get the method used to project local hessians onto the positive semi-definite cone.
+    PSDProjectionMethod psd_projection_method() const
+    {
+        return m_psd_projection_method;
+    }
+
+    /// @brief Set the method used to project local hessians onto the positive semi-definite cone.
+    /// @param method The projection method.
+    void set_psd_projection_method(const PSDProjectionMethod method)
+    {
+        m_psd_projection_method = method;
+    }
+
     // -- Cumulative methods ---------------------------------------------------
 
     /// @brief Compute the potential for a set of collisions.
@@ -25,7 +39,7 @@ public:
     double operator()(
         const TCollisions& collisions,
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& X) const;
+        ConstRef<Eigen::MatrixXd> X) const;
 
     /// @brief Compute the gradient of the potential.
     /// @param collisions The set of collisions.
@@ -35,7 +49,7 @@ public:
     Eigen::VectorXd gradient(
         const TCollisions& collisions,
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& X) const;
+        ConstRef<Eigen::MatrixXd> X) const;
 
     /// @brief Compute the hessian of the potential.
     /// @param collisions The set of collisions.
@@ -46,7 +60,23 @@ public:
     Eigen::SparseMatrix<double> hessian(
         const TCollisions& collisions,
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& X,
+        ConstRef<Eigen::MatrixXd> X,
+        const bool project_hessian_to_psd = false) const;
+
+    /// @brief Compute the hessian of the potential reusing a cached sparsity pattern.
+    /// @note The pattern is rebuilt automatically when the collision stencils change. Otherwise, only the values of hess are overwritten in place, so its sparsity (and any symbolic factorization of it) stays valid.
+    /// @param collisions The set of collisions.
+    /// @param mesh The collision mesh.
+    /// @param X Degrees of freedom of the collision mesh (e.g., vertices or velocities).
+    /// @param[in,out] pattern Cached sparsity pattern of the hessian.
+    /// @param[in,out] hess The Hessian of the potential w.r.t. X. This will have a size of |X|×|X|.
+    /// @param project_hessian_to_psd Make sure the hessian is positive semi-definite.
+    void hessian(
+        const TCollisions& collisions,
+        const CollisionMesh& mesh,
+        ConstRef<Eigen::MatrixXd> X,
+        SparsityPattern& pattern,
+        Eigen::SparseMatrix<double>& hess,
         const bool project_hessian_to_psd = false) const;
 
     // -- Single collision methods ---------------------------------------------
@@ -73,6 +103,28 @@ public:
         const TCollision& collision,
         const VectorMax12d& x,
         const bool project_hessian_to_psd = false) const = 0;
+
+protected:
+    /// @brief Project a local hessian onto the positive semi-definite cone.
+    /// @param hess The local hessian.
+    /// @param dim Dimension of the stencil's vertices.
+    /// @param is_translation_invariant Whether the hessian is invariant to translating the whole stencil (required by PSDProjectionMethod::REDUCED).
+    /// @return The projected hessian.
+    template <typename Matrix>
+    Matrix project_local_hessian_to_psd(
+        const Matrix& hess,
+        const int dim,
+        const bool is_translation_invariant) const
+    {
+        if (is_translation_invariant
+            && m_psd_projection_method == PSDProjectionMethod::REDUCED) {
+            return project_translation_invariant_to_psd(hess, dim);
+        }
+        return project_to_psd(hess);
+    }
+
+    /// @brief Method used to project local hessians onto the PSD cone.
+    PSDProjectionMethod m_psd_projection_method = PSDProjectionMethod::FULL;
 };
 
 } // namespace ipc
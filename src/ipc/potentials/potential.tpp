@@ -3,6 +3,7 @@
 #include "potential.hpp"
 
 #include <ipc/utils/local_to_global.hpp>
+#include <ipc/utils/merge_thread_local.hpp>
 
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range.h>
@@ -14,7 +15,7 @@ template <class TCollisions>
 double Potential<TCollisions>::operator()(
     const TCollisions& collisions,
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& X) const
+    ConstRef<Eigen::MatrixXd> X) const
 {
     assert(X.rows() == mesh.num_vertices());
 
@@ -43,7 +44,7 @@ template <class TCollisions>
 Eigen::VectorXd Potential<TCollisions>::gradient(
     const TCollisions& collisions,
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& X) const
+    ConstRef<Eigen::MatrixXd> X) const
 {
     assert(X.rows() == mesh.num_vertices());
 
@@ -53,13 +54,14 @@ Eigen::VectorXd Potential<TCollisions>::gradient(
 
     const int dim = X.cols();
 
-    tbb::enumerable_thread_specific<Eigen::VectorXd> storage(
-        Eigen::VectorXd::Zero(X.size()));
+    // Only the DOFs referenced by the collision stencils are stored per thread.
+    tbb::enumerable_thread_specific<std::vector<std::pair<long, double>>>
+        storage;
 
     tbb::parallel_for(
         tbb::blocked_range<size_t>(size_t(0), collisions.size()),
         [&](const tbb::blocked_range<size_t>& r) {
-            auto& global_grad = storage.local();
+            auto& grad_entries = storage.local();
 
             for (size_t i = r.begin(); i < r.end(); i++) {
                 const TCollision& collision = collisions[i];
@@ -71,19 +73,18 @@ Eigen::VectorXd Potential<TCollisions>::gradient(
                     collision.vertex_ids(mesh.edges(), mesh.faces());
 
                 local_gradient_to_global_gradient(
-                    local_grad, vids, dim, global_grad);
+                    local_grad, vids, dim, grad_entries);
             }
         });
 
-    return storage.combine([](const Eigen::VectorXd& a,
-                              const Eigen::VectorXd& b) { return a + b; });
+    return merge_thread_local_gradients(storage, X.size());
 }
 
 template <class TCollisions>
 Eigen::SparseMatrix<double> Potential<TCollisions>::hessian(
     const TCollisions& collisions,
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& X,
+    ConstRef<Eigen::MatrixXd> X,
     const bool project_hessian_to_psd) const
 {
     assert(X.rows() == mesh.num_vertices());
@@ -121,14 +122,54 @@ Eigen::SparseMatrix<double> Potential<TCollisions>::hessian(
             }
         });
 
-    Eigen::SparseMatrix<double> hess(ndof, ndof);
-    for (const auto& local_hess_triplets : storage) {
-        Eigen::SparseMatrix<double> local_hess(ndof, ndof);
-        local_hess.setFromTriplets(
-            local_hess_triplets.begin(), local_hess_triplets.end());
-        hess += local_hess;
+    return merge_thread_local_triplets(storage, ndof, ndof);
+}
+
+template <class TCollisions>
+void Potential<TCollisions>::hessian(
+    const TCollisions& collisions,
+    const CollisionMesh& mesh,
+    ConstRef<Eigen::MatrixXd> X,
+    SparsityPattern& pattern,
+    Eigen::SparseMatrix<double>& hess,
+    const bool project_hessian_to_psd) const
+{
+    assert(X.rows() == mesh.num_vertices());
+
+    const Eigen::MatrixXi& edges = mesh.edges();
+    const Eigen::MatrixXi& faces = mesh.faces();
+
+    const int dim = X.cols();
+
+    std::vector<std::array<long, 4>> stencils(collisions.size());
+    tbb::parallel_for(size_t(0), collisions.size(), [&](size_t i) {
+        stencils[i] = collisions[i].vertex_ids(edges, faces);
+    });
+
+    if (!pattern.matches(stencils, dim, X.size())) {
+        pattern.build(std::move(stencils), dim, X.size());
     }
-    return hess;
+
+    std::vector<double> local_values(pattern.num_local_entries());
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), collisions.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                const MatrixMax12d local_hess = this->hessian(
+                    collisions[i], collisions[i].dof(X, edges, faces),
+                    project_hessian_to_psd);
+
+                assert(
+                    pattern.local_offset(i) + local_hess.size()
+                    == pattern.local_offset(i + 1));
+                std::copy(
+                    local_hess.data(), local_hess.data() + local_hess.size(),
+                    local_values.begin() + pattern.local_offset(i));
+            }
+        });
+
+    pattern.assemble(local_values, hess);
 }
 
 } // namespace ipc
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <cassert>
+
+namespace ipc {
+
+/// @brief Fill the start of each column of items sorted by column (e.g., the outer indices of a compressed column-major matrix).
+/// @note The first item of a column also starts any empty columns preceding it, so each item only writes the columns between its predecessor's and its own.
+/// @param num_items Number of items.
+/// @param column_of Function returning the column of item i. It must be nondecreasing in i.
+/// @param num_cols Number of columns.
+/// @param[out] starts Start of each column (size num_cols + 1): the index of the first item whose column is ≥ c, or num_items.
+template <typename ColumnOf, typename Index>
+void fill_column_starts(
+    const size_t num_items,
+    const ColumnOf& column_of,
+    const Eigen::Index num_cols,
+    Index* starts)
+{
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), num_items),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                const Eigen::Index col = column_of(i);
+                const Eigen::Index prev_col =
+                    i == 0 ? -1 : Eigen::Index(column_of(i - 1));
+                assert(prev_col <= col && col < num_cols);
+                for (Eigen::Index c = prev_col + 1; c <= col; c++) {
+                    starts[c] = Index(i);
+                }
+            }
+        });
+
+    const Eigen::Index last_col =
+        num_items == 0 ? -1 : Eigen::Index(column_of(num_items - 1));
+    for (Eigen::Index c = last_col + 1; c <= num_cols; c++) {
+        starts[c] = Index(num_items);
+    }
+}
+
+} // namespace ipc
@@ -35,6 +35,12 @@ using Matrix6d = Eigen::Matrix<double, 6, 6>;
 using Matrix9d = Eigen::Matrix<double, 9, 9>;
 using Matrix12d = Eigen::Matrix<double, 12, 12>;
 
+/// @brief A read-only reference to a dense matrix with any strides.
+/// @note Column-major matrices, blocks, and strided maps (e.g., a C-ordered NumPy array mapped by pybind11) bind to it without a copy.
+template <typename T>
+using ConstRef = const Eigen::
+    Ref<const T, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>&;
+
 /// @brief A dynamic size matrix with a fixed maximum size of 3×1
 template <typename T> using VectorMax2 = Vector<T, Eigen::Dynamic, 2>;
 /// @brief A dynamic size matrix with a fixed maximum size of 3×1
@@ -151,6 +157,49 @@ project_to_psd(
     const Eigen::Matrix<_Scalar, _Rows, _Cols, _Options, _MaxRows, _MaxCols>&
         A);
 
+/// @brief Methods of projecting local hessians onto the positive semi-definite cone.
+enum class PSDProjectionMethod {
+    /// Eigen-decompose the full local hessian.
+    FULL,
+    /// Eigen-decompose only the restriction of the local hessian to relative
+    /// vertex motions (see project_translation_invariant_to_psd).
+    REDUCED
+};
+
+/// @brief Matrix projection onto positive semi-definite cone using closed-form eigenpairs
+/// @note Only 1×1 and 2×2 matrices are solved in closed form; larger matrices fall back to project_to_psd.
+/// @param A Symmetric matrix to project
+/// @return Projected matrix
+template <
+    typename _Scalar,
+    int _Rows,
+    int _Cols,
+    int _Options,
+    int _MaxRows,
+    int _MaxCols>
+Eigen::Matrix<_Scalar, _Rows, _Cols, _Options, _MaxRows, _MaxCols>
+project_to_psd_direct(
+    const Eigen::Matrix<_Scalar, _Rows, _Cols, _Options, _MaxRows, _MaxCols>&
+        A);
+
+/// @brief Matrix projection onto positive semi-definite cone of a translation-invariant stencil hessian
+/// @note The hessian must not change when all vertices of the stencil are translated together (e.g., any distance-based or friction hessian of a stencil with more than one vertex). It is then zero along rigid translations, so only its (n - dim) × (n - dim) restriction to relative motions is projected (with project_to_psd_direct).
+/// @param A Symmetric n×n hessian of a stencil of n / dim vertices
+/// @param dim Dimension of the vertices
+/// @return Projected matrix
+template <
+    typename _Scalar,
+    int _Rows,
+    int _Cols,
+    int _Options,
+    int _MaxRows,
+    int _MaxCols>
+Eigen::Matrix<_Scalar, _Rows, _Cols, _Options, _MaxRows, _MaxCols>
+project_translation_invariant_to_psd(
+    const Eigen::Matrix<_Scalar, _Rows, _Cols, _Options, _MaxRows, _MaxCols>&
+        A,
+    const int dim);
+
 inline Eigen::Vector3d to_3D(const VectorMax3d& v)
 {
     assert(v.size() == 2 || v.size() == 3);
@@ -6,6 +6,7 @@
 
 #include <Eigen/Eigenvalues>
 
+#include <cmath>
 #include <stdexcept> // std::runtime_error
 
 namespace ipc {
@@ -95,4 +96,102 @@ project_to_psd(
         * eigensolver.eigenvectors().transpose();
 }
 
+namespace internal {
+    /// @brief Project an N×N matrix using closed-form eigenpairs.
+    template <int N, typename Matrix>
+    Matrix project_to_psd_direct(const Matrix& A)
+    {
+        if constexpr (
+            Matrix::RowsAtCompileTime != Eigen::Dynamic
+            && Matrix::RowsAtCompileTime != N) {
+            assert(false);
+            return A;
+        } else {
+            using MatrixN = Eigen::Matrix<typename Matrix::Scalar, N, N>;
+            Eigen::SelfAdjointEigenSolver<MatrixN> eigensolver;
+            eigensolver.computeDirect(MatrixN(A));
+            // The eigenvalues are sorted in increasing order.
+            if (eigensolver.eigenvalues()[0] >= 0.0) {
+                return A;
+            }
+            return eigensolver.eigenvectors()
+                * eigensolver.eigenvalues().cwiseMax(0.0).asDiagonal()
+                * eigensolver.eigenvectors().transpose();
+        }
+    }
+} // namespace internal
+
+// Matrix Projection onto Positive Semi-Definite Cone (closed form)
+template <
+    typename _Scalar,
+    int _Rows,
+    int _Cols,
+    int _Options,
+    int _MaxRows,
+    int _MaxCols>
+Eigen::Matrix<_Scalar, _Rows, _Cols, _Options, _MaxRows, _MaxCols>
+project_to_psd_direct(
+    const Eigen::Matrix<_Scalar, _Rows, _Cols, _Options, _MaxRows, _MaxCols>& A)
+{
+    assert(A.rows() == A.cols());
+    assert(A.isApprox(A.transpose()) && "A must be symmetric");
+
+    // NOTE: Eigen's closed-form 3×3 eigenvectors lose accuracy for (nearly)
+    // repeated eigenvalues (e.g., point-point barrier hessians), so only 1×1
+    // and 2×2 matrices are solved in closed form.
+    switch (A.rows()) {
+    case 1:
+        return A.cwiseMax(0.0);
+    case 2:
+        return internal::project_to_psd_direct<2>(A);
+    default:
+        return project_to_psd(A);
+    }
+}
+
+// Matrix Projection of a Translation-Invariant Hessian onto Positive
+// Semi-Definite Cone
+template <
+    typename _Scalar,
+    int _Rows,
+    int _Cols,
+    int _Options,
+    int _MaxRows,
+    int _MaxCols>
+Eigen::Matrix<_Scalar, _Rows, _Cols, _Options, _MaxRows, _MaxCols>
+project_translation_invariant_to_psd(
+    const Eigen::Matrix<_Scalar, _Rows, _Cols, _Options, _MaxRows, _MaxCols>& A,
+    const int dim)
+{
+    assert(A.isApprox(A.transpose()) && "A must be symmetric");
+    assert(dim > 0 && A.rows() % dim == 0 && A.rows() <= 12);
+
+    const int num_vertices = A.rows() / dim;
+    if (num_vertices <= 1) {
+        return project_to_psd(A);
+    }
+
+    // Orthonormal basis of relative motions: the Helmert contrasts of the
+    // vertices, repeated for each coordinate. The k-th contrast averages the
+    // first k vertices against the (k+1)-th.
+    MatrixMax<_Scalar, 12, 9> Q =
+        MatrixMax<_Scalar, 12, 9>::Zero(A.rows(), A.rows() - dim);
+    for (int k = 1; k < num_vertices; k++) {
+        const _Scalar s = _Scalar(1) / std::sqrt(_Scalar(k * (k + 1)));
+        for (int d = 0; d < dim; d++) {
+            const int col = (k - 1) * dim + d;
+            for (int i = 0; i < k; i++) {
+                Q(i * dim + d, col) = s;
+            }
+            Q(k * dim + d, col) = -k * s;
+        }
+    }
+
+    const MatrixMax<_Scalar, 9, 9> reduced = Q.transpose() * A * Q;
+    const MatrixMax<_Scalar, 9, 9> reduced_psd =
+        project_to_psd_direct(reduced);
+
+    return Q * reduced_psd * Q.transpose();
+}
+
 } // namespace ipc
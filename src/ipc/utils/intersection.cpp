@@ -121,7 +121,12 @@ bool is_edge_intersecting_triangle(
     const Eigen::Vector3d& t1,
     const Eigen::Vector3d& t2)
 {
-    igl::predicates::exactinit();
+    // Initialize the exact predicates once (thread-safe) instead of per call.
+    [[maybe_unused]] static const bool is_exactinit_done = []() {
+        igl::predicates::exactinit();
+        return true;
+    }();
+
     const auto ori1 = igl::predicates::orient3d(t0, t1, t2, e0);
     const auto ori2 = igl::predicates::orient3d(t0, t1, t2, e1);
 
@@ -3,6 +3,7 @@
 #include <Eigen/Core>
 #include <Eigen/Sparse>
 
+#include <utility>
 #include <vector>
 
 namespace ipc {
@@ -42,6 +43,24 @@ void local_gradient_to_global_gradient(
     }
 }
 
+template <typename DerivedLocalGrad, typename IDContainer>
+void local_gradient_to_global_gradient(
+    const Eigen::MatrixBase<DerivedLocalGrad>& local_grad,
+    const IDContainer& ids,
+    int dim,
+    std::vector<std::pair<long, double>>& grad_entries)
+{
+    assert(local_grad.size() % dim == 0);
+    const int n_verts = local_grad.size() / dim;
+    assert(ids.size() >= n_verts); // Can be extra ids
+    for (int i = 0; i < n_verts; i++) {
+        for (int d = 0; d < dim; d++) {
+            grad_entries.emplace_back(
+                dim * ids[i] + d, local_grad(dim * i + d));
+        }
+    }
+}
+
 template <typename Derived, typename IDContainer>
 void local_hessian_to_global_triplets(
     const Eigen::MatrixBase<Derived>& local_hessian,
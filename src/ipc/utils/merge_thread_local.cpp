@@ -0,0 +1,175 @@
+#include "merge_thread_local.hpp"
+
+#include <ipc/utils/column_starts.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_scan.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <functional>
+
+namespace ipc {
+
+namespace {
+    /// @brief Number of consecutive gradient entries summed by one task.
+    constexpr long GRADIENT_BLOCK_SIZE = 1024;
+} // namespace
+
+Eigen::SparseMatrix<double> merge_thread_local_triplets(
+    tbb::enumerable_thread_specific<std::vector<Eigen::Triplet<double>>>&
+        storage,
+    const Eigen::Index rows,
+    const Eigen::Index cols)
+{
+    using Triplet = Eigen::Triplet<double>;
+
+    // Gather the thread-local triplets into a single array.
+    std::vector<std::vector<Triplet>*> local_triplets;
+    std::vector<size_t> offsets = { 0 };
+    for (auto& local : storage) {
+        local_triplets.push_back(&local);
+        offsets.push_back(offsets.back() + local.size());
+    }
+
+    std::vector<Triplet> triplets(offsets.back());
+    tbb::parallel_for(size_t(0), local_triplets.size(), [&](size_t i) {
+        std::copy(
+            local_triplets[i]->begin(), local_triplets[i]->end(),
+            triplets.begin() + offsets[i]);
+        std::vector<Triplet>().swap(*local_triplets[i]); // release memory
+    });
+
+    // Sort in column-major order to match the storage order of the matrix.
+    tbb::parallel_sort(
+        triplets.begin(), triplets.end(),
+        [](const Triplet& a, const Triplet& b) {
+            return a.col() < b.col()
+                || (a.col() == b.col() && a.row() < b.row());
+        });
+
+    const size_t n = triplets.size();
+    const auto is_first = [&](const size_t i) {
+        return i == 0 || triplets[i].col() != triplets[i - 1].col()
+            || triplets[i].row() != triplets[i - 1].row();
+    };
+
+    // Index of the nonzero each triplet contributes to.
+    std::vector<int> entry(n);
+    tbb::parallel_scan(
+        tbb::blocked_range<size_t>(size_t(0), n), 0,
+        [&](const tbb::blocked_range<size_t>& r, int sum,
+            const bool is_final_scan) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                sum += is_first(i);
+                if (is_final_scan) {
+                    entry[i] = sum - 1;
+                }
+            }
+            return sum;
+        },
+        std::plus<int>());
+    const int nnz = n == 0 ? 0 : (entry.back() + 1);
+
+    Eigen::SparseMatrix<double> matrix(rows, cols);
+    matrix.resizeNonZeros(nnz);
+    int* inner = matrix.innerIndexPtr();
+    double* values = matrix.valuePtr();
+    std::vector<int> nonzero_cols(nnz);
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), n),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                if (!is_first(i)) {
+                    continue;
+                }
+
+                // Sum the duplicate entries.
+                double value = triplets[i].value();
+                for (size_t j = i + 1; j < n && !is_first(j); j++) {
+                    value += triplets[j].value();
+                }
+                inner[entry[i]] = triplets[i].row();
+                values[entry[i]] = value;
+                nonzero_cols[entry[i]] = triplets[i].col();
+            }
+        });
+
+    fill_column_starts(
+        nnz, [&](const size_t k) { return nonzero_cols[k]; }, cols,
+        matrix.outerIndexPtr());
+
+    return matrix;
+}
+
+Eigen::VectorXd merge_thread_local_gradients(
+    tbb::enumerable_thread_specific<std::vector<std::pair<long, double>>>&
+        storage,
+    const Eigen::Index size)
+{
+    using Entry = std::pair<long, double>;
+
+    Eigen::VectorXd grad = Eigen::VectorXd::Zero(size);
+
+    std::vector<std::vector<Entry>*> local_entries;
+    for (auto& local : storage) {
+        if (!local.empty()) {
+            local_entries.push_back(&local);
+        }
+    }
+    if (local_entries.empty()) {
+        return grad;
+    }
+
+    // Bucket the entries by contiguous blocks of the vector, so each block can
+    // be summed by a single task without synchronization.
+    const size_t num_blocks = std::max<size_t>(
+        1, (size + GRADIENT_BLOCK_SIZE - 1) / GRADIENT_BLOCK_SIZE);
+    const size_t num_locals = local_entries.size();
+
+    // 1. Count the entries of each thread in each block.
+    std::vector<size_t> offsets(num_locals * num_blocks, 0);
+    tbb::parallel_for(size_t(0), num_locals, [&](size_t t) {
+        size_t* counts = offsets.data() + t * num_blocks;
+        for (const auto& [i, value] : *local_entries[t]) {
+            assert(i >= 0 && i < size);
+            counts[i / GRADIENT_BLOCK_SIZE]++;
+        }
+    });
+
+    // 2. Offsets of each (thread, block) bucket ordered by block then thread.
+    std::vector<size_t> block_offsets(num_blocks + 1);
+    size_t num_entries = 0;
+    for (size_t b = 0; b < num_blocks; b++) {
+        block_offsets[b] = num_entries;
+        for (size_t t = 0; t < num_locals; t++) {
+            const size_t count = offsets[t * num_blocks + b];
+            offsets[t * num_blocks + b] = num_entries;
+            num_entries += count;
+        }
+    }
+    block_offsets.back() = num_entries;
+
+    // 3. Scatter the entries into their buckets.
+    std::vector<Entry> entries(num_entries);
+    tbb::parallel_for(size_t(0), num_locals, [&](size_t t) {
+        size_t* next = offsets.data() + t * num_blocks;
+        for (const Entry& entry : *local_entries[t]) {
+            entries[next[entry.first / GRADIENT_BLOCK_SIZE]++] = entry;
+        }
+        std::vector<Entry>().swap(*local_entries[t]); // release memory
+    });
+
+    // 4. Sum the entries of each block.
+    tbb::parallel_for(size_t(0), num_blocks, [&](size_t b) {
+        for (size_t j = block_offsets[b]; j < block_offsets[b + 1]; j++) {
+            grad[entries[j].first] += entries[j].second;
+        }
+    });
+
+    return grad;
+}
+
+} // namespace ipc
@@ -2,26 +2,94 @@
 
 #include <ipc/utils/unordered_map_and_set.hpp>
 
+#include <Eigen/Sparse>
 #include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <utility>
 #include <vector>
 
 namespace ipc {
 
+/// @brief Append thread-local vectors to a vector.
+/// @note Each thread-local vector is copied to its offset in parallel.
+/// @param vectors Thread-local vectors.
+/// @param out Vector to append to.
 template <typename T>
 void merge_thread_local_vectors(
     const tbb::enumerable_thread_specific<std::vector<T>>& vectors,
     std::vector<T>& out)
 {
-    // size up the items
-    size_t size = out.size();
+    // size up the items and place each vector after the previous ones
+    std::vector<const std::vector<T>*> locals;
+    std::vector<size_t> offsets = { out.size() };
     for (const auto& vector : vectors) {
-        size += vector.size();
+        if (!vector.empty()) {
+            locals.push_back(&vector);
+            offsets.push_back(offsets.back() + vector.size());
+        }
     }
-    // serial merge!
-    out.reserve(size);
-    for (const auto& vector : vectors) {
-        out.insert(out.end(), vector.begin(), vector.end());
+    if (locals.empty()) {
+        return;
+    }
+    // T need not be default constructible, so fill with a placeholder item.
+    out.resize(offsets.back(), locals[0]->front());
+
+    tbb::parallel_for(size_t(0), locals.size(), [&](size_t i) {
+        std::copy(
+            locals[i]->begin(), locals[i]->end(), out.begin() + offsets[i]);
+    });
+}
+
+/// @brief Merge thread-local vectors into a sorted vector without duplicates.
+/// @note Each thread-local vector is sorted and deduplicated before they are gathered, so duplicates found by the same thread are never copied. The thread-local vectors are left sorted.
+/// @param vectors Thread-local vectors.
+/// @param out Vector to merge into. Its existing items are also sorted and deduplicated.
+template <typename T>
+void merge_thread_local_vectors_unique(
+    tbb::enumerable_thread_specific<std::vector<T>>& vectors,
+    std::vector<T>& out)
+{
+    std::vector<std::vector<T>*> locals;
+    for (auto& vector : vectors) {
+        locals.push_back(&vector);
+    }
+
+    tbb::parallel_for(size_t(0), locals.size(), [&](size_t i) {
+        tbb::parallel_sort(locals[i]->begin(), locals[i]->end());
+        locals[i]->erase(
+            std::unique(locals[i]->begin(), locals[i]->end()),
+            locals[i]->end());
+    });
+
+    // The existing items and each thread-local vector form sorted runs.
+    tbb::parallel_sort(out.begin(), out.end());
+    std::vector<size_t> runs = { 0, out.size() };
+    for (const auto* local : locals) {
+        if (!local->empty()) {
+            runs.push_back(runs.back() + local->size());
+        }
     }
+
+    merge_thread_local_vectors(vectors, out);
+
+    // Merge pairs of adjacent runs until a single sorted run remains.
+    const size_t num_runs = runs.size() - 1;
+    for (size_t stride = 1; stride < num_runs; stride *= 2) {
+        tbb::parallel_for(
+            size_t(0), (num_runs + stride - 1) / (2 * stride), [&](size_t i) {
+                const size_t begin = runs[2 * i * stride];
+                const size_t mid = runs[(2 * i + 1) * stride];
+                const size_t end =
+                    runs[std::min((2 * i + 2) * stride, num_runs)];
+                std::inplace_merge(
+                    out.begin() + begin, out.begin() + mid, out.begin() + end);
+            });
+    }
+
+    out.erase(std::unique(out.begin(), out.end()), out.end());
 }
 
 template <typename T>
@@ -41,4 +109,26 @@ void merge_thread_local_unordered_sets(
     }
 }
 
+/// @brief Assemble a sparse matrix from thread-local triplets.
+/// @note Duplicate entries are summed. The triplets are gathered, sorted, and reduced in parallel, so no intermediate sparse matrices are formed. The thread-local storage is released as it is gathered.
+/// @param storage Thread-local triplets.
+/// @param rows Number of rows in the matrix.
+/// @param cols Number of columns in the matrix.
+/// @return The assembled (compressed) sparse matrix.
+Eigen::SparseMatrix<double> merge_thread_local_triplets(
+    tbb::enumerable_thread_specific<std::vector<Eigen::Triplet<double>>>&
+        storage,
+    const Eigen::Index rows,
+    const Eigen::Index cols);
+
+/// @brief Assemble a dense vector from thread-local (index, value) entries.
+/// @note Duplicate entries are summed. Only the referenced entries are touched, so the cost scales with the number of entries rather than with the number of threads times the size of the vector. The thread-local storage is released as it is merged.
+/// @param storage Thread-local (index, value) entries.
+/// @param size Size of the vector.
+/// @return The assembled vector.
+Eigen::VectorXd merge_thread_local_gradients(
+    tbb::enumerable_thread_specific<std::vector<std::pair<long, double>>>&
+        storage,
+    const Eigen::Index size);
+
 } // namespace ipc
\ No newline at end of file
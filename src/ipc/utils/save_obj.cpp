@@ -12,7 +12,7 @@ namespace ipc {
 template <>
 void save_obj(
     std::ostream& out,
-    const Eigen::MatrixXd& V,
+    ConstRef<Eigen::MatrixXd> V,
     const Eigen::MatrixXi&,
     const Eigen::MatrixXi&,
     const std::vector<VertexVertexCandidate>& vv_candidates,
@@ -28,7 +28,7 @@ void save_obj(
 template <>
 void save_obj(
     std::ostream& out,
-    const Eigen::MatrixXd& V,
+    ConstRef<Eigen::MatrixXd> V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     const std::vector<EdgeVertexCandidate>& ev_candidates,
@@ -48,7 +48,7 @@ void save_obj(
 template <>
 void save_obj(
     std::ostream& out,
-    const Eigen::MatrixXd& V,
+    ConstRef<Eigen::MatrixXd> V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     const std::vector<EdgeEdgeCandidate>& ee_candidates,
@@ -70,7 +70,7 @@ void save_obj(
 template <>
 void save_obj(
     std::ostream& out,
-    const Eigen::MatrixXd& V,
+    ConstRef<Eigen::MatrixXd> V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     const std::vector<FaceVertexCandidate>& fv_candidates,
@@ -91,7 +91,7 @@ void save_obj(
 template <>
 void save_obj(
     std::ostream& out,
-    const Eigen::MatrixXd& V,
+    ConstRef<Eigen::MatrixXd> V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     const std::vector<EdgeFaceCandidate>& ef_candidates,
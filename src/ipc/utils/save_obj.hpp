@@ -1,5 +1,7 @@
 #pragma once
 
+#include <ipc/utils/eigen_ext.hpp>
+
 #include <Eigen/Core>
 
 #include <vector>
@@ -11,7 +13,7 @@ namespace ipc {
 template <typename Candidate>
 void save_obj(
     std::ostream& out,
-    const Eigen::MatrixXd& V,
+    ConstRef<Eigen::MatrixXd> V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     const std::vector<Candidate>& candidates,
@@ -20,7 +22,7 @@ void save_obj(
 template <typename Candidate>
 bool save_obj(
     const std::string& filename,
-    const Eigen::MatrixXd& V,
+    ConstRef<Eigen::MatrixXd> V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     const std::vector<Candidate>& candidates)
@@ -0,0 +1,169 @@
+#include "sparsity_pattern.hpp"
+
+#include <ipc/utils/column_starts.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_scan.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <functional>
+
+namespace ipc {
+
+namespace {
+    int num_stencil_vertices(const std::array<long, 4>& stencil)
+    {
+        return std::count_if(
+            stencil.begin(), stencil.end(), [](long id) { return id >= 0; });
+    }
+} // namespace
+
+bool SparsityPattern::matches(
+    const std::vector<std::array<long, 4>>& _stencils,
+    const int _dim,
+    const Eigen::Index _ndof) const
+{
+    return dim == _dim && ndof == _ndof && stencils == _stencils;
+}
+
+void SparsityPattern::build(
+    std::vector<std::array<long, 4>> _stencils,
+    const int _dim,
+    const Eigen::Index _ndof)
+{
+    stencils = std::move(_stencils);
+    dim = _dim;
+    ndof = _ndof;
+
+    local_offsets.resize(stencils.size() + 1);
+    local_offsets[0] = 0;
+    for (size_t i = 0; i < stencils.size(); i++) {
+        const size_t n = dim * num_stencil_vertices(stencils[i]);
+        local_offsets[i + 1] = local_offsets[i] + n * n;
+    }
+
+    // Global (row, col) of every local entry.
+    struct Entry {
+        int row, col;
+        size_t local_index;
+    };
+    std::vector<Entry> entries(num_local_entries());
+    tbb::parallel_for(size_t(0), stencils.size(), [&](size_t i) {
+        const std::array<long, 4>& ids = stencils[i];
+        const int n = dim * num_stencil_vertices(ids);
+        for (int c = 0; c < n; c++) {
+            for (int r = 0; r < n; r++) {
+                const size_t k = local_offsets[i] + c * n + r;
+                entries[k] = { int(dim * ids[r / dim] + r % dim),
+                               int(dim * ids[c / dim] + c % dim), k };
+            }
+        }
+    });
+
+    // Sort in column-major order to match the storage order of the matrix.
+    tbb::parallel_sort(
+        entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+            return a.col < b.col || (a.col == b.col && a.row < b.row);
+        });
+
+    const size_t n = entries.size();
+    const auto is_first = [&](const size_t i) {
+        return i == 0 || entries[i].col != entries[i - 1].col
+            || entries[i].row != entries[i - 1].row;
+    };
+
+    // Index of the nonzero each entry contributes to.
+    std::vector<int> nonzero(n);
+    tbb::parallel_scan(
+        tbb::blocked_range<size_t>(size_t(0), n), 0,
+        [&](const tbb::blocked_range<size_t>& r, int sum,
+            const bool is_final_scan) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                sum += is_first(i);
+                if (is_final_scan) {
+                    nonzero[i] = sum - 1;
+                }
+            }
+            return sum;
+        },
+        std::plus<int>());
+    const int nnz = n == 0 ? 0 : (nonzero.back() + 1);
+
+    outer.resize(ndof + 1);
+    inner.resize(nnz);
+    contribution_offsets.resize(nnz + 1);
+    contributions.resize(n);
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), n),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                contributions[i] = entries[i].local_index;
+                if (!is_first(i)) {
+                    continue;
+                }
+
+                inner[nonzero[i]] = entries[i].row;
+                contribution_offsets[nonzero[i]] = i;
+            }
+        });
+    contribution_offsets[nnz] = n;
+
+    fill_column_starts(
+        nnz,
+        [&](const size_t k) { return entries[contribution_offsets[k]].col; },
+        ndof, outer.data());
+}
+
+void SparsityPattern::assemble(
+    const std::vector<double>& local_values,
+    Eigen::SparseMatrix<double>& matrix) const
+{
+    assert(local_values.size() == num_local_entries());
+
+    if (!has_pattern(matrix)) {
+        matrix = Eigen::SparseMatrix<double>(ndof, ndof);
+        matrix.resizeNonZeros(inner.size());
+        std::copy(outer.begin(), outer.end(), matrix.outerIndexPtr());
+        std::copy(inner.begin(), inner.end(), matrix.innerIndexPtr());
+    }
+
+    double* values = matrix.valuePtr();
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), inner.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                double value = 0;
+                for (size_t j = contribution_offsets[i];
+                     j < contribution_offsets[i + 1]; j++) {
+                    value += local_values[contributions[j]];
+                }
+                values[i] = value;
+            }
+        });
+}
+
+bool SparsityPattern::has_pattern(
+    const Eigen::SparseMatrix<double>& matrix) const
+{
+    return matrix.rows() == ndof && matrix.cols() == ndof
+        && matrix.isCompressed() && size_t(matrix.nonZeros()) == inner.size()
+        && std::equal(outer.begin(), outer.end(), matrix.outerIndexPtr())
+        && std::equal(inner.begin(), inner.end(), matrix.innerIndexPtr());
+}
+
+void SparsityPattern::clear()
+{
+    stencils.clear();
+    dim = 0;
+    ndof = 0;
+    local_offsets = { 0 };
+    outer.clear();
+    inner.clear();
+    contribution_offsets.clear();
+    contributions.clear();
+}
+
+} // namespace ipc
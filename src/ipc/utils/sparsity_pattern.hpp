@@ -0,0 +1,85 @@
+#pragma once
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+#include <array>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Cached sparsity pattern of a matrix assembled from local stencil matrices.
+///
+/// Stores the compressed (column-major) pattern of the global matrix and, for
+/// each of its nonzeros, the local entries that are summed into it. As long as
+/// the stencils do not change, the global values can be refilled in place
+/// without rebuilding the pattern.
+class SparsityPattern {
+public:
+    SparsityPattern() = default;
+
+    /// @brief Check if the pattern was built for the given stencils.
+    /// @param stencils Vertex ids of each stencil (unused ids are -1).
+    /// @param dim Dimension of each vertex.
+    /// @param ndof Number of rows and columns of the global matrix.
+    /// @return True if the pattern can be reused for the stencils.
+    bool matches(
+        const std::vector<std::array<long, 4>>& stencils,
+        const int dim,
+        const Eigen::Index ndof) const;
+
+    /// @brief Build the pattern for the given stencils.
+    /// @param stencils Vertex ids of each stencil (unused ids are -1).
+    /// @param dim Dimension of each vertex.
+    /// @param ndof Number of rows and columns of the global matrix.
+    void build(
+        std::vector<std::array<long, 4>> stencils,
+        const int dim,
+        const Eigen::Index ndof);
+
+    /// @brief Sum the local stencil matrices into the global matrix.
+    /// @note If the matrix already has this pattern, only its values are overwritten. Otherwise, it is reinitialized with this pattern.
+    /// @param local_values Entries of each local matrix (column-major), stacked in stencil order starting at local_offset(i).
+    /// @param[in,out] matrix Global matrix.
+    void assemble(
+        const std::vector<double>& local_values,
+        Eigen::SparseMatrix<double>& matrix) const;
+
+    /// @brief Check if a matrix has this sparsity pattern.
+    bool has_pattern(const Eigen::SparseMatrix<double>& matrix) const;
+
+    /// @brief Offset of stencil i's local entries in the stacked local values.
+    size_t local_offset(size_t i) const { return local_offsets[i]; }
+
+    /// @brief Total number of local entries over all stencils.
+    size_t num_local_entries() const { return local_offsets.back(); }
+
+    /// @brief Number of nonzeros in the global matrix.
+    size_t num_nonzeros() const { return inner.size(); }
+
+    /// @brief Clear the pattern.
+    void clear();
+
+protected:
+    /// @brief Vertex ids of each stencil the pattern was built for.
+    std::vector<std::array<long, 4>> stencils;
+    /// @brief Dimension of each vertex.
+    int dim = 0;
+    /// @brief Number of rows and columns of the global matrix.
+    Eigen::Index ndof = 0;
+
+    /// @brief Offset of each stencil's local entries (size is #stencils + 1).
+    std::vector<size_t> local_offsets = { 0 };
+
+    /// @brief Compressed outer indices of the global matrix.
+    std::vector<int> outer;
+    /// @brief Compressed inner indices of the global matrix.
+    std::vector<int> inner;
+
+    /// @brief Start of each nonzero's contributions (size is nnz + 1).
+    std::vector<size_t> contribution_offsets;
+    /// @brief Local entries summed into each nonzero, grouped by nonzero.
+    std::vector<size_t> contributions;
+};
+
+} // namespace ipc
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <ipc/utils/eigen_ext.hpp>
+
 #include <Eigen/Core>
 
 namespace ipc {
@@ -7,7 +9,7 @@ namespace ipc {
 /// @brief Compute the diagonal length of the world bounding box.
 /// @param vertices Vertex positions
 /// @return The diagonal length of the world bounding box.
-inline double world_bbox_diagonal_length(const Eigen::MatrixXd& vertices)
+inline double world_bbox_diagonal_length(ConstRef<Eigen::MatrixXd> vertices)
 {
     return (vertices.colwise().maxCoeff() - vertices.colwise().minCoeff())
         .norm();
@@ -1,5 +1,7 @@
 #include <tests/config.hpp>
 #include <tests/utils.hpp>
+#include <tests/broad_phase/brute_force_comparison.hpp>
+#include <tests/broad_phase/reference_hash_grid.hpp>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
@@ -9,6 +11,12 @@
 #include <ipc/broad_phase/hash_grid.hpp>
 #include <ipc/broad_phase/spatial_hash.hpp>
 #include <ipc/broad_phase/brute_force.hpp>
+#include <ipc/broad_phase/bvh.hpp>
+
+#include <SimpleBVH/BVH.hpp>
+
+#include <tbb/global_control.h>
+#include <tbb/info.h>
 
 using namespace ipc;
 
@@ -138,3 +146,285 @@ TEST_CASE(
         };
     }
 }
+
+TEST_CASE(
+    "Benchmark BVH refit over a trajectory", "[!benchmark][broad_phase][bvh]")
+{
+    Eigen::MatrixXd V_rest;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("bunny.obj", V_rest, E, F));
+
+    CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V_rest, E, F);
+    V_rest = mesh.vertices(V_rest);
+
+    const double diag =
+        (V_rest.colwise().maxCoeff() - V_rest.colwise().minCoeff()).norm();
+    const double inflation_radius = 1e-3 * diag;
+
+    // Twist the bunny about the y-axis over a sequence of frames.
+    constexpr int NUM_FRAMES = 20;
+    std::vector<Eigen::MatrixXd> frames(NUM_FRAMES + 1, V_rest);
+    for (int f = 0; f <= NUM_FRAMES; f++) {
+        for (int i = 0; i < V_rest.rows(); i++) {
+            const double theta = 0.5 * f / NUM_FRAMES * V_rest(i, 1) / diag;
+            const double c = std::cos(theta), s = std::sin(theta);
+            frames[f](i, 0) = c * V_rest(i, 0) - s * V_rest(i, 2);
+            frames[f](i, 2) = s * V_rest(i, 0) + c * V_rest(i, 2);
+        }
+    }
+
+    const auto run = [&](BVH& bvh, const bool refit) {
+        size_t num_candidates = 0;
+        for (int f = 0; f < NUM_FRAMES; f++) {
+            if (refit) {
+                bvh.update(
+                    frames[f], frames[f + 1], mesh.edges(), mesh.faces(),
+                    inflation_radius);
+            } else {
+                bvh.build(
+                    frames[f], frames[f + 1], mesh.edges(), mesh.faces(),
+                    inflation_radius);
+            }
+            Candidates candidates;
+            bvh.detect_collision_candidates(3, candidates);
+            num_candidates += candidates.size();
+        }
+        return num_candidates;
+    };
+
+    {
+        BVH rebuilt, refitted;
+        CHECK(run(rebuilt, false) == run(refitted, true));
+    }
+
+    BENCHMARK("BVH rebuild + query")
+    {
+        BVH bvh;
+        return run(bvh, false);
+    };
+
+    BENCHMARK("BVH refit + query")
+    {
+        BVH bvh;
+        return run(bvh, true);
+    };
+}
+
+TEST_CASE(
+    "Benchmark SpatialHash on a cloth grid",
+    "[!benchmark][broad_phase][spatial_hash]")
+{
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    tests::cloth_grid(150, V0, E, F);
+
+    srand(0);
+    Eigen::MatrixXd V1 = V0;
+    V1.col(1) += 1e-3 * Eigen::VectorXd::Random(V1.rows());
+
+    SpatialHash sh;
+    sh.build(V0, V1, E, F, /*inflation_radius=*/0, /*voxel_size=*/0.01);
+
+    // Measure the per-query cost without the parallel overhead.
+    tbb::global_control thread_limiter(
+        tbb::global_control::max_allowed_parallelism, 1);
+
+    BENCHMARK("SpatialHash detect candidates (150x150 cloth)")
+    {
+        Candidates candidates;
+        sh.detect_collision_candidates(V0.cols(), candidates);
+        return candidates.size();
+    };
+}
+
+namespace {
+/// @brief Expose the boxes and trees of the BVH broad phase.
+class BVHInternals : public BVH {
+public:
+    using BVH::Tree;
+    using BVH::edge_boxes;
+    using BVH::face_boxes;
+    using BVH::vertex_boxes;
+};
+} // namespace
+
+TEST_CASE(
+    "Benchmark BVH against SimpleBVH", "[!benchmark][broad_phase][bvh]")
+{
+    Eigen::MatrixXd V0, V1;
+    Eigen::MatrixXi E, F;
+
+    SECTION("Bunny")
+    {
+        REQUIRE(tests::load_mesh("bunny.obj", V0, E, F));
+        V1 = V0;
+        V1.col(0) *= 0.1;
+    }
+    SECTION("Cloth-Ball")
+    {
+        REQUIRE(tests::load_mesh("cloth_ball92.ply", V0, E, F));
+        REQUIRE(tests::load_mesh("cloth_ball93.ply", V1, E, F));
+    }
+
+    CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V0, E, F);
+    V0 = mesh.vertices(V0);
+    V1 = mesh.vertices(V1);
+
+    BVHInternals broad_phase;
+    broad_phase.build(V0, V1, mesh.edges(), mesh.faces(), 1e-2);
+    const std::vector<AABB>& vertex_boxes = broad_phase.vertex_boxes;
+    const std::vector<AABB>& edge_boxes = broad_phase.edge_boxes;
+    const std::vector<AABB>& face_boxes = broad_phase.face_boxes;
+
+    const auto to_corners = [](const std::vector<AABB>& boxes) {
+        std::vector<std::array<Eigen::Vector3d, 2>> corners(boxes.size());
+        for (size_t i = 0; i < boxes.size(); i++) {
+            corners[i] = { { to_3D(boxes[i].min), to_3D(boxes[i].max) } };
+        }
+        return corners;
+    };
+    const auto vertex_corners = to_corners(vertex_boxes);
+    const auto edge_corners = to_corners(edge_boxes);
+
+    // SimpleBVH::BVH::init() takes a copy of the boxes as corner pairs.
+    const auto build_simple_bvh = [&](const std::vector<AABB>& boxes,
+                                      SimpleBVH::BVH& bvh) {
+        bvh.init(to_corners(boxes));
+    };
+
+    // Count the edge-edge and face-vertex box overlaps.
+    const auto query_simple_bvh = [&](const SimpleBVH::BVH& edge_tree,
+                                      const SimpleBVH::BVH& face_tree) {
+        size_t num_overlaps = 0;
+        std::vector<unsigned int> ids;
+        for (const auto& [min, max] : edge_corners) {
+            edge_tree.intersect_box(min, max, ids);
+            num_overlaps += ids.size();
+        }
+        for (const auto& [min, max] : vertex_corners) {
+            face_tree.intersect_box(min, max, ids);
+            num_overlaps += ids.size();
+        }
+        return num_overlaps;
+    };
+    const auto query_bvh = [&](const BVHInternals::Tree& edge_tree,
+                               const BVHInternals::Tree& face_tree) {
+        size_t num_overlaps = 0;
+        std::vector<unsigned int> ids;
+        for (const auto& [min, max] : edge_corners) {
+            edge_tree.intersect_box(min.array(), max.array(), ids);
+            num_overlaps += ids.size();
+        }
+        for (const auto& [min, max] : vertex_corners) {
+            face_tree.intersect_box(min.array(), max.array(), ids);
+            num_overlaps += ids.size();
+        }
+        return num_overlaps;
+    };
+
+    SimpleBVH::BVH simple_vertex_bvh, simple_edge_bvh, simple_face_bvh;
+    build_simple_bvh(vertex_boxes, simple_vertex_bvh);
+    build_simple_bvh(edge_boxes, simple_edge_bvh);
+    build_simple_bvh(face_boxes, simple_face_bvh);
+
+    BVHInternals::Tree vertex_bvh, edge_bvh, face_bvh;
+    vertex_bvh.build(vertex_boxes);
+    edge_bvh.build(edge_boxes);
+    face_bvh.build(face_boxes);
+
+    CHECK(
+        query_simple_bvh(simple_edge_bvh, simple_face_bvh)
+        == query_bvh(edge_bvh, face_bvh));
+
+    BENCHMARK("SimpleBVH build")
+    {
+        SimpleBVH::BVH trees[3];
+        build_simple_bvh(vertex_boxes, trees[0]);
+        build_simple_bvh(edge_boxes, trees[1]);
+        build_simple_bvh(face_boxes, trees[2]);
+    };
+
+    BENCHMARK("BVH build")
+    {
+        BVHInternals::Tree trees[3];
+        trees[0].build(vertex_boxes);
+        trees[1].build(edge_boxes);
+        trees[2].build(face_boxes);
+    };
+
+    BENCHMARK("SimpleBVH query")
+    {
+        return query_simple_bvh(simple_edge_bvh, simple_face_bvh);
+    };
+
+    BENCHMARK("BVH query") { return query_bvh(edge_bvh, face_bvh); };
+}
+
+TEST_CASE(
+    "Benchmark HashGrid candidate detection",
+    "[!benchmark][broad_phase][hash_grid]")
+{
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("bunny.obj", V0, E, F));
+
+    CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V0, E, F);
+    V0 = mesh.vertices(V0);
+
+    srand(0);
+    Eigen::MatrixXd V1 =
+        V0 + 1e-2 * Eigen::MatrixXd::Random(V0.rows(), V0.cols());
+
+    std::string testcase_name = "Uniform";
+    SECTION("Crowded")
+    {
+        // Collapse a third of the vertices into a tiny ball, so a few cells
+        // hold most of the items.
+        for (int i = 0; i < V0.rows(); i += 3) {
+            V0.row(i) = V0.row(0) + 1e-4 * Eigen::RowVector3d::Random();
+            V1.row(i) = V0.row(i);
+        }
+        testcase_name = "Crowded";
+    }
+    SECTION("Uniform") { }
+
+    HashGrid hash_grid;
+    hash_grid.build(V0, V1, mesh.edges(), mesh.faces(), 1e-3);
+
+    // The previous blocked_range2d enumeration over the same grid
+    tests::ReferenceHashGrid reference;
+    reference.build(V0, V1, mesh.edges(), mesh.faces(), 1e-3);
+
+    check_same_candidates(hash_grid, reference);
+
+    // Powers of two up to the number of available threads
+    std::vector<int> thread_counts;
+    const int max_threads = tbb::info::default_concurrency();
+    for (int n = 1; n < max_threads; n *= 2) {
+        thread_counts.push_back(n);
+    }
+    thread_counts.push_back(max_threads);
+
+    for (const int num_threads : thread_counts) {
+        tbb::global_control thread_limiter(
+            tbb::global_control::max_allowed_parallelism, num_threads);
+
+        BENCHMARK(fmt::format(
+            "HashGrid detect candidates ({}, {} threads)", testcase_name,
+            num_threads))
+        {
+            Candidates candidates;
+            hash_grid.detect_collision_candidates(V0.cols(), candidates);
+            return candidates.size();
+        };
+
+        BENCHMARK(fmt::format(
+            "Reference HashGrid detect candidates ({}, {} threads)",
+            testcase_name, num_threads))
+        {
+            Candidates candidates;
+            reference.detect_collision_candidates(V0.cols(), candidates);
+            return candidates.size();
+        };
+    }
+}
@@ -42,6 +42,45 @@ void brute_force_comparison(
         mesh, V0, V1, candidates.fv_candidates, bf_candidates.fv_candidates);
 }
 
+namespace {
+template <typename Candidate>
+void check_same_candidates(
+    const ipc::BroadPhase& broad_phase,
+    const ipc::BroadPhase& reference,
+    void (ipc::BroadPhase::*detect)(std::vector<Candidate>&) const)
+{
+    std::vector<Candidate> candidates, expected;
+    (broad_phase.*detect)(candidates);
+    (reference.*detect)(expected);
+    tbb::parallel_sort(candidates.begin(), candidates.end());
+    tbb::parallel_sort(expected.begin(), expected.end());
+    CAPTURE(candidates.size(), expected.size());
+    CHECK(candidates == expected);
+}
+} // namespace
+
+void check_same_candidates(
+    const ipc::BroadPhase& broad_phase, const ipc::BroadPhase& reference)
+{
+    using namespace ipc;
+
+    CAPTURE("VV");
+    check_same_candidates(
+        broad_phase, reference, &BroadPhase::detect_vertex_vertex_candidates);
+    CAPTURE("EV");
+    check_same_candidates(
+        broad_phase, reference, &BroadPhase::detect_edge_vertex_candidates);
+    CAPTURE("EE");
+    check_same_candidates(
+        broad_phase, reference, &BroadPhase::detect_edge_edge_candidates);
+    CAPTURE("FV");
+    check_same_candidates(
+        broad_phase, reference, &BroadPhase::detect_face_vertex_candidates);
+    CAPTURE("EF");
+    check_same_candidates(
+        broad_phase, reference, &BroadPhase::detect_edge_face_candidates);
+}
+
 void save_candidates(
     const std::string& filename, const ipc::Candidates& candidates)
 {
@@ -2,6 +2,7 @@
 
 #include <ipc/collision_mesh.hpp>
 #include <ipc/candidates/candidates.hpp>
+#include <ipc/broad_phase/broad_phase.hpp>
 
 void brute_force_comparison(
     const ipc::CollisionMesh& mesh,
@@ -18,3 +19,7 @@ void brute_force_comparison(
     const Eigen::MatrixXd& V1,
     std::vector<Candidate>& candidates,
     std::vector<Candidate>& bf_candidates);
+
+/// @brief Check that two built broad phases detect the same candidates of every type.
+void check_same_candidates(
+    const ipc::BroadPhase& broad_phase, const ipc::BroadPhase& reference);
@@ -0,0 +1,192 @@
+#include "reference_hash_grid.hpp"
+
+#include <ipc/utils/merge_thread_local.hpp>
+
+#include <tbb/blocked_range2d.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+
+namespace ipc::tests {
+
+namespace {
+    template <typename Candidate>
+    void sort_and_unique(std::vector<Candidate>& candidates)
+    {
+        tbb::parallel_sort(candidates.begin(), candidates.end());
+        candidates.erase(
+            std::unique(candidates.begin(), candidates.end()),
+            candidates.end());
+    }
+
+    template <typename Candidate>
+    void enumerate_candidates(
+        const std::vector<HashItem>& items0,
+        const std::vector<HashItem>& items1,
+        const std::vector<AABB>& boxes0,
+        const std::vector<AABB>& boxes1,
+        const std::function<bool(size_t, size_t)>& can_collide,
+        std::vector<Candidate>& candidates)
+    {
+        if (items0.empty() || items1.empty()) {
+            return;
+        }
+
+        // 1. Soft merge of items (assuming items are sorted)
+        const long num_items = items0.size() + items1.size();
+        std::vector<long> merged_item_indices;
+        merged_item_indices.reserve(num_items);
+        {
+            long i = 0, j = 0;
+            while (i < items0.size() && j < items1.size()) {
+                if (items0[i] < items1[j]) {
+                    merged_item_indices.push_back(-(i++) - 1);
+                } else {
+                    merged_item_indices.push_back(j++);
+                }
+            }
+            while (i < items0.size()) {
+                merged_item_indices.push_back(-(i++) - 1);
+            }
+            while (j < items1.size()) {
+                merged_item_indices.push_back(j++);
+            }
+        }
+
+        const auto get_item = [&](long i) -> const HashItem& {
+            return i < 0 ? items0[-(i + 1)] : items1[i];
+        };
+
+        // 2. Enumerate hash collisions
+        tbb::enumerable_thread_specific<std::vector<Candidate>> storage;
+        tbb::parallel_for(
+            tbb::blocked_range2d<long>(0l, num_items - 1, 0l, num_items),
+            [&](const tbb::blocked_range2d<long>& r) {
+                auto& local_candidates = storage.local();
+
+                // i < j
+                const long i_end = std::min(r.rows().end(), r.cols().end());
+                for (long i = r.rows().begin(); i < i_end; i++) {
+                    const long idx0 = merged_item_indices[i];
+                    const HashItem& item0 = get_item(idx0);
+
+                    const long j_begin = std::max(i + 1, r.cols().begin());
+                    for (long j = j_begin; j < r.cols().end(); j++) {
+                        const long idx1 = merged_item_indices[j];
+                        const HashItem& item1 = get_item(idx1);
+
+                        if (item0.key != item1.key) {
+                            break;
+                        }
+
+                        long id0 = item0.id, id1 = item1.id;
+                        if (idx0 >= 0 && idx1 < 0) {
+                            std::swap(id0, id1);
+                        } else if (idx0 >= 0 || idx1 < 0) {
+                            continue;
+                        }
+
+                        if (can_collide(id0, id1)
+                            && boxes0[id0].intersects(boxes1[id1])) {
+                            local_candidates.emplace_back(id0, id1);
+                        }
+                    }
+                }
+            });
+
+        merge_thread_local_vectors(storage, candidates);
+        sort_and_unique(candidates);
+    }
+
+    template <typename Candidate>
+    void enumerate_candidates(
+        const std::vector<HashItem>& items,
+        const std::vector<AABB>& boxes,
+        const std::function<bool(size_t, size_t)>& can_collide,
+        std::vector<Candidate>& candidates)
+    {
+        tbb::enumerable_thread_specific<std::vector<Candidate>> storage;
+        tbb::parallel_for(
+            tbb::blocked_range2d<long>(
+                0l, long(items.size()) - 1, 0l, long(items.size())),
+            [&](const tbb::blocked_range2d<long>& r) {
+                auto& local_candidates = storage.local();
+
+                // i < j
+                const long i_end = std::min(r.rows().end(), r.cols().end());
+                for (long i = r.rows().begin(); i < i_end; i++) {
+                    const HashItem& item0 = items[i];
+
+                    const long j_begin = std::max(i + 1, r.cols().begin());
+                    for (long j = j_begin; j < r.cols().end(); j++) {
+                        const HashItem& item1 = items[j];
+
+                        if (item0.key != item1.key) {
+                            break;
+                        }
+
+                        if (can_collide(item0.id, item1.id)
+                            && boxes[item0.id].intersects(boxes[item1.id])) {
+                            local_candidates.emplace_back(item0.id, item1.id);
+                        }
+                    }
+                }
+            });
+
+        merge_thread_local_vectors(storage, candidates);
+        sort_and_unique(candidates);
+    }
+} // namespace
+
+void ReferenceHashGrid::detect_vertex_vertex_candidates(
+    std::vector<VertexVertexCandidate>& candidates) const
+{
+    if (vertex_items.empty()) {
+        return;
+    }
+    enumerate_candidates(
+        vertex_items, vertex_boxes, can_vertices_collide, candidates);
+}
+
+void ReferenceHashGrid::detect_edge_vertex_candidates(
+    std::vector<EdgeVertexCandidate>& candidates) const
+{
+    enumerate_candidates(
+        edge_items, vertex_items, edge_boxes, vertex_boxes,
+        [&](size_t ei, size_t vi) { return can_edge_vertex_collide(ei, vi); },
+        candidates);
+}
+
+void ReferenceHashGrid::detect_edge_edge_candidates(
+    std::vector<EdgeEdgeCandidate>& candidates) const
+{
+    if (edge_items.empty()) {
+        return;
+    }
+    enumerate_candidates(
+        edge_items, edge_boxes,
+        [&](size_t eai, size_t ebi) { return can_edges_collide(eai, ebi); },
+        candidates);
+}
+
+void ReferenceHashGrid::detect_face_vertex_candidates(
+    std::vector<FaceVertexCandidate>& candidates) const
+{
+    enumerate_candidates(
+        face_items, vertex_items, face_boxes, vertex_boxes,
+        [&](size_t fi, size_t vi) { return can_face_vertex_collide(fi, vi); },
+        candidates);
+}
+
+void ReferenceHashGrid::detect_edge_face_candidates(
+    std::vector<EdgeFaceCandidate>& candidates) const
+{
+    enumerate_candidates(
+        edge_items, face_items, edge_boxes, face_boxes,
+        [&](size_t ei, size_t fi) { return can_edge_face_collide(ei, fi); },
+        candidates);
+}
+
+} // namespace ipc::tests
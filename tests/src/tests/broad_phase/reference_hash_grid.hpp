@@ -0,0 +1,31 @@
+#pragma once
+
+#include <ipc/broad_phase/hash_grid.hpp>
+
+namespace ipc::tests {
+
+/// @brief HashGrid with the previous pair enumeration, kept as a test-only reference.
+///
+/// Pairs are enumerated over an n×n index space tiled with
+/// tbb::blocked_range2d, stopping each row at the first item with a
+/// different key (as HashGrid did before it was split into runs of equal
+/// keys). The grid itself is built and updated by HashGrid.
+class ReferenceHashGrid : public HashGrid {
+public:
+    void detect_vertex_vertex_candidates(
+        std::vector<VertexVertexCandidate>& candidates) const override;
+
+    void detect_edge_vertex_candidates(
+        std::vector<EdgeVertexCandidate>& candidates) const override;
+
+    void detect_edge_edge_candidates(
+        std::vector<EdgeEdgeCandidate>& candidates) const override;
+
+    void detect_face_vertex_candidates(
+        std::vector<FaceVertexCandidate>& candidates) const override;
+
+    void detect_edge_face_candidates(
+        std::vector<EdgeFaceCandidate>& candidates) const override;
+};
+
+} // namespace ipc::tests
@@ -5,6 +5,10 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
+#include <ipc/broad_phase/brute_force.hpp>
+#include <ipc/broad_phase/bvh.hpp>
+#include <ipc/broad_phase/hash_grid.hpp>
+
 #include <igl/readCSV.h>
 #include <igl/readDMAT.h>
 
@@ -214,3 +218,154 @@ TEST_CASE("Cloth-Ball", "[ccd][broad_phase][cloth-ball][.]")
         mesh, V0, V1, method, true,
         (tests::DATA_DIR / "cloth_ball_bf_ccd_candidated.json").string());
 }
+
+TEST_CASE("Update persistent broad phase", "[broad_phase][update]")
+{
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("cube.obj", V0, E, F));
+
+    CollisionMesh mesh(V0, E, F);
+
+    BroadPhaseMethod method = GENERATE_BROAD_PHASE_METHODS();
+    CAPTURE(method);
+
+    const double inflation_radius = 1e-2;
+    std::shared_ptr<BroadPhase> broad_phase =
+        BroadPhase::make_broad_phase(method);
+
+    // Small steps are updated in place; the last large step forces a rebuild.
+    const double scale = GENERATE(1e-3, 1e-1);
+    for (int i = 0; i < 3; i++) {
+        Eigen::MatrixXd U = Eigen::MatrixXd::Random(V0.rows(), V0.cols());
+        const Eigen::MatrixXd V1 = V0 + scale * (i < 2 ? 1 : 100) * U;
+
+        Candidates candidates;
+        candidates.build(mesh, V0, V1, inflation_radius, broad_phase);
+
+        if (method != BroadPhaseMethod::BRUTE_FORCE) {
+            brute_force_comparison(mesh, V0, V1, candidates, inflation_radius);
+        }
+
+        V0 = V1;
+    }
+}
+
+TEST_CASE("BVH partial rebuild over a trajectory", "[broad_phase][bvh][update]")
+{
+    Eigen::MatrixXd V_rest;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("bunny.obj", V_rest, E, F));
+
+    CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V_rest, E, F);
+    V_rest = mesh.vertices(V_rest);
+
+    const double diag =
+        (V_rest.colwise().maxCoeff() - V_rest.colwise().minCoeff()).norm();
+    const double inflation_radius = 1e-3 * diag;
+
+    // Twist the bunny about the y-axis far enough that refitting degrades
+    // some subtrees of the persistent BVH.
+    constexpr int NUM_FRAMES = 5;
+    std::vector<Eigen::MatrixXd> frames(NUM_FRAMES + 1, V_rest);
+    for (int f = 0; f <= NUM_FRAMES; f++) {
+        for (int i = 0; i < V_rest.rows(); i++) {
+            const double theta = 8.0 * f / NUM_FRAMES * V_rest(i, 1) / diag;
+            const double c = std::cos(theta), s = std::sin(theta);
+            frames[f](i, 0) = c * V_rest(i, 0) - s * V_rest(i, 2);
+            frames[f](i, 2) = s * V_rest(i, 0) + c * V_rest(i, 2);
+        }
+    }
+
+    BVH bvh;
+    size_t num_rebuilt = 0;
+    for (int f = 0; f < NUM_FRAMES; f++) {
+        CAPTURE(f);
+        const Eigen::MatrixXd &V0 = frames[f], &V1 = frames[f + 1];
+
+        bvh.update(V0, V1, mesh.edges(), mesh.faces(), inflation_radius);
+        num_rebuilt += bvh.last_update_num_rebuilt();
+
+        BVH rebuilt;
+        rebuilt.build(V0, V1, mesh.edges(), mesh.faces(), inflation_radius);
+        check_same_candidates(bvh, rebuilt);
+
+        BruteForce brute_force;
+        brute_force.build(V0, V1, mesh.edges(), mesh.faces(), inflation_radius);
+        check_same_candidates(bvh, brute_force);
+    }
+    CHECK(num_rebuilt > 0);
+}
+
+TEST_CASE("Clear persistent broad phase", "[broad_phase][update]")
+{
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("cube.obj", V0, E, F));
+
+    CollisionMesh mesh(V0, E, F);
+
+    BroadPhaseMethod method = GENERATE_BROAD_PHASE_METHODS();
+    CAPTURE(method);
+
+    const double inflation_radius = 1e-2;
+    std::shared_ptr<BroadPhase> broad_phase =
+        BroadPhase::make_broad_phase(method);
+
+    const Eigen::MatrixXd V1 =
+        V0 + 1e-3 * Eigen::MatrixXd::Random(V0.rows(), V0.cols());
+
+    Candidates candidates;
+    candidates.build(mesh, V0, V1, inflation_radius, broad_phase);
+
+    // A cleared broad phase must be rebuilt by the next update.
+    broad_phase->clear();
+    candidates.build(mesh, V0, V1, inflation_radius, broad_phase);
+
+    CHECK(!candidates.empty());
+    if (method != BroadPhaseMethod::BRUTE_FORCE) {
+        brute_force_comparison(mesh, V0, V1, candidates, inflation_radius);
+    }
+}
+
+TEST_CASE(
+    "Persistent broad phase keeps its codim. broad phase",
+    "[broad_phase][update]")
+{
+    // Free edges and points, so every stage of Candidates::build is codim.
+    Eigen::MatrixXd V0 = Eigen::MatrixXd::Random(20, 3);
+    Eigen::MatrixXi E(5, 2), F(0, 3);
+    E << 0, 1, 2, 3, 4, 5, 6, 7, 8, 9;
+
+    CollisionMesh mesh(V0, E, F);
+    REQUIRE(mesh.num_codim_vertices() == 10);
+    REQUIRE(mesh.num_codim_edges() == 5);
+
+    auto hash_grid = std::make_shared<HashGrid>();
+    hash_grid->set_use_sparse_domain(true);
+
+    const double inflation_radius = 1e-2;
+    const BroadPhase* codim_broad_phase = nullptr;
+    for (int i = 0; i < 3; i++) {
+        const Eigen::MatrixXd V1 =
+            V0 + 0.5 * Eigen::MatrixXd::Random(V0.rows(), V0.cols());
+
+        Candidates candidates;
+        candidates.build(mesh, V0, V1, inflation_radius, hash_grid);
+
+        brute_force_comparison(mesh, V0, V1, candidates, inflation_radius);
+
+        // The codim. broad phase is created once and reused.
+        if (codim_broad_phase == nullptr) {
+            codim_broad_phase = &hash_grid->codim_broad_phase();
+        }
+        CHECK(&hash_grid->codim_broad_phase() == codim_broad_phase);
+
+        V0 = V1;
+    }
+
+    const auto* codim_hash_grid =
+        dynamic_cast<const HashGrid*>(codim_broad_phase);
+    REQUIRE(codim_hash_grid != nullptr);
+    CHECK(codim_hash_grid->use_sparse_domain());
+}
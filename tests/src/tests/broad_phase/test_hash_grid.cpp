@@ -0,0 +1,114 @@
+#include <tests/broad_phase/brute_force_comparison.hpp>
+#include <tests/broad_phase/reference_hash_grid.hpp>
+#include <tests/utils.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <ipc/broad_phase/hash_grid.hpp>
+
+using namespace ipc;
+
+namespace {
+class TestHashGrid : public HashGrid {
+public:
+    using HashGrid::hash;
+    using HashGrid::resize;
+};
+} // namespace
+
+TEST_CASE("HashGrid Morton keys", "[broad_phase][hash_grid]")
+{
+    TestHashGrid grid;
+    grid.resize(ArrayMax3d::Zero(3), ArrayMax3d::Constant(3, 4), 1);
+
+    // Z-order of a 2×2×2 block
+    CHECK(grid.hash(0, 0, 0) == 0);
+    CHECK(grid.hash(1, 0, 0) == 1);
+    CHECK(grid.hash(0, 1, 0) == 2);
+    CHECK(grid.hash(0, 0, 1) == 4);
+    CHECK(grid.hash(1, 1, 1) == 7);
+
+    // Beyond the range of 32-bit row-major keys
+    const int64_t max_cell = (int64_t(1) << 21) - 1;
+    grid.resize(ArrayMax3d::Zero(3), ArrayMax3d::Constant(3, max_cell + 1), 1);
+    CHECK(grid.hash(max_cell, max_cell, max_cell) == (uint64_t(1) << 63) - 1);
+
+    grid.resize(ArrayMax3d::Zero(2), ArrayMax3d::Constant(2, 4), 1);
+    CHECK(grid.hash(1, 0, 0) == 1);
+    CHECK(grid.hash(0, 1, 0) == 2);
+    CHECK(grid.hash(3, 3, 0) == 15);
+}
+
+TEST_CASE("HashGrid with widely separated objects", "[broad_phase][hash_grid]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("cube.obj", V, E, F));
+
+    // Two copies of the cube far apart
+    const long nV = V.rows(), nE = E.rows(), nF = F.rows();
+    V.conservativeResize(2 * nV, V.cols());
+    V.bottomRows(nV) = V.topRows(nV).rowwise() + Eigen::RowVector3d(1e7, 0, 0);
+    E.conservativeResize(2 * nE, E.cols());
+    E.bottomRows(nE) = E.topRows(nE).array() + nV;
+    F.conservativeResize(2 * nF, F.cols());
+    F.bottomRows(nF) = F.topRows(nF).array() + nV;
+
+    CollisionMesh mesh(V, E, F);
+
+    const bool use_sparse_domain = GENERATE(false, true);
+    CAPTURE(use_sparse_domain);
+
+    auto hash_grid = std::make_shared<HashGrid>();
+    hash_grid->set_use_sparse_domain(use_sparse_domain);
+
+    const double inflation_radius = 1e-2;
+    for (int i = 0; i < 3; i++) {
+        // The last step moves the mesh out of the original domain.
+        const Eigen::MatrixXd V1 = V
+            + (i < 2 ? 1e-3 : 10) * Eigen::MatrixXd::Random(V.rows(), V.cols());
+
+        Candidates candidates;
+        candidates.build(mesh, V, V1, inflation_radius, hash_grid);
+
+        brute_force_comparison(mesh, V, V1, candidates, inflation_radius);
+
+        V = V1;
+    }
+}
+
+TEST_CASE(
+    "HashGrid matches the blocked_range2d enumeration",
+    "[broad_phase][hash_grid]")
+{
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("bunny.obj", V0, E, F));
+
+    CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V0, E, F);
+    V0 = mesh.vertices(V0);
+
+    srand(0);
+    Eigen::MatrixXd V1 =
+        V0 + 1e-2 * Eigen::MatrixXd::Random(V0.rows(), V0.cols());
+
+    SECTION("Crowded")
+    {
+        // Collapse some of the vertices into a tiny ball, so a few cells
+        // hold many items.
+        for (int i = 0; i < V0.rows(); i += 30) {
+            V0.row(i) = V0.row(0) + 1e-4 * Eigen::RowVector3d::Random();
+            V1.row(i) = V0.row(i);
+        }
+    }
+    SECTION("Uniform") { }
+
+    HashGrid hash_grid;
+    hash_grid.build(V0, V1, mesh.edges(), mesh.faces(), 1e-3);
+
+    tests::ReferenceHashGrid reference;
+    reference.build(V0, V1, mesh.edges(), mesh.faces(), 1e-3);
+
+    check_same_candidates(hash_grid, reference);
+}
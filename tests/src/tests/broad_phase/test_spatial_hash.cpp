@@ -1,9 +1,12 @@
 #include <tests/config.hpp>
 #include <tests/utils.hpp>
+#include <tests/broad_phase/brute_force_comparison.hpp>
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
 
 #include <ipc/broad_phase/spatial_hash.hpp>
+#include <ipc/broad_phase/bvh.hpp>
 
 using namespace ipc;
 
@@ -25,3 +28,82 @@ TEST_CASE("Build SpatialHash", "[spatial_hash][build]")
 
     sh.clear();
 }
+
+TEST_CASE("Update SpatialHash keeps the voxel size", "[spatial_hash][update]")
+{
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh("cube.obj", V0, E, F));
+
+    const double voxel_size = 0.3;
+
+    SpatialHash sh;
+    sh.build(V0, E, F, /*inflation_radius=*/0, voxel_size);
+    CHECK(sh.one_div_voxelSize == 1 / voxel_size);
+
+    // Leaving the voxel grid forces a rebuild with the same voxel size.
+    const Eigen::MatrixXd V1 = 2 * V0;
+    sh.update(V0, V1, E, F);
+    CHECK(sh.one_div_voxelSize == 1 / voxel_size);
+    CHECK(
+        (sh.right_top_corner.transpose() >= V1.colwise().maxCoeff().array())
+            .all());
+}
+
+TEST_CASE("Update SpatialHash voxel table", "[spatial_hash][update]")
+{
+    const auto [mesh_name, voxel_size] = GENERATE(
+        std::make_pair(std::string("bunny.obj"), 0.05),
+        // The extent of the cube is a multiple of the voxel size.
+        std::make_pair(std::string("cube.obj"), 0.25));
+    CAPTURE(mesh_name, voxel_size);
+
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh(mesh_name, V0, E, F));
+
+    // Move a few vertices halfway to the centroid so the grid is unchanged.
+    Eigen::MatrixXd V1 = V0;
+    const Eigen::RowVector3d centroid = V0.colwise().mean();
+    for (int i = 0; i < V1.rows(); i += 25) {
+        V1.row(i) = (V1.row(i) + centroid) / 2;
+    }
+
+    SpatialHash sh;
+    sh.build(V0, E, F, /*inflation_radius=*/0, voxel_size);
+    sh.update(V0, V1, E, F);
+
+    SpatialHash expected;
+    expected.build(V0, V1, E, F, /*inflation_radius=*/0, voxel_size);
+
+    CHECK(sh.point_and_edge_occupancy == expected.point_and_edge_occupancy);
+    CHECK(sh.face_occupancy == expected.face_occupancy);
+    CHECK(sh.voxel_ids == expected.voxel_ids);
+    CHECK(sh.voxel_offsets == expected.voxel_offsets);
+    CHECK(sh.voxel_primitives == expected.voxel_primitives);
+}
+
+TEST_CASE("SpatialHash matches BVH on a cloth grid", "[spatial_hash][bvh]")
+{
+#ifdef NDEBUG
+    const int n = 150;
+#else
+    const int n = 50;
+#endif
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    tests::cloth_grid(n, V0, E, F);
+
+    // Wrinkle the cloth a little over the step.
+    srand(0);
+    Eigen::MatrixXd V1 = V0;
+    V1.col(1) += 1e-3 * Eigen::VectorXd::Random(V1.rows());
+
+    SpatialHash sh;
+    sh.build(V0, V1, E, F, /*inflation_radius=*/0, /*voxel_size=*/0.01);
+
+    BVH bvh;
+    bvh.build(V0, V1, E, F, /*inflation_radius=*/0);
+
+    check_same_candidates(sh, bvh);
+}
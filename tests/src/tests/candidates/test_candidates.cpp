@@ -1,6 +1,14 @@
+#include <tests/utils.hpp>
+
 #include <catch2/catch_test_macros.hpp>
 
 #include <ipc/candidates/candidates.hpp>
+#include <ipc/candidates/narrow_phase_ccd.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
 
 using namespace ipc;
 
@@ -123,4 +131,113 @@ TEST_CASE("Edge-Face Candidate", "[candidates][edge-face]")
     CHECK(EdgeFaceCandidate(0, 1) < EdgeFaceCandidate(0, 2));
     CHECK(!(EdgeFaceCandidate(1, 1) < EdgeFaceCandidate(0, 2)));
     CHECK(EdgeFaceCandidate(0, 1) < EdgeFaceCandidate(2, 0));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Candidate ToI lower bound", "[candidates][ccd]")
+{
+    const double min_distance = GENERATE(0.0, 1e-3);
+    const double dy = GENERATE(-0.5, -1.0, -2.0, -4.0);
+    CAPTURE(min_distance, dy);
+
+    // Point falling onto a triangle
+    Eigen::MatrixXd V0(4, 3), V1;
+    V0 << 0, 1, 0, //
+        -1, 0, 1,  //
+        1, 0, 1,   //
+        0, 0, -1;
+    V1 = V0;
+    V1(0, 1) += dy;
+    Eigen::MatrixXi F(1, 3);
+    F << 1, 2, 3;
+
+    const FaceVertexCandidate candidate(0, 0);
+    const VectorMax12d x0 = candidate.dof(V0, Eigen::MatrixXi(), F);
+    const VectorMax12d x1 = candidate.dof(V1, Eigen::MatrixXi(), F);
+
+    const double lower_bound =
+        candidate.compute_toi_lower_bound(x0, x1, min_distance);
+    CHECK(lower_bound > 0);
+
+    double toi;
+    if (candidate.ccd(x0, x1, toi, min_distance)) {
+        CHECK(lower_bound <= toi);
+    }
+
+    // No motion
+    CHECK(
+        candidate.compute_toi_lower_bound(x0, x0, min_distance)
+        == std::numeric_limits<double>::infinity());
+}
+
+TEST_CASE("Batched narrow phase CCD", "[candidates][ccd]")
+{
+    Eigen::MatrixXd V0, V1;
+    Eigen::MatrixXi E, F;
+
+    SECTION("2D")
+    {
+        // Vertical edge falling through a horizontal edge
+        V0.resize(4, 2);
+        V0 << -1, 0, //
+            1, 0,    //
+            0, 1,    //
+            0, 2;
+        V1 = V0;
+        V1.bottomRows(2).col(1).array() -= 3;
+        E.resize(2, 2);
+        E << 0, 1, //
+            2, 3;
+    }
+    SECTION("3D")
+    {
+        REQUIRE(tests::load_squished_bunny(V0, V1, E, F));
+    }
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V0, E, F);
+    V0 = mesh.vertices(V0);
+    V1 = mesh.vertices(V1);
+
+    Candidates candidates;
+    candidates.build(mesh, V0, V1);
+    REQUIRE(!candidates.empty());
+
+    // Reference per-candidate narrow phase
+    std::vector<double> expected_tois(candidates.size());
+    for (size_t i = 0; i < candidates.size(); i++) {
+        const ContinuousCollisionCandidate& candidate = candidates[i];
+        double toi;
+        expected_tois[i] = tests::candidate_ccd(candidate, mesh, V0, V1, toi)
+            ? toi
+            : std::numeric_limits<double>::infinity();
+    }
+
+    CHECK(narrow_phase_ccd(candidates, mesh, V0, V1) == expected_tois);
+
+    // Blocks may mix candidate types in any order.
+    std::vector<size_t> indices(candidates.size());
+    std::iota(indices.begin(), indices.end(), size_t(0));
+    std::shuffle(indices.begin(), indices.end(), std::mt19937(0));
+
+    for (size_t begin = 0; begin < indices.size();
+         begin += NARROW_PHASE_CCD_BLOCK_SIZE) {
+        const size_t n =
+            std::min(NARROW_PHASE_CCD_BLOCK_SIZE, indices.size() - begin);
+        const NarrowPhaseCCDBlock block(
+            candidates, mesh, V0, V1, indices.data() + begin, n);
+        REQUIRE(block.size() == n);
+
+        for (size_t k = 0; k < n; k++) {
+            double toi;
+            const double expected_toi = expected_tois[indices[begin + k]];
+            CHECK(block.ccd(k, toi) == std::isfinite(expected_toi));
+            if (std::isfinite(expected_toi)) {
+                CHECK(toi == expected_toi);
+            }
+        }
+    }
+
+    const bool is_collision_free = std::all_of(
+        expected_tois.begin(), expected_tois.end(),
+        [](double toi) { return std::isinf(toi); });
+    CHECK(candidates.is_step_collision_free(mesh, V0, V1) == is_collision_free);
+}
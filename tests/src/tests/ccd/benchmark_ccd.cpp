@@ -5,6 +5,13 @@
 #include <catch2/benchmark/catch_benchmark.hpp>
 
 #include <ipc/ipc.hpp>
+#include <ipc/candidates/candidates.hpp>
+#include <ipc/candidates/narrow_phase_ccd.hpp>
+#include <ipc/utils/logger.hpp>
+
+#include <tbb/parallel_for.h>
+
+#include <mutex>
 
 using namespace ipc;
 
@@ -59,7 +66,175 @@ TEST_CASE("Benchmark earliest toi", "[!benchmark][ccd][earliest_toi]")
     BENCHMARK(fmt::format("Earliest ToI Narrow-Phase"))
     {
         stepsize = candidates.compute_collision_free_stepsize(
-            mesh, V0, V1, tolerance, max_iterations);
+            mesh, V0, V1, /*min_distance=*/0, tolerance, max_iterations);
     };
     // }
+
+    // Report the work saved by processing the candidates in ToI order.
+    CCDStepsizeStats stats;
+    stepsize = candidates.compute_collision_free_stepsize(
+        mesh, V0, V1, /*min_distance=*/0, tolerance, max_iterations,
+        /*filter_counts=*/nullptr, &stats);
+    fmt::print(
+        "Earliest ToI: skipped {:L} of {:L} candidates by their ToI lower "
+        "bound; checking the other {:L} took {:g} s (an estimated {:g} s "
+        "saved)\n",
+        stats.num_skipped, candidates.size(), stats.num_checked,
+        stats.check_time, stats.estimated_time_saved());
+}
+
+TEST_CASE(
+    "Benchmark is step collision free",
+    "[!benchmark][ccd][is_step_collision_free]")
+{
+    Eigen::MatrixXd V0, V1;
+    Eigen::MatrixXi E, F;
+
+    SECTION("Bunny")
+    {
+        REQUIRE(tests::load_squished_bunny(V0, V1, E, F));
+    }
+    SECTION("Cloth-Ball")
+    {
+        REQUIRE(tests::load_mesh("cloth_ball92.ply", V0, E, F));
+        REQUIRE(tests::load_mesh("cloth_ball93.ply", V1, E, F));
+    }
+
+    CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V0, E, F);
+    // Discard codimensional/internal vertices
+    V0 = mesh.vertices(V0);
+    V1 = mesh.vertices(V1);
+
+    Candidates candidates;
+    candidates.build(mesh, V0, V1);
+
+    // Reference serial narrow phase
+    const auto serial_is_step_collision_free = [&]() {
+        for (size_t i = 0; i < candidates.size(); i++) {
+            const ContinuousCollisionCandidate& candidate = candidates[i];
+            double toi;
+            if (tests::candidate_ccd(candidate, mesh, V0, V1, toi)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    CHECK(
+        candidates.is_step_collision_free(mesh, V0, V1)
+        == serial_is_step_collision_free());
+
+    BENCHMARK("Serial is step collision free")
+    {
+        return serial_is_step_collision_free();
+    };
+
+    BENCHMARK("Parallel is step collision free")
+    {
+        return candidates.is_step_collision_free(mesh, V0, V1);
+    };
+}
+
+TEST_CASE(
+    "Benchmark ToI-ordered earliest toi",
+    "[!benchmark][ccd][earliest_toi]")
+{
+    Eigen::MatrixXd V0, V1;
+    Eigen::MatrixXi E, F;
+
+    REQUIRE(tests::load_mesh("cloth_ball92.ply", V0, E, F));
+    REQUIRE(tests::load_mesh("cloth_ball93.ply", V1, E, F));
+
+    CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V0, E, F);
+    // Discard codimensional/internal vertices
+    V0 = mesh.vertices(V0);
+    V1 = mesh.vertices(V1);
+
+    Candidates candidates;
+    candidates.build(mesh, V0, V1);
+
+    // Reference narrow phase without ordering or pruning
+    const auto unordered_stepsize = [&]() {
+        double earliest_toi = 1;
+        std::mutex earliest_toi_mutex;
+        tbb::parallel_for(size_t(0), candidates.size(), [&](size_t i) {
+            double tmax;
+            {
+                std::scoped_lock lock(earliest_toi_mutex);
+                tmax = earliest_toi;
+            }
+            const ContinuousCollisionCandidate& candidate = candidates[i];
+            double toi;
+            if (tests::candidate_ccd(
+                    candidate, mesh, V0, V1, toi, /*min_distance=*/0.0,
+                    tmax)) {
+                std::scoped_lock lock(earliest_toi_mutex);
+                earliest_toi = std::min(earliest_toi, toi);
+            }
+        });
+        return earliest_toi;
+    };
+
+    // The number of skipped queries is reported at trace level.
+    const spdlog::level::level_enum log_level = logger().level();
+    logger().set_level(spdlog::level::trace);
+    const double stepsize =
+        candidates.compute_collision_free_stepsize(mesh, V0, V1);
+    logger().set_level(log_level);
+
+    CHECK(stepsize <= 1.0);
+    CHECK(stepsize > 0.0);
+
+    BENCHMARK("Earliest ToI Narrow-Phase (unordered)")
+    {
+        return unordered_stepsize();
+    };
+
+    BENCHMARK("Earliest ToI Narrow-Phase (ToI-ordered)")
+    {
+        return candidates.compute_collision_free_stepsize(mesh, V0, V1);
+    };
+}
+
+TEST_CASE(
+    "Benchmark batched narrow phase", "[!benchmark][ccd][narrow_phase]")
+{
+    Eigen::MatrixXd V0, V1;
+    Eigen::MatrixXi E, F;
+
+    REQUIRE(tests::load_mesh("cloth_ball92.ply", V0, E, F));
+    REQUIRE(tests::load_mesh("cloth_ball93.ply", V1, E, F));
+
+    CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V0, E, F);
+    // Discard codimensional/internal vertices
+    V0 = mesh.vertices(V0);
+    V1 = mesh.vertices(V1);
+
+    Candidates candidates;
+    candidates.build(mesh, V0, V1);
+
+    // Reference narrow phase through the virtual candidate interface
+    const auto per_candidate_tois = [&]() {
+        std::vector<double> tois(candidates.size());
+        tbb::parallel_for(size_t(0), candidates.size(), [&](size_t i) {
+            const ContinuousCollisionCandidate& candidate = candidates[i];
+            double toi;
+            tois[i] = tests::candidate_ccd(candidate, mesh, V0, V1, toi)
+                ? toi
+                : std::numeric_limits<double>::infinity();
+        });
+        return tois;
+    };
+
+    CHECK(narrow_phase_ccd(candidates, mesh, V0, V1) == per_candidate_tois());
+
+    BENCHMARK("Per-candidate narrow phase")
+    {
+        return per_candidate_tois();
+    };
+
+    BENCHMARK("Batched narrow phase")
+    {
+        return narrow_phase_ccd(candidates, mesh, V0, V1);
+    };
 }
@@ -0,0 +1,167 @@
+#include <tests/utils.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <ipc/ccd/ccd_filters.hpp>
+#include <ipc/candidates/narrow_phase_ccd.hpp>
+
+#include <igl/edges.h>
+
+#include <numeric>
+#include <random>
+
+using namespace ipc;
+
+TEST_CASE("Separating-axis CCD filter", "[ccd][filter]")
+{
+    const double threshold = GENERATE(0.0, 0.1);
+    CAPTURE(threshold);
+
+    // Point above a triangle in the xz-plane
+    Eigen::Matrix<double, 3, 1> p_t0, p_t1;
+    Eigen::Matrix3d t_t0;
+    t_t0 << -1, 1, 0, //
+        0, 0, 0,      //
+        1, 1, -1;
+    const Eigen::Matrix3d t_t1 = t_t0;
+    p_t0 << 0, 1, 0;
+
+    SECTION("Parallel motion")
+    {
+        p_t1 = p_t0 + Eigen::Vector3d(10, 0, 0);
+        CHECK(separating_axis_filter(
+            Eigen::Vector3d::UnitY(), p_t0, p_t1, t_t0, t_t1, threshold));
+    }
+    SECTION("Passing through")
+    {
+        p_t1 = p_t0 - Eigen::Vector3d(0, 2, 0);
+        CHECK(!separating_axis_filter(
+            Eigen::Vector3d::UnitY(), p_t0, p_t1, t_t0, t_t1, threshold));
+    }
+    SECTION("Stopping short of the threshold")
+    {
+        p_t1 = p_t0 - Eigen::Vector3d(0, 0.95, 0);
+        CHECK(
+            separating_axis_filter(
+                Eigen::Vector3d::UnitY(), p_t0, p_t1, t_t0, t_t1, threshold)
+            == (threshold < 0.05));
+    }
+}
+
+TEST_CASE("Sign-of-volume CCD filter", "[ccd][filter]")
+{
+    // Edges of a triangle in the xz-plane and the offset of a point above it
+    const Eigen::Vector3d a(1, 0, 0), b(0, 0, 1);
+    const Eigen::Vector3d c_t0(0.25, 1, 0.25);
+
+    // Moving within the plane y = 1
+    CHECK(sign_of_volume_filter(
+        a, a, b, b, c_t0, c_t0 + Eigen::Vector3d(5, 0, -3), 0.5));
+    CHECK(!sign_of_volume_filter(
+        a, a, b, b, c_t0, c_t0 + Eigen::Vector3d(5, 0, -3), 1.5));
+
+    // Passing through the plane y = 0
+    CHECK(!sign_of_volume_filter(
+        a, a, b, b, c_t0, c_t0 - Eigen::Vector3d(0, 2, 0), 0.0));
+
+    // Rotating triangle whose plane sweeps through the point
+    const Eigen::Vector3d a_t1(1, 0, 0), b_t1(0, 8, 1);
+    CHECK(!sign_of_volume_filter(a, a_t1, b, b_t1, c_t0, c_t0, 0.0));
+}
+
+TEST_CASE("CCD filters are conservative", "[ccd][filter]")
+{
+    const double min_distance = GENERATE(0.0, 1e-3);
+    const double noise = GENERATE(0.0, 1e-2);
+    CAPTURE(min_distance, noise);
+
+    Eigen::MatrixXd V0, V1;
+    Eigen::MatrixXi E, F;
+    // Squish the bunny into itself and perturb the end positions
+    REQUIRE(tests::load_squished_bunny(V0, V1, E, F, /*x_scale=*/0.5));
+    std::mt19937 gen(0);
+    std::normal_distribution<double> distribution(
+        0, noise * (V0.colwise().maxCoeff() - V0.colwise().minCoeff()).norm());
+    V1 = V1.unaryExpr([&](double x) { return x + distribution(gen); });
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V0, E, F);
+
+    Candidates candidates;
+    candidates.build(mesh, V0, V1, min_distance);
+
+    std::vector<size_t> indices(candidates.size());
+    std::iota(indices.begin(), indices.end(), size_t(0));
+
+    CCDFilterCounts counts;
+    for (size_t begin = 0; begin < indices.size();
+         begin += NARROW_PHASE_CCD_BLOCK_SIZE) {
+        const size_t n =
+            std::min(NARROW_PHASE_CCD_BLOCK_SIZE, indices.size() - begin);
+        const NarrowPhaseCCDBlock block(
+            candidates, mesh, V0, V1, indices.data() + begin, n);
+
+        for (size_t i = 0; i < n; i++) {
+            const CCDFilter filter = block.filter(i, min_distance);
+            counts.record(filter);
+            if (filter != CCDFilter::NONE) {
+                double toi;
+                CAPTURE(begin + i, filter);
+                CHECK(!block.ccd(i, toi, min_distance));
+            }
+        }
+    }
+
+    CHECK(
+        counts.toi_lower_bound + counts.separating_axis + counts.sign_of_volume
+            + counts.root_finding
+        == candidates.size());
+    CHECK(counts.separating_axis > 0);
+}
+
+TEST_CASE("CCD filter counts", "[ccd][filter]")
+{
+    // A point above a triangle, both rotating by 90° about the z-axis. The
+    // point stays on the same side of the triangle's plane, but no separating
+    // axis exists over the step.
+    Eigen::MatrixXd V0(4, 3), V1(4, 3);
+    V0 << 0, 1, 0, //
+        -1, 0, -1, //
+        1, 0, -1,  //
+        0, 0, 1;
+    V1 << -1, 0, 0, //
+        0, -1, -1,  //
+        0, 1, -1,   //
+        0, 0, 1;
+    Eigen::MatrixXi E, F(1, 3);
+    F << 1, 2, 3;
+    igl::edges(F, E);
+
+    const CollisionMesh mesh(V0, E, F);
+
+    Candidates candidates;
+    candidates.build(mesh, V0, V1);
+    REQUIRE(candidates.fv_candidates.size() == 1);
+
+    CCDFilterCounts counts;
+    SECTION("Step collision free")
+    {
+        CHECK(candidates.is_step_collision_free(
+            mesh, V0, V1, /*min_distance=*/0.0, DEFAULT_CCD_TOLERANCE,
+            DEFAULT_CCD_MAX_ITERATIONS, &counts));
+    }
+    SECTION("Collision free stepsize")
+    {
+        CHECK(
+            candidates.compute_collision_free_stepsize(
+                mesh, V0, V1, /*min_distance=*/0.0, DEFAULT_CCD_TOLERANCE,
+                DEFAULT_CCD_MAX_ITERATIONS, &counts)
+            == 1.0);
+    }
+
+    CHECK(
+        counts.toi_lower_bound + counts.separating_axis + counts.sign_of_volume
+            + counts.root_finding
+        == candidates.size());
+    CHECK(counts.sign_of_volume > 0);
+}
@@ -0,0 +1,50 @@
+#include <tests/utils.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <ipc/collisions/collisions.hpp>
+#include <ipc/utils/logger.hpp>
+
+using namespace ipc;
+
+TEST_CASE(
+    "Benchmark batched candidate culling", "[!benchmark][collisions][cull]")
+{
+#ifdef NDEBUG
+    const std::string filename = GENERATE(
+        std::string("two-cubes-close.obj"), std::string("bunny.obj"));
+#else
+    const std::string filename = "two-cubes-close.obj";
+#endif
+
+    Eigen::MatrixXd vertices;
+    Eigen::MatrixXi edges, faces;
+    REQUIRE(tests::load_mesh(filename, vertices, edges, faces));
+
+    const CollisionMesh mesh =
+        CollisionMesh::build_from_full_mesh(vertices, edges, faces);
+    vertices = mesh.vertices(vertices);
+
+    // Relative to the bounding box so the fraction of active candidates is
+    // comparable across meshes.
+    const double dhat = GENERATE(1e-3, 1e-2, 5e-2)
+        * (vertices.colwise().maxCoeff() - vertices.colwise().minCoeff())
+              .norm();
+
+    // The broad phase is shared so only the narrow phase is timed.
+    Candidates candidates;
+    candidates.build(mesh, vertices, dhat);
+
+    Collisions collisions;
+    for (const bool use_batch_culling : { false, true }) {
+        collisions.set_use_batch_culling(use_batch_culling);
+        BENCHMARK(fmt::format(
+            "{} dhat={:g} fv={} cull={}", filename, dhat,
+            candidates.fv_candidates.size(), use_batch_culling))
+        {
+            collisions.build(candidates, mesh, vertices, dhat);
+        };
+    }
+}
@@ -4,7 +4,10 @@
 #include <catch2/catch_approx.hpp>
 
 #include <ipc/collisions/collisions.hpp>
+#include <ipc/collisions/collisions_builder.hpp>
+#include <ipc/collisions/compact_collisions.hpp>
 #include <ipc/potentials/barrier_potential.hpp>
+#include <ipc/utils/unordered_map_and_set.hpp>
 
 using namespace ipc;
 
@@ -292,4 +295,228 @@ TEST_CASE("Collisions::is_*", "[collisions]")
         CHECK(collisions.is_face_vertex(i) == (i == 3));
         CHECK(collisions.is_plane_vertex(i) == (i == 4));
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Compact collisions", "[collisions][compact]")
+{
+    const bool use_convergent_formulation = GENERATE(true, false);
+
+    Eigen::MatrixXd vertices;
+    Eigen::MatrixXi edges, faces;
+    REQUIRE(tests::load_mesh("two-cubes-close.obj", vertices, edges, faces));
+
+    const CollisionMesh mesh =
+        CollisionMesh::build_from_full_mesh(vertices, edges, faces);
+    vertices = mesh.vertices(vertices);
+
+    const double dhat = 0.2;
+    Collisions collisions;
+    collisions.set_use_convergent_formulation(use_convergent_formulation);
+    collisions.build(mesh, vertices, dhat);
+    collisions.pv_collisions.emplace_back(
+        vertices.row(0).transpose() - Eigen::Vector3d(0, 0.1, 0),
+        Eigen::Vector3d(0, 1, 0), 0);
+    REQUIRE(collisions.size() > 1);
+
+    const CompactCollisions compact(collisions, mesh);
+    REQUIRE(compact.size() == collisions.size());
+    CHECK(compact.vv.size() == collisions.vv_collisions.size());
+    CHECK(compact.ev.size() == collisions.ev_collisions.size());
+    CHECK(compact.ee.size() == collisions.ee_collisions.size());
+    CHECK(compact.fv.size() == collisions.fv_collisions.size());
+    CHECK(compact.pv.size() == collisions.pv_collisions.size());
+
+    for (size_t i = 0; i < compact.fv.size(); i++) {
+        const std::array<long, 4> ids =
+            collisions.fv_collisions[i].vertex_ids(mesh.edges(), mesh.faces());
+        CHECK(compact.fv.vertex_ids[i] == ids);
+    }
+
+    const BarrierPotential barrier_potential(dhat);
+    CHECK(
+        barrier_potential(compact, vertices)
+        == Catch::Approx(barrier_potential(collisions, mesh, vertices)));
+
+    CompactCollisions empty;
+    CHECK(empty.empty());
+    CHECK(barrier_potential(empty, vertices) == 0);
+}
+
+TEST_CASE("Batched candidate culling", "[collisions][cull]")
+{
+    const double dhat = GENERATE(1e-3, 1e-2, 0.1, 0.5);
+    CAPTURE(dhat);
+
+    Eigen::MatrixXd vertices;
+    Eigen::MatrixXi edges, faces;
+    REQUIRE(tests::load_mesh("two-cubes-close.obj", vertices, edges, faces));
+
+    const CollisionMesh mesh =
+        CollisionMesh::build_from_full_mesh(vertices, edges, faces);
+    vertices = mesh.vertices(vertices);
+
+    Candidates candidates;
+    candidates.build(mesh, vertices, dhat);
+
+    // Build the same collisions with and without the batched cull
+    std::array<Collisions, 2> collisions;
+    for (int use_batch_culling = 0; use_batch_culling < 2;
+         use_batch_culling++) {
+        collisions[use_batch_culling].set_use_batch_culling(use_batch_culling);
+        collisions[use_batch_culling].build(candidates, mesh, vertices, dhat);
+    }
+
+    const Collisions& unculled = collisions[0];
+    const Collisions& culled = collisions[1];
+
+    // Culled face-vertex candidates also skip their vertex-vertex and
+    // edge-vertex collisions.
+    CHECK(culled.vv_collisions.size() == unculled.vv_collisions.size());
+    CHECK(culled.ev_collisions.size() == unculled.ev_collisions.size());
+
+    REQUIRE(culled.ee_collisions.size() == unculled.ee_collisions.size());
+    for (size_t i = 0; i < culled.ee_collisions.size(); i++) {
+        CHECK(culled.ee_collisions[i] == unculled.ee_collisions[i]);
+        CHECK(
+            culled.ee_collisions[i].weight
+            == unculled.ee_collisions[i].weight);
+    }
+
+    REQUIRE(culled.fv_collisions.size() == unculled.fv_collisions.size());
+    for (size_t i = 0; i < culled.fv_collisions.size(); i++) {
+        CHECK(
+            culled.fv_collisions[i].vertex_ids(mesh.edges(), mesh.faces())
+            == unculled.fv_collisions[i].vertex_ids(
+                mesh.edges(), mesh.faces()));
+        CHECK(
+            culled.fv_collisions[i].weight
+            == unculled.fv_collisions[i].weight);
+    }
+}
+
+namespace {
+/// @brief Merge collisions one at a time through a hash map (the previous CollisionsBuilder::merge).
+template <typename TCollision>
+void hash_map_merge(
+    const std::vector<TCollision>& local_collisions,
+    unordered_map<TCollision, long>& to_id,
+    std::vector<TCollision>& merged_collisions)
+{
+    for (const TCollision& collision : local_collisions) {
+        auto found_item = to_id.find(collision);
+        if (found_item != to_id.end()) {
+            merged_collisions[found_item->second].weight += collision.weight;
+            merged_collisions[found_item->second].weight_gradient +=
+                collision.weight_gradient;
+        } else {
+            to_id.emplace(collision, merged_collisions.size());
+            merged_collisions.push_back(collision);
+        }
+    }
+}
+
+template <typename TCollision>
+void check_same_collisions(
+    const std::vector<TCollision>& actual,
+    const std::vector<TCollision>& expected)
+{
+    REQUIRE(actual.size() == expected.size());
+    for (size_t i = 0; i < actual.size(); i++) {
+        CAPTURE(i);
+        CHECK(actual[i] == expected[i]);
+        CHECK(actual[i].weight == expected[i].weight);
+        CHECK(
+            Eigen::VectorXd(actual[i].weight_gradient)
+            == Eigen::VectorXd(expected[i].weight_gradient));
+    }
+}
+} // namespace
+
+TEST_CASE("Merge thread-local collisions", "[collisions][merge]")
+{
+    constexpr int NUM_BUILDERS = 4;
+    constexpr double dhat = 0.1;
+
+    Eigen::MatrixXd vertices;
+    Eigen::MatrixXi edges, faces;
+    REQUIRE(tests::load_mesh("two-cubes-close.obj", vertices, edges, faces));
+
+    CollisionMesh mesh =
+        CollisionMesh::build_from_full_mesh(vertices, edges, faces);
+    mesh.init_area_jacobians();
+    vertices = mesh.vertices(vertices);
+
+    Candidates candidates;
+    candidates.build(mesh, vertices, dhat);
+
+    auto is_active = [&](double distance_sqr) {
+        return distance_sqr < dhat * dhat;
+    };
+
+    // Fill the builders by hand, each with a contiguous share of the
+    // candidates, so duplicate stencils are spread over several builders in
+    // a known order.
+    const auto share = [&](const size_t n, const int k) {
+        return n * k / NUM_BUILDERS;
+    };
+    std::vector<CollisionsBuilder> builders;
+    for (int k = 0; k < NUM_BUILDERS; k++) {
+        CollisionsBuilder& builder = builders.emplace_back(
+            /*use_convergent_formulation=*/true,
+            /*are_shape_derivatives_enabled=*/true);
+        builder.add_vertex_vertex_collisions(
+            mesh, vertices, candidates.vv_candidates, is_active,
+            share(candidates.vv_candidates.size(), k),
+            share(candidates.vv_candidates.size(), k + 1));
+        builder.add_edge_vertex_collisions(
+            mesh, vertices, candidates.ev_candidates, is_active,
+            share(candidates.ev_candidates.size(), k),
+            share(candidates.ev_candidates.size(), k + 1));
+        builder.add_edge_edge_collisions(
+            mesh, vertices, candidates.ee_candidates, is_active,
+            share(candidates.ee_candidates.size(), k),
+            share(candidates.ee_candidates.size(), k + 1));
+        builder.add_face_vertex_collisions(
+            mesh, vertices, candidates.fv_candidates, is_active,
+            share(candidates.fv_candidates.size(), k),
+            share(candidates.fv_candidates.size(), k + 1));
+    }
+
+    Collisions merged;
+    CollisionsBuilder::merge(builders, merged);
+
+    // The collisions of each builder (merging a single builder copies them)
+    std::vector<Collisions> locals;
+    for (const CollisionsBuilder& builder : builders) {
+        CollisionsBuilder::merge(
+            std::vector<CollisionsBuilder>(1, builder), locals.emplace_back());
+    }
+
+    // Reference: fold the builders' collisions into hash maps in order.
+    Collisions expected;
+    unordered_map<VertexVertexCollision, long> vv_to_id;
+    unordered_map<EdgeVertexCollision, long> ev_to_id;
+    unordered_map<EdgeEdgeCollision, long> ee_to_id;
+    size_t num_local = 0;
+    for (const Collisions& local : locals) {
+        hash_map_merge(local.vv_collisions, vv_to_id, expected.vv_collisions);
+        hash_map_merge(local.ev_collisions, ev_to_id, expected.ev_collisions);
+        hash_map_merge(local.ee_collisions, ee_to_id, expected.ee_collisions);
+        expected.fv_collisions.insert(
+            expected.fv_collisions.end(), local.fv_collisions.begin(),
+            local.fv_collisions.end());
+        num_local += local.vv_collisions.size() + local.ev_collisions.size()
+            + local.ee_collisions.size();
+    }
+
+    // Some stencils must have been found by several builders.
+    CHECK(
+        num_local
+        > merged.vv_collisions.size() + merged.ev_collisions.size()
+            + merged.ee_collisions.size());
+
+    check_same_collisions(merged.vv_collisions, expected.vv_collisions);
+    check_same_collisions(merged.ev_collisions, expected.ev_collisions);
+    check_same_collisions(merged.ee_collisions, expected.ee_collisions);
+    check_same_collisions(merged.fv_collisions, expected.fv_collisions);
+}
@@ -0,0 +1,109 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <ipc/distance/distance_batch.hpp>
+#include <ipc/distance/point_triangle.hpp>
+
+#include <cmath>
+#include <random>
+
+using namespace ipc;
+
+namespace {
+/// @brief Generate a batch of point-triangle stencils, with one kind of nearly degenerate configuration per lane.
+/// @param gen Random number generator.
+/// @return The four points of each stencil.
+std::array<BatchPoints<DISTANCE_BATCH_SIZE>, 4>
+random_hard_stencils(std::mt19937& gen)
+{
+    constexpr int N = DISTANCE_BATCH_SIZE;
+    std::uniform_real_distribution<double> dist(-1, 1);
+    std::uniform_int_distribution<int> exponent(1, 15);
+
+    std::array<BatchPoints<N>, 4> x;
+    for (auto& xi : x) {
+        xi = BatchPoints<N>::NullaryExpr([&]() { return dist(gen); });
+    }
+
+    const auto tiny = [&]() {
+        return Eigen::RowVector3d::NullaryExpr([&]() { return dist(gen); })
+            * std::pow(10.0, -exponent(gen));
+    };
+
+    for (int j = 0; j < N; j++) {
+        switch (j) {
+        case 0: // random
+            break;
+        case 1: // edge t1-t2 nearly parallel to t0 - p
+            x[3].row(j) = x[2].row(j) + dist(gen) * (x[1].row(j) - x[0].row(j))
+                + tiny().array();
+            break;
+        case 2: // same with t1 nearly at the point
+            x[2].row(j) = x[0].row(j) + tiny().array();
+            x[3].row(j) = x[2].row(j) + dist(gen) * (x[1].row(j) - x[0].row(j))
+                + tiny().array();
+            break;
+        case 3: // nearly degenerate triangle
+            x[3].row(j) = x[2].row(j) + tiny().array();
+            break;
+        case 4: // exactly degenerate triangle
+            x[3].row(j) = x[2].row(j);
+            break;
+        case 5: // nearly touching
+            x[2].row(j) = x[0].row(j) + tiny().array();
+            break;
+        default: // edge t1-t2 nearly parallel to t0 - p far from the origin
+            x[3].row(j) = x[2].row(j) + dist(gen) * (x[1].row(j) - x[0].row(j))
+                + tiny().array();
+            const Eigen::RowVector3d offset =
+                Eigen::RowVector3d::Constant(std::pow(10.0, exponent(gen) / 3));
+            for (auto& xi : x) {
+                xi.row(j) += offset.array();
+            }
+            break;
+        }
+    }
+
+    // Move the points by a random translation so that the bounds are not all
+    // zero.
+    const double gap = std::pow(10.0, -exponent(gen) / 3.0);
+    for (int j = 0; j < N; j++) {
+        const Eigen::RowVector3d direction =
+            Eigen::RowVector3d::NullaryExpr([&]() { return dist(gen); });
+        x[0].row(j) += gap * direction.array();
+    }
+
+    return x;
+}
+} // namespace
+
+TEST_CASE(
+    "Batched point-triangle distance lower bound",
+    "[distance][point-triangle][cull]")
+{
+    constexpr int N = DISTANCE_BATCH_SIZE;
+
+    std::mt19937 gen(GENERATE(0, 1, 2, 3));
+
+    int num_positive = 0;
+    for (int trial = 0; trial < 1000; trial++) {
+        const std::array<BatchPoints<N>, 4> x =
+            random_hard_stencils(gen);
+
+        BatchScalar<N> lower_bound;
+        point_triangle_distance_lower_bound_batch<N>(
+            x[0], x[1], x[2], x[3], lower_bound);
+
+        for (int j = 0; j < N; j++) {
+            const Eigen::Vector3d p = x[0].row(j), t0 = x[1].row(j),
+                                  t1 = x[2].row(j), t2 = x[3].row(j);
+            const double distance = point_triangle_distance(p, t0, t1, t2);
+            CAPTURE(trial, j, p, t0, t1, t2);
+            // The cull keeps every candidate the scalar path would keep.
+            CHECK(lower_bound[j] >= 0);
+            CHECK(lower_bound[j] <= distance);
+            num_positive += lower_bound[j] > 0;
+        }
+    }
+    CHECK(num_positive > 0);
+}
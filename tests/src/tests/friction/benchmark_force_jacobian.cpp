@@ -0,0 +1,71 @@
+#include <tests/config.hpp>
+#include <tests/utils.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <ipc/ipc.hpp>
+#include <ipc/friction/friction_collisions.hpp>
+#include <ipc/potentials/friction_potential.hpp>
+
+#include <finitediff.hpp>
+
+using namespace ipc;
+
+TEST_CASE(
+    "Benchmark friction force jacobian",
+    "[!benchmark][friction][force-jacobian]")
+{
+    const double mu = 0.5, dhat = 1e-2, kappa = 8.6e9, epsv_dt = 1.5e-5;
+
+    Eigen::MatrixXd X, Ut, U;
+    Eigen::MatrixXi E;
+    {
+        const auto dir =
+            tests::DATA_DIR / "friction-force-jacobian" / "square-circle-dense";
+        X = tests::loadMarketXd((dir / "X.mtx").string());
+        Ut = tests::loadMarketXd((dir / "Ut.mtx").string());
+        Ut = fd::unflatten(Ut, X.cols());
+        U = tests::loadMarketXd((dir / "U.mtx").string());
+        U = fd::unflatten(U, X.cols());
+        E = tests::loadMarketXi((dir / "F.mtx").string());
+    }
+
+    std::vector<bool> is_on_surface =
+        CollisionMesh::construct_is_on_surface(X.rows(), E);
+    CollisionMesh mesh(is_on_surface, X, E, Eigen::MatrixXi());
+    mesh.init_area_jacobians();
+
+    X = mesh.vertices(X);
+    if (Ut.rows() != X.rows()) {
+        Ut = mesh.vertices(Ut);
+    }
+    if (U.rows() != X.rows()) {
+        U = mesh.vertices(U);
+    }
+    const Eigen::MatrixXd velocities = U - Ut;
+
+    Collisions collisions;
+    collisions.set_are_shape_derivatives_enabled(true);
+    collisions.build(mesh, X + Ut, dhat);
+
+    FrictionCollisions friction_collisions;
+    friction_collisions.build(mesh, X + Ut, collisions, dhat, kappa, mu);
+    REQUIRE(friction_collisions.size() > 0);
+
+    const FrictionPotential D(epsv_dt);
+
+    BENCHMARK("Force jacobian w.r.t. rest positions")
+    {
+        return D.force_jacobian(
+            friction_collisions, mesh, X, Ut, velocities, dhat, kappa,
+            FrictionPotential::DiffWRT::REST_POSITIONS);
+    };
+
+    BENCHMARK("Force jacobian w.r.t. velocities")
+    {
+        return D.force_jacobian(
+            friction_collisions, mesh, X, Ut, velocities, dhat, kappa,
+            FrictionPotential::DiffWRT::VELOCITIES);
+    };
+}
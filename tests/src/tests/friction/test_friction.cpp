@@ -4,6 +4,7 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 
+#include <ipc/distance/edge_edge_mollifier.hpp>
 #include <ipc/friction/friction_collisions.hpp>
 #include <ipc/potentials/friction_potential.hpp>
 #include <ipc/utils/logger.hpp>
@@ -244,3 +245,91 @@ TEST_CASE(
 
     CHECK(hess.isApprox(expected_hess));
 }
+
+TEST_CASE(
+    "Friction collisions build matches serial", "[friction][collisions]")
+{
+    const double dhat = 0.1;
+    const double barrier_stiffness = 100;
+    const double d = 0.05;
+    const int num_pairs = 300;
+
+    // Pairs of edges d apart and 2 apart from each other. Every third pair is
+    // nearly parallel (mollified), so its friction collision is skipped.
+    Eigen::MatrixXd V(4 * num_pairs, 3);
+    Eigen::MatrixXi E(2 * num_pairs, 2);
+    for (int k = 0; k < num_pairs; k++) {
+        const double x = 2 * k;
+        V.row(4 * k + 0) << x, 0, 0;
+        V.row(4 * k + 1) << x + 1, 0, 0;
+        if (k % 3 == 0) {
+            V.row(4 * k + 2) << x, d, 0;
+            V.row(4 * k + 3) << x + 1, d, 1e-6;
+        } else {
+            V.row(4 * k + 2) << x + 0.5, d, -0.5;
+            V.row(4 * k + 3) << x + 0.5 + 0.1 * (k % 5), d, 0.5;
+        }
+        E.row(2 * k + 0) << 4 * k + 0, 4 * k + 1;
+        E.row(2 * k + 1) << 4 * k + 2, 4 * k + 3;
+    }
+    const Eigen::MatrixXi F;
+
+    const CollisionMesh mesh(V, E, F);
+
+    Collisions collisions;
+    collisions.set_use_convergent_formulation(GENERATE(false, true));
+    collisions.build(mesh, V, dhat);
+    REQUIRE(collisions.ee_collisions.size() >= num_pairs);
+
+    const Eigen::VectorXd mus = Eigen::VectorXd::Random(V.rows()).cwiseAbs();
+
+    FrictionCollisions friction_collisions;
+    friction_collisions.build(
+        mesh, V, collisions, dhat, barrier_stiffness, mus);
+
+    // Serial reference
+    std::vector<EdgeEdgeFrictionCollision> expected;
+    for (const EdgeEdgeCollision& c_ee : collisions.ee_collisions) {
+        const auto& [ea0i, ea1i, eb0i, eb1i] = c_ee.vertex_ids(E, F);
+        const Eigen::Vector3d ea0 = V.row(ea0i), ea1 = V.row(ea1i),
+                              eb0 = V.row(eb0i), eb1 = V.row(eb1i);
+        if (edge_edge_cross_squarednorm(ea0, ea1, eb0, eb1) < c_ee.eps_x) {
+            continue;
+        }
+        expected.emplace_back(c_ee, V, E, F, dhat, barrier_stiffness);
+        const double ea_mu = (mus(ea1i) - mus(ea0i))
+                * expected.back().closest_point[0]
+            + mus(ea0i);
+        const double eb_mu = (mus(eb1i) - mus(eb0i))
+                * expected.back().closest_point[1]
+            + mus(eb0i);
+        expected.back().mu =
+            FrictionCollisions::default_blend_mu(ea_mu, eb_mu);
+    }
+    REQUIRE(expected.size() < collisions.ee_collisions.size());
+
+    CHECK(
+        friction_collisions.vv_collisions.size()
+        == collisions.vv_collisions.size());
+    CHECK(
+        friction_collisions.ev_collisions.size()
+        == collisions.ev_collisions.size());
+    CHECK(
+        friction_collisions.fv_collisions.size()
+        == collisions.fv_collisions.size());
+    REQUIRE(friction_collisions.ee_collisions.size() == expected.size());
+
+    for (size_t i = 0; i < expected.size(); i++) {
+        CAPTURE(i);
+        const EdgeEdgeFrictionCollision& collision =
+            friction_collisions.ee_collisions[i];
+        CHECK(collision.vertex_ids(E, F) == expected[i].vertex_ids(E, F));
+        CHECK(collision.closest_point == expected[i].closest_point);
+        CHECK(collision.tangent_basis == expected[i].tangent_basis);
+        CHECK(
+            collision.normal_force_magnitude
+            == expected[i].normal_force_magnitude);
+        CHECK(collision.weight == expected[i].weight);
+        CHECK(collision.mu == Catch::Approx(expected[i].mu));
+    }
+}
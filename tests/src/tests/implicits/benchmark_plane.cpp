@@ -0,0 +1,44 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <ipc/implicits/plane.hpp>
+
+using namespace ipc;
+
+TEST_CASE(
+    "Benchmark point-plane collisions and CCD",
+    "[!benchmark][implicit][plane]")
+{
+    // 1M points in a unit cube and 50 random planes, most of them far from
+    // the points they do not cut through.
+    srand(0);
+    const Eigen::MatrixXd points_t0 = Eigen::MatrixXd::Random(1'000'000, 3);
+    const Eigen::MatrixXd points_t1 =
+        points_t0 + 1e-2 * Eigen::MatrixXd::Random(points_t0.rows(), 3);
+
+    Eigen::MatrixXd plane_origins = 2 * Eigen::MatrixXd::Random(50, 3);
+    Eigen::MatrixXd plane_normals = Eigen::MatrixXd::Random(50, 3);
+    plane_normals.rowwise().normalize();
+
+    const double dhat = 1e-3;
+
+    BENCHMARK("Construct point-plane collisions")
+    {
+        std::vector<PlaneVertexCollision> pv_collisions;
+        construct_point_plane_collisions(
+            points_t0, plane_origins, plane_normals, dhat, pv_collisions);
+        return pv_collisions.size();
+    };
+
+    BENCHMARK("Point-plane collision free step size")
+    {
+        return compute_point_plane_collision_free_stepsize(
+            points_t0, points_t1, plane_origins, plane_normals);
+    };
+
+    BENCHMARK("Is point-plane step collision free")
+    {
+        return is_step_point_plane_collision_free(
+            points_t0, points_t1, plane_origins, plane_normals);
+    };
+}
@@ -0,0 +1,97 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <ipc/implicits/plane.hpp>
+#include <ipc/ccd/point_static_plane.hpp>
+#include <ipc/distance/point_plane.hpp>
+
+using namespace ipc;
+
+namespace {
+void random_planes(
+    const int n_planes,
+    Eigen::MatrixXd& plane_origins,
+    Eigen::MatrixXd& plane_normals)
+{
+    plane_origins = Eigen::MatrixXd::Random(n_planes, 3);
+    plane_normals = Eigen::MatrixXd::Random(n_planes, 3);
+    plane_normals.rowwise().normalize();
+}
+} // namespace
+
+TEST_CASE("Point-plane collisions", "[implicit][plane][collisions]")
+{
+    const double dhat = GENERATE(1e-3, 1e-2, 1e-1);
+    const double dmin = GENERATE(0, 1e-2);
+
+    srand(0);
+    Eigen::MatrixXd plane_origins, plane_normals;
+    random_planes(8, plane_origins, plane_normals);
+    const Eigen::MatrixXd points = Eigen::MatrixXd::Random(5000, 3);
+
+    std::vector<PlaneVertexCollision> pv_collisions;
+    construct_point_plane_collisions(
+        points, plane_origins, plane_normals, dhat, pv_collisions, dmin);
+
+    // Brute force over every point and plane
+    std::vector<std::pair<long, long>> expected;
+    for (long vi = 0; vi < points.rows(); vi++) {
+        for (long pi = 0; pi < plane_origins.rows(); pi++) {
+            const double distance_sqr = point_plane_distance(
+                points.row(vi), plane_origins.row(pi), plane_normals.row(pi));
+            if (distance_sqr < (dmin + dhat) * (dmin + dhat)) {
+                expected.emplace_back(vi, pi);
+            }
+        }
+    }
+
+    REQUIRE(pv_collisions.size() == expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        const auto& [vi, pi] = expected[i];
+        CHECK(pv_collisions[i].vertex_id == vi);
+        CHECK(
+            pv_collisions[i].plane_origin
+            == plane_origins.row(pi).transpose());
+        CHECK(
+            pv_collisions[i].plane_normal
+            == plane_normals.row(pi).transpose());
+        CHECK(pv_collisions[i].dmin == dmin);
+    }
+}
+
+TEST_CASE("Point-plane CCD", "[implicit][plane][ccd]")
+{
+    const double step = GENERATE(1e-3, 1e-2, 1e-1, 1);
+
+    srand(0);
+    Eigen::MatrixXd plane_origins, plane_normals;
+    random_planes(8, plane_origins, plane_normals);
+    const Eigen::MatrixXd points_t0 = Eigen::MatrixXd::Random(5000, 3);
+    const Eigen::MatrixXd points_t1 =
+        points_t0 + step * Eigen::MatrixXd::Random(points_t0.rows(), 3);
+
+    // Brute force over every point and plane
+    double expected_toi = 1;
+    bool expected_collision_free = true;
+    for (long vi = 0; vi < points_t0.rows(); vi++) {
+        for (long pi = 0; pi < plane_origins.rows(); pi++) {
+            double toi;
+            if (point_static_plane_ccd(
+                    points_t0.row(vi), points_t1.row(vi),
+                    plane_origins.row(pi), plane_normals.row(pi), toi)) {
+                expected_toi = std::min(expected_toi, toi);
+                expected_collision_free = false;
+            }
+        }
+    }
+
+    CHECK(
+        compute_point_plane_collision_free_stepsize(
+            points_t0, points_t1, plane_origins, plane_normals)
+        == expected_toi);
+
+    CHECK(
+        is_step_point_plane_collision_free(
+            points_t0, points_t1, plane_origins, plane_normals)
+        == expected_collision_free);
+}
@@ -0,0 +1,78 @@
+#include <tests/utils.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <ipc/potentials/barrier_potential.hpp>
+#include <ipc/utils/logger.hpp>
+
+#include <igl/edges.h>
+
+using namespace ipc;
+
+namespace {
+/// Append an n×n grid of unit spacing at height z to the mesh.
+void append_grid(
+    const int n,
+    const double z,
+    std::vector<Eigen::Vector3d>& vertices,
+    std::vector<Eigen::Vector3i>& faces)
+{
+    const int offset = vertices.size();
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            vertices.emplace_back(i, j, z);
+        }
+    }
+    for (int i = 0; i + 1 < n; i++) {
+        for (int j = 0; j + 1 < n; j++) {
+            const int v = offset + i * n + j;
+            faces.emplace_back(v, v + n, v + 1);
+            faces.emplace_back(v + 1, v + n, v + n + 1);
+        }
+    }
+}
+} // namespace
+
+TEST_CASE(
+    "Benchmark barrier gradient with few contacts",
+    "[!benchmark][potential][barrier_potential][gradient]")
+{
+    // A fixed 10×10 patch hovers over a corner of a growing ground grid, so
+    // the number of contacts stays constant while the mesh grows.
+    const double dhat = 0.1;
+    const BarrierPotential barrier_potential(dhat);
+
+    for (const int n : { 100, 200, 400 }) {
+        std::vector<Eigen::Vector3d> V;
+        std::vector<Eigen::Vector3i> F;
+        append_grid(n, 0, V, F);
+        append_grid(10, dhat / 2, V, F);
+
+        Eigen::MatrixXd vertices(V.size(), 3);
+        for (size_t i = 0; i < V.size(); i++) {
+            vertices.row(i) = V[i];
+        }
+        Eigen::MatrixXi faces(F.size(), 3);
+        for (size_t i = 0; i < F.size(); i++) {
+            faces.row(i) = F[i];
+        }
+        Eigen::MatrixXi edges;
+        igl::edges(faces, edges);
+
+        const CollisionMesh mesh(vertices, edges, faces);
+
+        Collisions collisions;
+        collisions.build(mesh, vertices, dhat);
+        REQUIRE(collisions.size() > 0);
+
+        logger().info(
+            "vertices={:d} collisions={:d}", vertices.rows(),
+            collisions.size());
+
+        BENCHMARK(fmt::format("Gradient ({:d} vertices)", vertices.rows()))
+        {
+            return barrier_potential.gradient(collisions, mesh, vertices);
+        };
+    }
+}
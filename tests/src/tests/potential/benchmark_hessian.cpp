@@ -0,0 +1,93 @@
+#include <tests/utils.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <ipc/potentials/barrier_potential.hpp>
+#include <ipc/utils/logger.hpp>
+
+#include <tbb/global_control.h>
+#include <tbb/info.h>
+
+using namespace ipc;
+
+TEST_CASE(
+    "Benchmark barrier hessian assembly",
+    "[!benchmark][potential][barrier_potential][hessian]")
+{
+    Eigen::MatrixXd vertices;
+    Eigen::MatrixXi edges, faces;
+    REQUIRE(tests::load_mesh("bunny.obj", vertices, edges, faces));
+
+    const CollisionMesh mesh(vertices, edges, faces);
+
+    const double dhat = 1e-2;
+    Collisions collisions;
+    collisions.build(mesh, vertices, dhat);
+    REQUIRE(collisions.size() > 0);
+
+    const BarrierPotential barrier_potential(dhat);
+
+    const int max_threads = tbb::info::default_concurrency();
+    for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        tbb::global_control thread_limiter(
+            tbb::global_control::max_allowed_parallelism, num_threads);
+
+        const Eigen::SparseMatrix<double> hess =
+            barrier_potential.hessian(collisions, mesh, vertices);
+        logger().info(
+            "threads={:d} collisions={:d} nnz={:d}", num_threads,
+            collisions.size(), hess.nonZeros());
+
+        BENCHMARK(fmt::format("Hessian assembly ({:d} threads)", num_threads))
+        {
+            return barrier_potential.hessian(collisions, mesh, vertices);
+        };
+    }
+}
+
+TEST_CASE(
+    "Benchmark barrier compact collisions",
+    "[!benchmark][potential][barrier_potential][compact]")
+{
+    Eigen::MatrixXd vertices;
+    Eigen::MatrixXi edges, faces;
+    REQUIRE(tests::load_mesh("bunny.obj", vertices, edges, faces));
+
+    const CollisionMesh mesh(vertices, edges, faces);
+
+    const double dhat = 1e-2;
+    Collisions collisions;
+    collisions.build(mesh, vertices, dhat);
+    REQUIRE(collisions.size() > 0);
+
+    const CompactCollisions compact(collisions, mesh);
+
+    const BarrierPotential barrier_potential(dhat);
+
+    BENCHMARK("Potential")
+    {
+        return barrier_potential(collisions, mesh, vertices);
+    };
+    BENCHMARK("Potential (compact)")
+    {
+        return barrier_potential(compact, vertices);
+    };
+    BENCHMARK("Gradient")
+    {
+        return barrier_potential.gradient(collisions, mesh, vertices);
+    };
+    BENCHMARK("Gradient (compact)")
+    {
+        return barrier_potential.gradient(compact, vertices);
+    };
+    BENCHMARK("Hessian")
+    {
+        return barrier_potential.hessian(collisions, mesh, vertices);
+    };
+    BENCHMARK("Hessian (compact)")
+    {
+        return barrier_potential.hessian(compact, vertices);
+    };
+}
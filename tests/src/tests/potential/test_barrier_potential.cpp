@@ -113,6 +113,47 @@ TEST_CASE(
     CHECK(fd::compare_hessian(hess_b, fhess_b, 1e-3));
 }
 
+TEST_CASE(
+    "Barrier potential PSD projection methods",
+    "[potential][barrier_potential][hessian][project_to_psd]")
+{
+    const bool use_convergent_formulation = GENERATE(true, false);
+    const std::string mesh_name = GENERATE("two-cubes-close.obj", "bunny.obj");
+    const double dhat = mesh_name == "bunny.obj" ? 1e-2 : 1e-1;
+
+    Eigen::MatrixXd vertices;
+    Eigen::MatrixXi edges, faces;
+    REQUIRE(tests::load_mesh(mesh_name, vertices, edges, faces));
+    CAPTURE(mesh_name, use_convergent_formulation);
+
+    const CollisionMesh mesh =
+        CollisionMesh::build_from_full_mesh(vertices, edges, faces);
+    vertices = mesh.vertices(vertices);
+
+    Collisions collisions;
+    collisions.set_use_convergent_formulation(use_convergent_formulation);
+    collisions.build(mesh, vertices, dhat);
+    REQUIRE(collisions.size() > 0);
+
+    BarrierPotential barrier_potential(dhat);
+
+    for (size_t i = 0; i < collisions.size(); i++) {
+        const VectorMax12d x =
+            collisions[i].dof(vertices, mesh.edges(), mesh.faces());
+
+        barrier_potential.set_psd_projection_method(PSDProjectionMethod::FULL);
+        const MatrixMax12d full = barrier_potential.hessian(
+            collisions[i], x, /*project_hessian_to_psd=*/true);
+
+        barrier_potential.set_psd_projection_method(
+            PSDProjectionMethod::REDUCED);
+        const MatrixMax12d reduced = barrier_potential.hessian(
+            collisions[i], x, /*project_hessian_to_psd=*/true);
+
+        CHECK((full - reduced).norm() <= 1e-10 * std::max(full.norm(), 1.0));
+    }
+}
+
 TEST_CASE(
     "Barrier potential convergent formulation",
     "[potential][barrier_potential][convergent]")
@@ -454,6 +495,68 @@ TEST_CASE(
     }
 }
 
+TEST_CASE(
+    "Barrier potential shape derivative assembly",
+    "[potential][barrier_potential][shape_derivative]")
+{
+    nlohmann::json data;
+    {
+        std::ifstream input(tests::DATA_DIR / "shape_derivative_data.json");
+        REQUIRE(input.good());
+
+        data = nlohmann::json::parse(input, nullptr, false);
+        REQUIRE(!data.is_discarded());
+    }
+
+    // Parameters
+    double dhat = data["dhat"];
+
+    // Mesh
+    const Eigen::MatrixXi edges = data["boundary_edges"];
+    Eigen::MatrixXd X = data["boundary_nodes_pos"];
+    Eigen::MatrixXd vertices = data["displaced"];
+
+    CollisionMesh mesh = CollisionMesh::build_from_full_mesh(
+        X, edges, /*faces=*/Eigen::MatrixXi());
+    mesh.init_area_jacobians();
+
+    X = mesh.vertices(X);
+    vertices = mesh.vertices(vertices);
+    const int ndof = vertices.size();
+
+    Collisions collisions;
+    const bool use_convergent_formulation = GENERATE(true, false);
+    collisions.set_use_convergent_formulation(use_convergent_formulation);
+    collisions.set_are_shape_derivatives_enabled(true);
+    collisions.build(mesh, vertices, dhat);
+    REQUIRE(collisions.size() > 1);
+
+    BarrierPotential barrier_potential(dhat);
+
+    const Eigen::SparseMatrix<double> JF_wrt_X =
+        barrier_potential.shape_derivative(collisions, mesh, vertices);
+    CHECK(JF_wrt_X.isCompressed());
+
+    // Reference: sum the per-collision triplets.
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (size_t i = 0; i < collisions.size(); i++) {
+        barrier_potential.shape_derivative(
+            collisions[i], collisions[i].vertex_ids(mesh.edges(), mesh.faces()),
+            collisions[i].dof(X, mesh.edges(), mesh.faces()),
+            collisions[i].dof(vertices, mesh.edges(), mesh.faces()), triplets);
+    }
+    Eigen::SparseMatrix<double> expected(ndof, ndof);
+    expected.setFromTriplets(triplets.begin(), triplets.end());
+
+    CHECK(JF_wrt_X.nonZeros() == expected.nonZeros());
+    for (int j = 0; j < ndof; j++) {
+        CHECK(
+            JF_wrt_X.outerIndexPtr()[j + 1] - JF_wrt_X.outerIndexPtr()[j]
+            == expected.outerIndexPtr()[j + 1] - expected.outerIndexPtr()[j]);
+    }
+    CHECK(JF_wrt_X.isApprox(expected, 1e-12));
+}
+
 // -- Benchmarking ------------------------------------------------------------
 
 TEST_CASE(
@@ -511,6 +614,144 @@ TEST_CASE(
     };
 }
 
+TEST_CASE(
+    "Barrier potential hessian with cached sparsity pattern",
+    "[potential][barrier_potential][hessian]")
+{
+    const bool project_hessian_to_psd = GENERATE(false, true);
+
+    Eigen::MatrixXd vertices;
+    Eigen::MatrixXi edges, faces;
+    REQUIRE(tests::load_mesh("two-cubes-close.obj", vertices, edges, faces));
+
+    const CollisionMesh mesh =
+        CollisionMesh::build_from_full_mesh(vertices, edges, faces);
+    vertices = mesh.vertices(vertices);
+
+    double dhat = 1e-1;
+    Collisions collisions;
+    collisions.build(mesh, vertices, dhat);
+    REQUIRE(collisions.size() > 0);
+
+    BarrierPotential barrier_potential(dhat);
+
+    SparsityPattern pattern;
+    Eigen::SparseMatrix<double> hess;
+
+    barrier_potential.hessian(
+        collisions, mesh, vertices, pattern, hess, project_hessian_to_psd);
+    CHECK(
+        (hess
+         - barrier_potential.hessian(
+             collisions, mesh, vertices, project_hessian_to_psd))
+            .norm()
+        <= 1e-10 * std::max(1.0, hess.norm()));
+    CHECK(pattern.has_pattern(hess));
+
+    // Same collisions: only the values are overwritten.
+    const double* values = hess.valuePtr();
+    const int* inner = hess.innerIndexPtr();
+    vertices *= 1.0001;
+    barrier_potential.hessian(
+        collisions, mesh, vertices, pattern, hess, project_hessian_to_psd);
+    CHECK(hess.valuePtr() == values);
+    CHECK(hess.innerIndexPtr() == inner);
+    CHECK(
+        (hess
+         - barrier_potential.hessian(
+             collisions, mesh, vertices, project_hessian_to_psd))
+            .norm()
+        <= 1e-10 * std::max(1.0, hess.norm()));
+
+    // Different collisions: the pattern is rebuilt.
+    const size_t prev_num_nonzeros = pattern.num_nonzeros();
+    dhat = 0.2;
+    barrier_potential.set_dhat(dhat);
+    collisions.build(mesh, vertices, dhat);
+    barrier_potential.hessian(
+        collisions, mesh, vertices, pattern, hess, project_hessian_to_psd);
+    CHECK(pattern.num_nonzeros() != prev_num_nonzeros);
+    CHECK(pattern.has_pattern(hess));
+    CHECK(
+        (hess
+         - barrier_potential.hessian(
+             collisions, mesh, vertices, project_hessian_to_psd))
+            .norm()
+        <= 1e-10 * std::max(1.0, hess.norm()));
+}
+
+TEST_CASE(
+    "Barrier potential with compact collisions",
+    "[potential][barrier_potential][compact]")
+{
+    const bool use_convergent_formulation = GENERATE(true, false);
+    const bool project_hessian_to_psd = GENERATE(false, true);
+
+    Eigen::MatrixXd vertices;
+    Eigen::MatrixXi edges, faces;
+    double dhat;
+
+    SECTION("3D")
+    {
+        REQUIRE(
+            tests::load_mesh("two-cubes-close.obj", vertices, edges, faces));
+        dhat = 0.2;
+    }
+    SECTION("2D")
+    {
+        // An edge with a short edge above it (edge-vertex) and one beside it
+        // (vertex-vertex).
+        vertices.resize(6, 2);
+        vertices << 0, 0, 1, 0, 0.4, 0.05, 0.6, 0.05, 1.05, 0.02, 1.3, 0.02;
+        edges.resize(3, 2);
+        edges << 0, 1, 2, 3, 4, 5;
+        dhat = 0.1;
+    }
+
+    const CollisionMesh mesh =
+        CollisionMesh::build_from_full_mesh(vertices, edges, faces);
+    vertices = mesh.vertices(vertices);
+    const int dim = vertices.cols();
+
+    Collisions collisions;
+    collisions.set_use_convergent_formulation(use_convergent_formulation);
+    collisions.build(mesh, vertices, dhat);
+    VectorMax3d plane_normal = VectorMax3d::Zero(dim);
+    plane_normal[1] = 1;
+    collisions.pv_collisions.emplace_back(
+        vertices.row(0).transpose() - 0.05 * plane_normal, plane_normal, 0);
+    if (dim == 2) {
+        REQUIRE(collisions.vv_collisions.size() > 0);
+        REQUIRE(collisions.ev_collisions.size() > 0);
+    } else {
+        REQUIRE(collisions.ee_collisions.size() > 0);
+        REQUIRE(collisions.fv_collisions.size() > 0);
+    }
+
+    const CompactCollisions compact(collisions, mesh);
+
+    const BarrierPotential barrier_potential(dhat);
+
+    CAPTURE(dim);
+    CHECK(
+        barrier_potential(compact, vertices)
+        == Catch::Approx(barrier_potential(collisions, mesh, vertices)));
+
+    const Eigen::VectorXd grad =
+        barrier_potential.gradient(collisions, mesh, vertices);
+    CHECK(
+        (barrier_potential.gradient(compact, vertices) - grad).norm()
+        <= 1e-12 * std::max(1.0, grad.norm()));
+
+    const Eigen::SparseMatrix<double> hess = barrier_potential.hessian(
+        collisions, mesh, vertices, project_hessian_to_psd);
+    CHECK(
+        (barrier_potential.hessian(compact, vertices, project_hessian_to_psd)
+         - hess)
+            .norm()
+        <= 1e-12 * std::max(1.0, hess.norm()));
+}
+
 TEST_CASE(
     "Benchmark barrier potential shape derivative",
     "[!benchmark][potential][barrier_potential][shape_derivative]")
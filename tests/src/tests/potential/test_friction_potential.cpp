@@ -8,6 +8,7 @@
 #include <ipc/potentials/friction_potential.hpp>
 
 #include <finitediff.hpp>
+#include <igl/edges.h>
 
 using namespace ipc;
 
@@ -42,4 +43,71 @@ TEST_CASE("Friction gradient and hessian", "[friction][gradient][hessian]")
     Eigen::MatrixXd fhess;
     fd::finite_hessian(fd::flatten(V1), f, fhess);
     CHECK(fd::compare_hessian(hess, fhess, 1e-3));
-}
\ No newline at end of file
+}
+TEST_CASE(
+    "Friction PSD projection methods",
+    "[friction][hessian][project_to_psd]")
+{
+    const double epsv = 1e-3;
+    const double dhat = 1e-1;
+
+    // Point above a triangle.
+    Eigen::MatrixXd V(4, 3);
+    V.row(0) << 0, 0.5 * dhat, 0;
+    V.row(1) << -1, 0, 1;
+    V.row(2) << 2, 0, 0;
+    V.row(3) << -1, 0, -1;
+    Eigen::MatrixXi E, F(1, 3);
+    F << 1, 2, 3;
+    igl::edges(F, E);
+
+    const CollisionMesh mesh(V, E, F);
+
+    Collisions collisions;
+    collisions.fv_collisions.emplace_back(0, 0);
+
+    FrictionCollisions friction_collisions;
+    friction_collisions.build(
+        mesh, V, collisions, dhat, /*barrier_stiffness=*/100, /*mu=*/0.5);
+    REQUIRE(friction_collisions.size() == 1);
+    FrictionCollision& collision = friction_collisions[0];
+
+    // A negative weight makes the hessian negative semi-definite.
+    collision.weight = GENERATE(1.0, -1.0);
+    // ‖u‖ / ϵᵥ: only 0 < ‖u‖ < ϵᵥ projects the inner 2×2 matrix.
+    const double t = GENERATE(0.1, 0.5, 0.9);
+
+    FrictionPotential D(epsv);
+
+    for (int i = 0; i < 10; i++) {
+        VectorMax12d v = VectorMax12d::Random(collision.ndof());
+        const VectorMax2d u = collision.tangent_basis.transpose()
+            * collision.relative_velocity(v);
+        REQUIRE(u.norm() > 0);
+        v *= t * epsv / u.norm();
+
+        D.set_psd_projection_method(PSDProjectionMethod::FULL);
+        const MatrixMax12d full =
+            D.hessian(collision, v, /*project_hessian_to_psd=*/true);
+
+        D.set_psd_projection_method(PSDProjectionMethod::REDUCED);
+        const MatrixMax12d reduced =
+            D.hessian(collision, v, /*project_hessian_to_psd=*/true);
+
+        const double scale = std::max(full.norm(), 1.0);
+        CHECK((full - reduced).norm() <= 1e-10 * scale);
+
+        const Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigensolver(
+            Eigen::MatrixXd(reduced + reduced.transpose()) / 2);
+        CHECK(eigensolver.eigenvalues().minCoeff() >= -1e-10 * scale);
+
+        const MatrixMax12d hess =
+            D.hessian(collision, v, /*project_hessian_to_psd=*/false);
+        if (collision.weight > 0) {
+            // Already PSD, so the projection leaves it unchanged.
+            CHECK((reduced - hess).norm() <= 1e-10 * scale);
+        } else {
+            CHECK(reduced.norm() <= 1e-10 * std::max(hess.norm(), 1.0));
+        }
+    }
+}
@@ -4,8 +4,13 @@
 #include <catch2/generators/catch_generators_adapters.hpp>
 
 #include <ipc/ipc.hpp>
+#include <ipc/broad_phase/hash_grid.hpp>
+#include <ipc/utils/intersection.hpp>
 
 #include <igl/edges.h>
+#include <igl/predicates/segment_segment_intersect.h>
+
+#include <algorithm>
 
 using namespace ipc;
 
@@ -101,3 +106,137 @@ TEST_CASE("Has intersections", "[intersection]")
     CAPTURE(broad_phase_method);
     CHECK(has_intersections(CollisionMesh(V, E, F), V, broad_phase_method));
 }
+
+TEST_CASE("Intersecting pairs", "[intersection]")
+{
+    std::string mesh1_name = GENERATE("cube.obj", "bunny.obj");
+    std::string mesh2_name = GENERATE("cube.obj", "bunny.obj");
+    int dim = GENERATE(2, 3);
+
+    const Eigen::Matrix3d R1 =
+        GENERATE(take(2, tests::RotationGenerator::create()));
+    const Eigen::Matrix3d R2 =
+        GENERATE(take(2, tests::RotationGenerator::create()));
+
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = combine_meshes(mesh1_name, mesh2_name, R1, R2, dim, V, E, F);
+    REQUIRE(success);
+
+    const CollisionMesh mesh(V, E, F);
+    const std::shared_ptr<BroadPhase> broad_phase =
+        BroadPhase::make_broad_phase(DEFAULT_BROAD_PHASE_METHOD);
+    const Eigen::MatrixXi pairs =
+        compute_intersecting_pairs(mesh, V, broad_phase);
+
+    CAPTURE(mesh1_name, mesh2_name, dim);
+    REQUIRE(pairs.rows() > 0);
+    CHECK(has_intersections(mesh, V));
+
+    // Brute-force the same candidates serially.
+    std::vector<std::pair<long, long>> expected_pairs;
+    if (dim == 2) {
+        std::vector<EdgeEdgeCandidate> candidates;
+        broad_phase->detect_edge_edge_candidates(candidates);
+        for (const auto& [ea, eb] : candidates) {
+            if (igl::predicates::segment_segment_intersect(
+                    V.row(E(ea, 0)).head<2>(), V.row(E(ea, 1)).head<2>(),
+                    V.row(E(eb, 0)).head<2>(), V.row(E(eb, 1)).head<2>())) {
+                expected_pairs.emplace_back(ea, eb);
+            }
+        }
+    } else {
+        std::vector<EdgeFaceCandidate> candidates;
+        broad_phase->detect_edge_face_candidates(candidates);
+        for (const auto& [e, f] : candidates) {
+            if (is_edge_intersecting_triangle(
+                    V.row(E(e, 0)), V.row(E(e, 1)), V.row(F(f, 0)),
+                    V.row(F(f, 1)), V.row(F(f, 2)))) {
+                expected_pairs.emplace_back(e, f);
+            }
+        }
+    }
+    std::sort(expected_pairs.begin(), expected_pairs.end());
+
+    REQUIRE(size_t(pairs.rows()) == expected_pairs.size());
+    for (int i = 0; i < pairs.rows(); i++) {
+        CHECK(pairs(i, 0) == expected_pairs[i].first);
+        CHECK(pairs(i, 1) == expected_pairs[i].second);
+    }
+
+    for (int i = 0; i < pairs.rows(); i++) {
+        if (i > 0) {
+            CHECK(
+                std::make_pair(pairs(i - 1, 0), pairs(i - 1, 1))
+                < std::make_pair(pairs(i, 0), pairs(i, 1)));
+        }
+        if (dim == 2) {
+            CHECK(igl::predicates::segment_segment_intersect(
+                V.row(E(pairs(i, 0), 0)).head<2>(),
+                V.row(E(pairs(i, 0), 1)).head<2>(),
+                V.row(E(pairs(i, 1), 0)).head<2>(),
+                V.row(E(pairs(i, 1), 1)).head<2>()));
+        } else {
+            CHECK(is_edge_intersecting_triangle(
+                V.row(E(pairs(i, 0), 0)), V.row(E(pairs(i, 0), 1)),
+                V.row(F(pairs(i, 1), 0)), V.row(F(pairs(i, 1), 1)),
+                V.row(F(pairs(i, 1), 2))));
+        }
+    }
+}
+
+TEST_CASE("No intersections", "[intersection]")
+{
+    const std::string mesh_name = GENERATE("cube.obj", "bunny.obj");
+
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh(mesh_name, V, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V, E, F);
+
+    CHECK(!has_intersections(mesh, V));
+    CHECK(compute_intersecting_pairs(mesh, V).rows() == 0);
+}
+
+namespace {
+class CountingHashGrid : public HashGrid {
+public:
+    using HashGrid::build;
+
+    void build(
+        ConstRef<Eigen::MatrixXd> vertices,
+        const Eigen::MatrixXi& edges,
+        const Eigen::MatrixXi& faces,
+        double inflation_radius = 0) override
+    {
+        num_builds++;
+        HashGrid::build(vertices, edges, faces, inflation_radius);
+    }
+
+    int num_builds = 0;
+};
+} // namespace
+
+TEST_CASE("Reuse broad phase across intersection checks", "[intersection]")
+{
+    const std::string mesh_name = GENERATE("cube.obj", "bunny.obj");
+
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(tests::load_mesh(mesh_name, V, E, F));
+
+    const CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V, E, F);
+    const auto broad_phase = std::make_shared<CountingHashGrid>();
+
+    CHECK(!has_intersections(mesh, V, broad_phase));
+    CHECK(broad_phase->num_builds == 1);
+
+    // Shrinking the mesh slightly changes its bounding box diagonal, but the
+    // broad phase must still be updated in place rather than rebuilt.
+    const Eigen::RowVectorXd centroid = V.colwise().mean();
+    const Eigen::MatrixXd V1 =
+        ((V.rowwise() - centroid) * (1 - 1e-4)).rowwise() + centroid;
+    CHECK(!has_intersections(mesh, V1, broad_phase));
+    CHECK(broad_phase->num_builds == 1);
+}
@@ -25,6 +25,62 @@ bool load_mesh(
     return success && V.size() && F.size() && E.size();
 }
 
+void cloth_grid(
+    const int n, Eigen::MatrixXd& V, Eigen::MatrixXi& E, Eigen::MatrixXi& F)
+{
+    assert(n >= 2);
+    V.resize(n * n, 3);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            V.row(i * n + j) << i / double(n - 1), 0, j / double(n - 1);
+        }
+    }
+
+    F.resize(2 * (n - 1) * (n - 1), 3);
+    for (int i = 0; i < n - 1; i++) {
+        for (int j = 0; j < n - 1; j++) {
+            const int v = i * n + j, f = 2 * (i * (n - 1) + j);
+            F.row(f) << v, v + 1, v + n;
+            F.row(f + 1) << v + 1, v + n + 1, v + n;
+        }
+    }
+
+    igl::edges(F, E);
+}
+
+bool load_squished_bunny(
+    Eigen::MatrixXd& V0,
+    Eigen::MatrixXd& V1,
+    Eigen::MatrixXi& E,
+    Eigen::MatrixXi& F,
+    const double x_scale)
+{
+    if (!load_mesh("bunny.obj", V0, E, F)) {
+        return false;
+    }
+    const Eigen::RowVector3d center =
+        (V0.colwise().maxCoeff() + V0.colwise().minCoeff()) / 2;
+    V0.rowwise() -= center;
+    V1 = V0;
+    V1.col(0) *= x_scale;
+    return true;
+}
+
+bool candidate_ccd(
+    const ContinuousCollisionCandidate& candidate,
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& V0,
+    const Eigen::MatrixXd& V1,
+    double& toi,
+    const double min_distance,
+    const double tmax)
+{
+    return candidate.ccd(
+        candidate.dof(V0, mesh.edges(), mesh.faces()),
+        candidate.dof(V1, mesh.edges(), mesh.faces()), toi, min_distance,
+        tmax);
+}
+
 void mmcvids_to_collisions(
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
@@ -2,6 +2,7 @@
 
 #include <catch2/generators/catch_generators_range.hpp>
 
+#include <ipc/candidates/continuous_collision_candidate.hpp>
 #include <ipc/collisions/collisions.hpp>
 #include <ipc/broad_phase/broad_phase.hpp>
 #include <ipc/utils/eigen_ext.hpp>
@@ -30,6 +31,46 @@ bool load_mesh(
     Eigen::MatrixXi& E,
     Eigen::MatrixXi& F);
 
+/// @brief Build a flat n×n grid over the unit square in the xz-plane.
+/// @param[in] n Number of vertices along each side.
+/// @param[out] V Vertex positions.
+/// @param[out] E Edges of the triangulated grid.
+/// @param[out] F Two triangles per grid cell.
+void cloth_grid(
+    const int n, Eigen::MatrixXd& V, Eigen::MatrixXi& E, Eigen::MatrixXi& F);
+
+/// @brief Load the bunny centered at the origin and squish it along x.
+/// @param[out] V0 Starting vertex positions centered at the origin.
+/// @param[out] V1 Ending vertex positions: V0 with x scaled by x_scale.
+/// @param[out] E Edges of the bunny.
+/// @param[out] F Faces of the bunny.
+/// @param[in] x_scale Scale of x at the end of the step. A negative scale squishes the bunny into itself, generating many colliding candidates.
+/// @return True if the bunny was loaded.
+bool load_squished_bunny(
+    Eigen::MatrixXd& V0,
+    Eigen::MatrixXd& V1,
+    Eigen::MatrixXi& E,
+    Eigen::MatrixXi& F,
+    const double x_scale = -0.1);
+
+/// @brief Reference narrow phase of a single candidate through the virtual ccd().
+/// @param[in] candidate Candidate to check.
+/// @param[in] mesh Collision mesh.
+/// @param[in] V0 Starting vertex positions of the collision mesh.
+/// @param[in] V1 Ending vertex positions of the collision mesh.
+/// @param[out] toi Time of impact if the candidate collides.
+/// @param[in] min_distance Minimum separation distance.
+/// @param[in] tmax Maximum time of impact to consider.
+/// @return True if the candidate collides before tmax.
+bool candidate_ccd(
+    const ContinuousCollisionCandidate& candidate,
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& V0,
+    const Eigen::MatrixXd& V1,
+    double& toi,
+    const double min_distance = 0.0,
+    const double tmax = 1.0);
+
 // ============================================================================
 
 void mmcvids_to_collisions(
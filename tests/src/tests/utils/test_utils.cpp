@@ -1,4 +1,5 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
 
 #include <ipc/candidates/vertex_vertex.hpp>
 #include <ipc/candidates/edge_vertex.hpp>
@@ -7,9 +8,11 @@
 #include <ipc/candidates/edge_face.hpp>
 #include <ipc/utils/logger.hpp>
 #include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/merge_thread_local.hpp>
 #include <ipc/utils/save_obj.hpp>
 
 #include <spdlog/sinks/stdout_color_sinks.h>
+#include <tbb/parallel_for.h>
 
 #include <sstream>
 
@@ -62,6 +65,52 @@ TEST_CASE("Project to PD", "[utils][project_to_pd]")
     CHECK(A_pd.isApprox(A));
 }
 
+TEST_CASE("Project to PSD in closed form", "[utils][project_to_psd]")
+{
+    const int n = GENERATE(1, 2);
+    // Scale of the non-identity part (small values give close eigenvalues)
+    const double scale = GENERATE(1.0, 1e-8);
+    CAPTURE(n, scale);
+
+    for (int i = 0; i < 100; i++) {
+        Eigen::MatrixXd A = scale * Eigen::MatrixXd::Random(n, n);
+        A = (A + A.transpose()).eval();
+        A.diagonal().array() += Eigen::VectorXd::Random(1)[0];
+
+        const Eigen::MatrixXd A_psd = ipc::project_to_psd_direct(A);
+        const Eigen::MatrixXd expected = ipc::project_to_psd(A);
+        CHECK((A_psd - expected).norm() <= 1e-12 * A.norm());
+    }
+}
+
+TEST_CASE(
+    "Project translation-invariant matrix to PSD", "[utils][project_to_psd]")
+{
+    const int dim = GENERATE(2, 3);
+    const int num_vertices = GENERATE(2, 3, 4);
+    const int n = dim * num_vertices;
+    CAPTURE(dim, num_vertices);
+
+    // Projector onto the complement of rigid translations
+    Eigen::MatrixXd P = Eigen::MatrixXd::Identity(n, n);
+    for (int i = 0; i < num_vertices; i++) {
+        for (int j = 0; j < num_vertices; j++) {
+            P.block(i * dim, j * dim, dim, dim).diagonal().array() -=
+                1.0 / num_vertices;
+        }
+    }
+
+    for (int i = 0; i < 100; i++) {
+        Eigen::MatrixXd A = Eigen::MatrixXd::Random(n, n);
+        A = P * (A + A.transpose()) * P;
+
+        const Eigen::MatrixXd A_psd =
+            ipc::project_translation_invariant_to_psd(A, dim);
+        const Eigen::MatrixXd expected = ipc::project_to_psd(A);
+        CHECK((A_psd - expected).norm() <= 1e-12 * A.norm());
+    }
+}
+
 TEST_CASE("Save OBJ of candidates", "[utils][save_obj]")
 {
     Eigen::MatrixXd V(4, 3);
@@ -114,4 +163,84 @@ TEST_CASE("Save OBJ of candidates", "[utils][save_obj]")
             ss.str()
             == "o EF\nv 1 0 0\nv 0 1 0\nv 1 0 0\nv 0 1 0\nv 0 0 1\nl 1 2\nf 3 4 5\n");
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Merge thread local triplets", "[utils][merge_thread_local]")
+{
+    const int rows = 50, cols = 80;
+    const int num_triplets = GENERATE(0, 1, 1000, 100000);
+
+    // Leave the last columns empty to exercise the trailing outer indices.
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int i = 0; i < num_triplets; i++) {
+        triplets.emplace_back(
+            (7 * i) % rows, (13 * i) % (cols / 2), (i % 17) - 8.0);
+    }
+
+    tbb::enumerable_thread_specific<std::vector<Eigen::Triplet<double>>>
+        storage;
+    tbb::parallel_for(0, num_triplets, [&](int i) {
+        storage.local().push_back(triplets[i]);
+    });
+
+    const Eigen::SparseMatrix<double> A =
+        ipc::merge_thread_local_triplets(storage, rows, cols);
+
+    Eigen::SparseMatrix<double> expected_A(rows, cols);
+    expected_A.setFromTriplets(triplets.begin(), triplets.end());
+
+    CHECK(A.isCompressed());
+    CHECK(A.nonZeros() == expected_A.nonZeros());
+    CHECK((Eigen::MatrixXd(A) - Eigen::MatrixXd(expected_A)).norm() == 0);
+}
+
+TEST_CASE("Merge thread local vectors", "[utils][merge_thread_local]")
+{
+    const int num_items = GENERATE(0, 1, 1000, 100000);
+
+    tbb::enumerable_thread_specific<std::vector<ipc::EdgeEdgeCandidate>>
+        storage;
+    tbb::parallel_for(0, num_items, [&](int i) {
+        storage.local().emplace_back(i % 97, i % 89);
+    });
+
+    // Existing items are kept in front of the merged ones.
+    std::vector<ipc::EdgeEdgeCandidate> merged = { { 0, 0 }, { 1, 1 } };
+    ipc::merge_thread_local_vectors(storage, merged);
+
+    REQUIRE(merged.size() == num_items + 2);
+    CHECK(merged[0] == ipc::EdgeEdgeCandidate(0, 0));
+    CHECK(merged[1] == ipc::EdgeEdgeCandidate(1, 1));
+
+    std::vector<ipc::EdgeEdgeCandidate> expected(merged.begin(), merged.end());
+    std::sort(expected.begin(), expected.end());
+    expected.erase(
+        std::unique(expected.begin(), expected.end()), expected.end());
+
+    std::vector<ipc::EdgeEdgeCandidate> unique = { { 0, 0 }, { 1, 1 } };
+    ipc::merge_thread_local_vectors_unique(storage, unique);
+
+    CHECK(unique == expected);
+}
+
+TEST_CASE("Merge thread local gradients", "[utils][merge_thread_local]")
+{
+    const int size = GENERATE(1, 1000, 5000);
+    const int num_entries = GENERATE(0, 1, 1000, 100000);
+
+    tbb::enumerable_thread_specific<std::vector<std::pair<long, double>>>
+        storage;
+    tbb::parallel_for(0, num_entries, [&](int i) {
+        storage.local().emplace_back((7l * i) % size, (i % 17) - 8.0);
+    });
+
+    Eigen::VectorXd expected_grad = Eigen::VectorXd::Zero(size);
+    for (int i = 0; i < num_entries; i++) {
+        expected_grad[(7l * i) % size] += (i % 17) - 8.0;
+    }
+
+    const Eigen::VectorXd grad =
+        ipc::merge_thread_local_gradients(storage, size);
+
+    CHECK(grad == expected_grad);
+}